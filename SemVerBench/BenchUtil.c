@@ -0,0 +1,117 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+ #define WIN32_LEAN_AND_MEAN
+ #include <windows.h>
+#else
+ #include <time.h>
+#endif
+
+#include "SemVerBench.h"
+
+// No generated version is longer than this, null included.
+#define BENCH_VERSION_LENGTH 48
+
+static const char *_prereleaseTags[] = { "alpha", "beta", "rc", "preview", "dev", "snapshot" };
+static const char *_metaTags[] = { "build", "sha", "ci", "linux", "win64" };
+
+#define TAG_COUNT(tags) (sizeof(tags) / sizeof(tags[0]))
+
+uint32_t NextBenchRandom(uint32_t *pSeed)
+{
+	*pSeed = (*pSeed * 1664525) + 1013904223;
+	return *pSeed >> 8;
+}
+
+bool MakeBenchVersions(BenchVersions *pVersions, size_t count)
+{
+	pVersions->count = count;
+	pVersions->ppVersions = malloc(count * sizeof(char*));
+	pVersions->pLengths = malloc(count * sizeof(size_t));
+	pVersions->pText = malloc(count * BENCH_VERSION_LENGTH);
+
+	if ((NULL == pVersions->ppVersions) || (NULL == pVersions->pLengths) || (NULL == pVersions->pText))
+	{
+		FreeBenchVersions(pVersions);
+		return false;
+	}
+
+	uint32_t seed = 20200524;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		char *pVersion = pVersions->pText + (idx * BENCH_VERSION_LENGTH);
+		uint32_t shape = NextBenchRandom(&seed) % 100;
+
+		// Most versions are plain triples with small numbers.
+		int length = snprintf(pVersion, BENCH_VERSION_LENGTH, "%u.%u.%u",
+			NextBenchRandom(&seed) % 20, NextBenchRandom(&seed) % 40, NextBenchRandom(&seed) % ((shape < 10) ? 10000 : 100));
+
+		if (shape >= 70)
+		{
+			length += snprintf(pVersion + length, BENCH_VERSION_LENGTH - length, "-%s.%u",
+				_prereleaseTags[NextBenchRandom(&seed) % TAG_COUNT(_prereleaseTags)], NextBenchRandom(&seed) % 20);
+		}
+
+		if (shape >= 90)
+		{
+			length += snprintf(pVersion + length, BENCH_VERSION_LENGTH - length, "+%s.%u",
+				_metaTags[NextBenchRandom(&seed) % TAG_COUNT(_metaTags)], NextBenchRandom(&seed) % 1000);
+		}
+
+		pVersions->ppVersions[idx] = pVersion;
+		pVersions->pLengths[idx] = (size_t)length;
+	}
+
+	return true;
+}
+
+void FreeBenchVersions(BenchVersions *pVersions)
+{
+	free(pVersions->ppVersions);
+	free(pVersions->pLengths);
+	free(pVersions->pText);
+	pVersions->ppVersions = NULL;
+	pVersions->pLengths = NULL;
+	pVersions->pText = NULL;
+	pVersions->count = 0;
+}
+
+FILE* OpenBenchFile(const char *pFileName, const char *pMode)
+{
+#ifdef _MSC_VER
+	FILE *fp = NULL;
+	return (0 == fopen_s(&fp, pFileName, pMode)) ? fp : NULL;
+#else
+	return fopen(pFileName, pMode);
+#endif
+}
+
+double BenchSeconds(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER now;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&now);
+
+	return (double)now.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+#endif
+}
@@ -0,0 +1,107 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Measures lookups per second through ClassifyVersionCandidateCached(), with
+// and without a shared cache, on 1, 2, 4 ... 64 threads all looking up the 
+// same few thousand strings.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "..\SemVerLib\SemVerCache.h"
+#include "..\SemVerLib\SemVerThreads.h"
+#include "SemVerBench.h"
+
+#define MAX_CACHE_THREADS 64
+
+// How many distinct strings are looked up, and how many the cache can hold.
+#define CACHE_BENCH_VERSIONS 4096
+#define CACHE_BENCH_CAPACITY 8192
+
+typedef struct
+{
+	VersionParseCache *pCache;
+	const BenchVersions *pVersions;
+	size_t lookups;
+	uint32_t seed;
+	size_t semVerCount;
+} CacheBenchTask;
+
+static void CacheBenchProc(void *pArg)
+{
+	CacheBenchTask *pTask = pArg;
+	const BenchVersions *pVersions = pTask->pVersions;
+
+	for (size_t lookup = 0; lookup < pTask->lookups; lookup++)
+	{
+		size_t idx = NextBenchRandom(&pTask->seed) % pVersions->count;
+		CachedVersion cached;
+
+		if (eSemVer_2_0_0 == ClassifyVersionCandidateCached(pTask->pCache, pVersions->ppVersions[idx], pVersions->pLengths[idx], &cached)->versionType)
+		{
+			pTask->semVerCount++;
+		}
+
+		FreeCachedVersion(&cached);
+	}
+}
+
+// Seconds for count lookups, split across threadCount threads.
+static double TimeLookups(VersionParseCache *pCache, const BenchVersions *pVersions, size_t count, size_t threadCount)
+{
+	CacheBenchTask tasks[MAX_CACHE_THREADS];
+
+	for (size_t idx = 0; idx < threadCount; idx++)
+	{
+		tasks[idx].pCache = pCache;
+		tasks[idx].pVersions = pVersions;
+		tasks[idx].lookups = count / threadCount;
+		tasks[idx].seed = (uint32_t)idx;
+		tasks[idx].semVerCount = 0;
+	}
+
+	double start = BenchSeconds();
+
+	RunSemVerThreads(CacheBenchProc, tasks, sizeof(CacheBenchTask), threadCount);
+
+	return BenchSeconds() - start;
+}
+
+int BenchCache(size_t count, const BenchOptions *pOptions)
+{
+	(void)pOptions;
+
+	BenchVersions versions;
+	VersionParseCache *pCache = CreateVersionParseCache(CACHE_BENCH_CAPACITY);
+
+	if ((NULL == pCache) || !MakeBenchVersions(&versions, CACHE_BENCH_VERSIONS))
+	{
+		printf("Out of memory.\n");
+		FreeVersionParseCache(pCache);
+		return -2;
+	}
+
+	// Warm the cache, so we measure the steady state.
+	TimeLookups(pCache, &versions, 4 * CACHE_BENCH_VERSIONS, 1);
+
+	printf("ClassifyVersionCandidateCached(), %zu lookups of %d strings, %zu processors\n", count, CACHE_BENCH_VERSIONS, GetSemVerProcessorCount());
+	printf("threads  uncached M/s  cached M/s   speedup\n");
+
+	for (size_t threads = 1; threads <= MAX_CACHE_THREADS; threads *= 2)
+	{
+		double uncached = TimeLookups(NULL, &versions, count, threads);
+		double cached = TimeLookups(pCache, &versions, count, threads);
+
+		printf("%7zu %13.2f %11.2f %9.2f\n", threads, (count / uncached) / 1e6, (count / cached) / 1e6, uncached / cached);
+	}
+
+	FreeVersionParseCache(pCache);
+	FreeBenchVersions(&versions);
+
+	return 0;
+}
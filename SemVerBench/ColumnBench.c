@@ -0,0 +1,169 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Measures CompareVersionColumn() against calling CompareVersions() once per
+// row, for a handful of targets spread across the generated versions, and 
+// checks that they agree.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerBatch.h"
+#include "SemVerBench.h"
+
+// Targets are taken from this many evenly spaced rows.
+#define COLUMN_TARGETS 8
+
+// Keep only what CompareVersionColumn() needs in the columns.
+typedef struct
+{
+	uint8_t *pVersionType;
+	uint32_t *pPrereleaseLength;
+	uint32_t *pMajorValue;
+	uint32_t *pMinorValue;
+	uint32_t *pPatchValue;
+	VersionColumns columns;
+} BenchColumns;
+
+static void FreeBenchColumns(BenchColumns *pColumns)
+{
+	free(pColumns->pVersionType);
+	free(pColumns->pPrereleaseLength);
+	free(pColumns->pMajorValue);
+	free(pColumns->pMinorValue);
+	free(pColumns->pPatchValue);
+}
+
+static bool MakeBenchColumns(BenchColumns *pColumns, size_t count)
+{
+	memset(pColumns, 0, sizeof(BenchColumns));
+
+	pColumns->pVersionType = malloc(count);
+	pColumns->pPrereleaseLength = malloc(count * sizeof(uint32_t));
+	pColumns->pMajorValue = malloc(count * sizeof(uint32_t));
+	pColumns->pMinorValue = malloc(count * sizeof(uint32_t));
+	pColumns->pPatchValue = malloc(count * sizeof(uint32_t));
+
+	if ((NULL == pColumns->pVersionType) || (NULL == pColumns->pPrereleaseLength)
+		|| (NULL == pColumns->pMajorValue) || (NULL == pColumns->pMinorValue) || (NULL == pColumns->pPatchValue))
+	{
+		FreeBenchColumns(pColumns);
+		return false;
+	}
+
+	pColumns->columns.pVersionType = pColumns->pVersionType;
+	pColumns->columns.pPrereleaseLength = pColumns->pPrereleaseLength;
+	pColumns->columns.pMajorValue = pColumns->pMajorValue;
+	pColumns->columns.pMinorValue = pColumns->pMinorValue;
+	pColumns->columns.pPatchValue = pColumns->pPatchValue;
+
+	return true;
+}
+
+int BenchColumn(size_t count, const BenchOptions *pOptions)
+{
+	(void)pOptions;
+
+	BenchVersions versions;
+	BenchColumns columns;
+	VersionParseRecord *pRecords = NULL;
+	int8_t *pExpected = NULL;
+	int8_t *pResults = NULL;
+
+	if (!MakeBenchVersions(&versions, count))
+	{
+		printf("Out of memory.\n");
+		return -2;
+	}
+
+	if (!MakeBenchColumns(&columns, count))
+	{
+		FreeBenchVersions(&versions);
+		printf("Out of memory.\n");
+		return -2;
+	}
+
+	pRecords = malloc(count * sizeof(VersionParseRecord));
+	pExpected = malloc(count);
+	pResults = malloc(count);
+
+	if ((NULL == pRecords) || (NULL == pExpected) || (NULL == pResults))
+	{
+		free(pRecords);
+		free(pExpected);
+		free(pResults);
+		FreeBenchColumns(&columns);
+		FreeBenchVersions(&versions);
+		printf("Out of memory.\n");
+		return -2;
+	}
+
+	const char * const *ppVersions = (const char * const *)versions.ppVersions;
+
+	// The one-by-one loop gets its records parsed up front too, so both sides
+	// only pay for comparing.
+	for (size_t row = 0; row < count; row++)
+	{
+		ClassifyVersionCandidateN(ppVersions[row], versions.pLengths[row], &pRecords[row]);
+	}
+
+	ClassifyVersionBatch(ppVersions, versions.pLengths, count, &columns.columns);
+
+	double scalarSeconds = 0;
+	double columnSeconds = 0;
+	size_t mismatches = 0;
+
+	for (size_t target = 0; target < COLUMN_TARGETS; target++)
+	{
+		size_t targetRow = (target * count) / COLUMN_TARGETS;
+		const char *pTarget = ppVersions[targetRow];
+		const VersionParseRecord *pParsed = &pRecords[targetRow];
+		double start = BenchSeconds();
+
+		for (size_t row = 0; row < count; row++)
+		{
+			pExpected[row] = (int8_t)CompareVersions(ppVersions[row], &pRecords[row], pTarget, pParsed);
+		}
+
+		scalarSeconds += BenchSeconds() - start;
+
+		start = BenchSeconds();
+		CompareVersionColumn(pTarget, pParsed, ppVersions, versions.pLengths, &columns.columns, count, pResults);
+		columnSeconds += BenchSeconds() - start;
+
+		mismatches += (0 != memcmp(pExpected, pResults, count));
+	}
+
+	double compares = (double)count * COLUMN_TARGETS;
+
+	printf("CompareVersionColumn() against CompareVersions(), %zu versions, %d targets\n", count, COLUMN_TARGETS);
+	printf("function                     ns/row\n");
+	printf("CompareVersions()         %9.2f\n", (scalarSeconds * 1e9) / compares);
+	printf("CompareVersionColumn()    %9.2f\n", (columnSeconds * 1e9) / compares);
+	printf("speedup %.2f\n", scalarSeconds / columnSeconds);
+
+	for (size_t row = 0; row < count; row++)
+	{
+		FreeVersionParseData(&pRecords[row]);
+	}
+
+	free(pRecords);
+	free(pExpected);
+	free(pResults);
+	FreeBenchColumns(&columns);
+	FreeBenchVersions(&versions);
+
+	if (0 != mismatches)
+	{
+		printf("CompareVersionColumn() and CompareVersions() disagree.\n");
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,219 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Matches generated versions against INDEX_BENCH_RANGES advisory style range
+// sets, with a VersionRangeIndex, and by asking every set in turn.  Asking
+// every set is far too slow to do for every version, so it's timed on the
+// first INDEX_BENCH_SAMPLE versions, which are also used to check the index.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerIndex.h"
+#include "SemVerBench.h"
+
+#define INDEX_BENCH_RANGES 100000
+#define INDEX_BENCH_SAMPLE 1000
+
+// Mostly "affected >= M.m.p, < M.m.q" within one minor line, over the same 
+// triples MakeBenchVersions() generates, with a second interval now and then,
+// and a few that reach back to the start of the major line.
+static bool MakeAdvisories(VersionRangeSet *pSets, size_t count)
+{
+	uint32_t seed = 20240229;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		size_t intervalCount = (0 == NextBenchRandom(&seed) % 4) ? 2 : 1;
+
+		for (size_t interval = 0; interval < intervalCount; interval++)
+		{
+			char lower[32];
+			char upper[32];
+			uint32_t major = NextBenchRandom(&seed) % 20;
+			uint32_t minor = NextBenchRandom(&seed) % 40;
+			uint32_t patch = NextBenchRandom(&seed) % 100;
+
+			if (0 == NextBenchRandom(&seed) % 100)
+			{
+				snprintf(lower, sizeof(lower), "%u.0.0", major);
+			}
+			else
+			{
+				snprintf(lower, sizeof(lower), "%u.%u.%u", major, minor, patch);
+			}
+
+			snprintf(upper, sizeof(upper), "%u.%u.%u", major, minor, patch + 1 + (NextBenchRandom(&seed) % 20));
+
+			if (!AddVersionInterval(&pSets[idx], lower, true, upper, false)) return false;
+		}
+	}
+
+	return true;
+}
+
+static int CompareIds(const void *p1, const void *p2)
+{
+	uint32_t id1 = *(const uint32_t*)p1;
+	uint32_t id2 = *(const uint32_t*)p2;
+
+	return (id1 < id2) ? -1 : (id1 > id2) ? 1 : 0;
+}
+
+int BenchIndex(size_t count, const BenchOptions *pOptions)
+{
+	(void)pOptions;
+
+	BenchVersions versions;
+	VersionRangeIndex index;
+	VersionRangeMatches matches = { 0 };
+	VersionRangeSet *pSets = malloc(INDEX_BENCH_RANGES * sizeof(VersionRangeSet));
+	SortableVersion *pVersions = malloc(count * sizeof(SortableVersion));
+	uint32_t *pIds = malloc(INDEX_BENCH_RANGES * sizeof(uint32_t));
+	size_t sampleCount = (count < INDEX_BENCH_SAMPLE) ? count : INDEX_BENCH_SAMPLE;
+	int result = 0;
+
+	InitVersionRangeIndex(&index);
+
+	for (size_t idx = 0; (NULL != pSets) && (idx < INDEX_BENCH_RANGES); idx++)
+	{
+		InitVersionRangeSet(&pSets[idx]);
+	}
+
+	if ((NULL == pSets) || (NULL == pVersions) || (NULL == pIds) || !MakeBenchVersions(&versions, count))
+	{
+		printf("Out of memory.\n");
+		free(pSets);
+		free(pVersions);
+		free(pIds);
+		return -2;
+	}
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		pVersions[idx].pVersion = versions.ppVersions[idx];
+		ClassifyVersionCandidateN(versions.ppVersions[idx], versions.pLengths[idx], &pVersions[idx].record);
+	}
+
+	double start = BenchSeconds();
+	bool built = MakeAdvisories(pSets, INDEX_BENCH_RANGES);
+	double setsBuild = BenchSeconds() - start;
+
+	start = BenchSeconds();
+	built = built && BuildVersionRangeIndex(&index, pSets, INDEX_BENCH_RANGES);
+	double indexBuild = BenchSeconds() - start;
+
+	if (!built)
+	{
+		printf("Out of memory.\n");
+		result = -2;
+	}
+
+	// Every set in turn, on the sample.
+	size_t scanMatches = 0;
+
+	start = BenchSeconds();
+
+	for (size_t idx = 0; built && (idx < sampleCount); idx++)
+	{
+		for (size_t set = 0; set < INDEX_BENCH_RANGES; set++)
+		{
+			if (VersionRangeContains(&pSets[set], pVersions[idx].pVersion, &pVersions[idx].record)) scanMatches++;
+		}
+	}
+
+	double scanSeconds = BenchSeconds() - start;
+
+	// The index, on the sample, checked against every set in turn.
+	for (size_t idx = 0; built && (0 == result) && (idx < sampleCount); idx++)
+	{
+		size_t found = FindContainingRanges(&index, pVersions[idx].pVersion, &pVersions[idx].record, pIds, INDEX_BENCH_RANGES);
+		size_t next = 0;
+
+		qsort(pIds, found, sizeof(uint32_t), CompareIds);
+
+		for (uint32_t set = 0; (0 == result) && (set < INDEX_BENCH_RANGES); set++)
+		{
+			if (!VersionRangeContains(&pSets[set], pVersions[idx].pVersion, &pVersions[idx].record)) continue;
+			if ((next >= found) || (pIds[next++] != set)) result = -1;
+		}
+
+		if ((0 == result) && (next != found)) result = -1;
+
+		if (0 != result) printf("The index and the sets disagree about %s.\n", pVersions[idx].pVersion);
+	}
+
+	// The index, one version at a time, then in batches.
+	size_t indexMatches = 0;
+
+	start = BenchSeconds();
+
+	for (size_t idx = 0; built && (idx < count); idx++)
+	{
+		indexMatches += FindContainingRanges(&index, pVersions[idx].pVersion, &pVersions[idx].record, pIds, INDEX_BENCH_RANGES);
+	}
+
+	double indexSeconds = BenchSeconds() - start;
+
+	start = BenchSeconds();
+	bool batched = built && FindContainingRangesBatch(&index, pVersions, count, 1, &matches);
+	double batchSeconds = BenchSeconds() - start;
+
+	FreeVersionRangeMatches(&matches);
+
+	start = BenchSeconds();
+	batched = batched && FindContainingRangesBatch(&index, pVersions, count, 0, &matches);
+	double threadedSeconds = BenchSeconds() - start;
+
+	if (built && !batched)
+	{
+		printf("Out of memory.\n");
+		result = -2;
+	}
+	else if (built && (matches.pStarts[count] != indexMatches))
+	{
+		printf("FindContainingRangesBatch() found %zu matches, and FindContainingRanges() %zu.\n", matches.pStarts[count], indexMatches);
+		result = -1;
+	}
+
+	if (0 == result)
+	{
+		double scanNs = (scanSeconds * 1e9) / (double)((0 == sampleCount) ? 1 : sampleCount);
+
+		printf("%d range sets, %zu bounds, %zu tree entries, built in %.3f seconds (sets %.3f)\n", INDEX_BENCH_RANGES,
+			index.boundCount, index.pNodeStarts[2 * index.leafCount], indexBuild, setsBuild);
+		printf("%zu versions, %.1f matches per version, %.1f in the sample\n", count, (double)indexMatches / (double)((0 == count) ? 1 : count),
+			(double)scanMatches / (double)((0 == sampleCount) ? 1 : sampleCount));
+		printf("method                   ns/version    speedup\n");
+		printf("every set (%4zu sample) %11.1f %10.1f\n", sampleCount, scanNs, 1.0);
+		printf("FindContainingRanges()  %11.1f %10.1f\n", (indexSeconds * 1e9) / (double)count, (scanSeconds / (double)sampleCount) / (indexSeconds / (double)count));
+		printf("batch, 1 thread         %11.1f %10.1f\n", (batchSeconds * 1e9) / (double)count, (scanSeconds / (double)sampleCount) / (batchSeconds / (double)count));
+		printf("batch, every processor  %11.1f %10.1f\n", (threadedSeconds * 1e9) / (double)count, (scanSeconds / (double)sampleCount) / (threadedSeconds / (double)count));
+	}
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		FreeVersionParseData(&pVersions[idx].record);
+	}
+
+	for (size_t idx = 0; idx < INDEX_BENCH_RANGES; idx++)
+	{
+		FreeVersionRangeSet(&pSets[idx]);
+	}
+
+	FreeVersionRangeMatches(&matches);
+	FreeVersionRangeIndex(&index);
+	FreeBenchVersions(&versions);
+	free(pSets);
+	free(pVersions);
+	free(pIds);
+
+	return result;
+}
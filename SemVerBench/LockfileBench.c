@@ -0,0 +1,215 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Measures ScanLockfile() throughput on generated package-lock.json, Cargo.lock
+// and go.sum files, and on the -input file if there is one, against copying
+// the same bytes.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerLockfile.h"
+#include "SemVerBench.h"
+
+// Entries are scanned this many at a time.
+#define LOCKFILE_BATCH 256
+
+// Room for everything but the version, in any format's entry.
+#define LOCKFILE_ENTRY_OVERHEAD 256
+
+typedef struct
+{
+	const char *pName;
+	char *pText;
+	size_t bytes;
+	// How many entries we expect, or SIZE_MAX if we don't know.
+	size_t expected;
+} LockfileText;
+
+// Write count packages in the given format.
+static bool MakeLockfileText(LockfileText *pText, LockfileFormat format, const BenchVersions *pVersions)
+{
+	size_t capacity = 1024;
+
+	for (size_t idx = 0; idx < pVersions->count; idx++) capacity += pVersions->pLengths[idx] + LOCKFILE_ENTRY_OVERHEAD;
+
+	pText->pText = malloc(capacity);
+	pText->bytes = 0;
+	pText->expected = pVersions->count;
+
+	if (NULL == pText->pText) return false;
+
+	char *pOut = pText->pText;
+
+	if (eLockfileNpm == format) pOut += sprintf(pOut, "{\n  \"lockfileVersion\": 3,\n  \"requires\": true,\n  \"packages\": {\n");
+	if (eLockfileCargo == format) pOut += sprintf(pOut, "# This file is automatically @generated by Cargo.\nversion = 3\n");
+
+	for (size_t idx = 0; idx < pVersions->count; idx++)
+	{
+		const char *pVersion = pVersions->ppVersions[idx];
+
+		switch (format)
+		{
+			case eLockfileNpm:
+				pOut += sprintf(pOut, "    \"node_modules/pkg%zu\": {\n      \"version\": \"%s\",\n"
+					"      \"resolved\": \"https://registry.npmjs.org/pkg%zu/-/pkg%zu.tgz\",\n"
+					"      \"integrity\": \"sha512-0123456789abcdef0123456789abcdef==\"\n    }%s\n",
+					idx, pVersion, idx, idx, (idx + 1 < pVersions->count) ? "," : "");
+				break;
+			case eLockfileCargo:
+				pOut += sprintf(pOut, "\n[[package]]\nname = \"pkg%zu\"\nversion = \"%s\"\n"
+					"source = \"registry+https://github.com/rust-lang/crates.io-index\"\n"
+					"checksum = \"0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef\"\n", idx, pVersion);
+				break;
+			default:
+				pOut += sprintf(pOut, "example.com/pkg%zu v%s h1:0123456789abcdef0123456789abcdef01234567890=\n"
+					"example.com/pkg%zu v%s/go.mod h1:0123456789abcdef0123456789abcdef01234567890=\n", idx, pVersion, idx, pVersion);
+				break;
+		}
+	}
+
+	if (eLockfileNpm == format) pOut += sprintf(pOut, "  }\n}\n");
+
+	pText->bytes = pOut - pText->pText;
+	return true;
+}
+
+static bool ReadLockfileText(LockfileText *pText, const char *pFileName)
+{
+	FILE *pFile = OpenBenchFile(pFileName, "rb");
+
+	memset(pText, 0, sizeof(LockfileText));
+	pText->pName = pFileName;
+	pText->expected = SIZE_MAX;
+
+	if ((NULL == pFile) || (0 != fseek(pFile, 0, SEEK_END)))
+	{
+		if (NULL != pFile) fclose(pFile);
+		return false;
+	}
+
+	long size = ftell(pFile);
+
+	rewind(pFile);
+	pText->bytes = (size > 0) ? (size_t)size : 0;
+	pText->pText = malloc(pText->bytes + 1);
+
+	bool read = (NULL != pText->pText) && (pText->bytes == fread(pText->pText, 1, pText->bytes, pFile));
+
+	fclose(pFile);
+	return read;
+}
+
+// Scan the whole text, and report.  False if the entry count is wrong.
+static bool ScanLockfileText(const LockfileText *pText, char *pCopy)
+{
+	static LockfileEntry entries[LOCKFILE_BATCH];
+	LockfileScanner scanner;
+	size_t found = 0;
+	size_t semVerCount = 0;
+	size_t count;
+
+	double start = BenchSeconds();
+
+	memcpy(pCopy, pText->pText, pText->bytes);
+
+	double copySeconds = BenchSeconds() - start;
+
+	start = BenchSeconds();
+	InitLockfileScanner(&scanner, eLockfileUnknown, pText->pText, pText->bytes);
+
+	do
+	{
+		count = ScanLockfile(&scanner, entries, LOCKFILE_BATCH);
+
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			semVerCount += (eSemVer_2_0_0 == entries[idx].record.versionType);
+			FreeVersionParseData(&entries[idx].record);
+		}
+
+		found += count;
+	} while (LOCKFILE_BATCH == count);
+
+	double scanSeconds = BenchSeconds() - start;
+	double megabytes = (double)pText->bytes / (1024.0 * 1024.0);
+
+	printf("%-20s %9.1f %9zu %9zu %9.0f %9.0f %8.1f\n", pText->pName, megabytes, found, semVerCount,
+		megabytes / scanSeconds, megabytes / copySeconds, (0 == found) ? 0.0 : (scanSeconds * 1e9) / (double)found);
+
+	return (SIZE_MAX == pText->expected) || (found == pText->expected);
+}
+
+int BenchLockfile(size_t count, const BenchOptions *pOptions)
+{
+	static const LockfileFormat formats[] = { eLockfileNpm, eLockfileCargo, eLockfileGoSum };
+	static const char *names[] = { "package-lock.json", "Cargo.lock", "go.sum" };
+	LockfileText texts[4];
+	size_t textCount = 0;
+	BenchVersions versions;
+	int result = 0;
+
+	if (!MakeBenchVersions(&versions, count))
+	{
+		printf("Out of memory.\n");
+		return -2;
+	}
+
+	for (size_t idx = 0; idx < sizeof(formats) / sizeof(formats[0]); idx++)
+	{
+		texts[textCount].pName = names[idx];
+
+		if (!MakeLockfileText(&texts[textCount], formats[idx], &versions)) result = -2;
+
+		textCount++;
+	}
+
+	FreeBenchVersions(&versions);
+
+	if ((NULL != pOptions->pInputFile) && !ReadLockfileText(&texts[textCount++], pOptions->pInputFile))
+	{
+		printf("Can't read %s\n", pOptions->pInputFile);
+		result = -2;
+	}
+
+	size_t largest = 0;
+
+	for (size_t idx = 0; idx < textCount; idx++)
+	{
+		if (texts[idx].bytes > largest) largest = texts[idx].bytes;
+	}
+
+	char *pCopy = malloc(largest + 1);
+
+	if ((NULL == pCopy) || (0 != result))
+	{
+		if (0 == result) printf("Out of memory.\n");
+		result = -2;
+	}
+	else
+	{
+		printf("ScanLockfile() throughput, %zu packages per generated file\n", count);
+		printf("file                        MB   entries    semver  scan MB/s  copy MB/s ns/entry\n");
+
+		for (size_t idx = 0; idx < textCount; idx++)
+		{
+			if (!ScanLockfileText(&texts[idx], pCopy))
+			{
+				printf("Wrong number of entries in %s.\n", texts[idx].pName);
+				result = -1;
+			}
+		}
+	}
+
+	free(pCopy);
+
+	for (size_t idx = 0; idx < textCount; idx++) free(texts[idx].pText);
+
+	return result;
+}
@@ -0,0 +1,124 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Hardware performance counters, from Linux perf_event_open().  Each counter
+// is opened on its own, so a machine (or VM) that only has some of them still
+// reports those.
+
+#include <string.h>
+
+#ifdef __linux__
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+#include "SemVerBench.h"
+
+static const char *_counterNames[eCounterCount] = { "cycles", "instructions", "branchMisses", "cacheMisses" };
+
+const char* GetBenchCounterName(BenchCounter counter)
+{
+	return _counterNames[counter];
+}
+
+#ifdef __linux__
+
+static const uint64_t _counterConfigs[eCounterCount] =
+{
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_BRANCH_MISSES,
+	PERF_COUNT_HW_CACHE_MISSES
+};
+
+void OpenBenchCounters(BenchCounters *pCounters)
+{
+	for (int counter = 0; counter < eCounterCount; counter++)
+	{
+		struct perf_event_attr attr;
+
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = _counterConfigs[counter];
+		attr.disabled = 1;
+		attr.inherit = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		pCounters->fds[counter] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	}
+}
+
+void CloseBenchCounters(BenchCounters *pCounters)
+{
+	for (int counter = 0; counter < eCounterCount; counter++)
+	{
+		if (pCounters->fds[counter] >= 0) close(pCounters->fds[counter]);
+
+		pCounters->fds[counter] = -1;
+	}
+}
+
+void StartBenchCounters(BenchCounters *pCounters)
+{
+	for (int counter = 0; counter < eCounterCount; counter++)
+	{
+		if (pCounters->fds[counter] < 0) continue;
+
+		ioctl(pCounters->fds[counter], PERF_EVENT_IOC_RESET, 0);
+		ioctl(pCounters->fds[counter], PERF_EVENT_IOC_ENABLE, 0);
+	}
+}
+
+void StopBenchCounters(BenchCounters *pCounters, uint64_t *pValues)
+{
+	for (int counter = 0; counter < eCounterCount; counter++)
+	{
+		pValues[counter] = BENCH_COUNTER_UNAVAILABLE;
+
+		if (pCounters->fds[counter] < 0) continue;
+
+		uint64_t value;
+
+		ioctl(pCounters->fds[counter], PERF_EVENT_IOC_DISABLE, 0);
+
+		if (sizeof(value) == read(pCounters->fds[counter], &value, sizeof(value))) pValues[counter] = value;
+	}
+}
+
+#else
+
+void OpenBenchCounters(BenchCounters *pCounters)
+{
+	for (int counter = 0; counter < eCounterCount; counter++)
+	{
+		pCounters->fds[counter] = -1;
+	}
+}
+
+void CloseBenchCounters(BenchCounters *pCounters)
+{
+	OpenBenchCounters(pCounters);
+}
+
+void StartBenchCounters(BenchCounters *pCounters)
+{
+}
+
+void StopBenchCounters(BenchCounters *pCounters, uint64_t *pValues)
+{
+	for (int counter = 0; counter < eCounterCount; counter++)
+	{
+		pValues[counter] = BENCH_COUNTER_UNAVAILABLE;
+	}
+}
+
+#endif
@@ -0,0 +1,502 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Runs a whole-file workload, phase by phase, the way SemVerExe -sort does, 
+// and reports time and hardware counters per byte for each phase.  Optionally
+// times SemVerExe itself on the same file, writes a JSON report, and fails 
+// the run if a phase is outside a limit.
+//
+// A limits file has one limit per line, '#' starts a comment:
+//
+//   <phase> <metric> max|min <value>
+//
+// e.g. "classify cyclesPerByte max 40", or "read mbPerSecond min 200".
+// Metrics are those in the JSON report.
+// A limit on a metric the machine can't measure is reported, but not failed.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerSort.h"
+#include "SemVerBench.h"
+
+static const char *_generatedInputFile = "SemVerBench.pipeline.txt";
+static const char *_outputFile = "SemVerBench.pipeline.out.txt";
+
+typedef enum
+{
+	ePhaseRead = 0,
+	ePhaseClassify,
+	ePhaseCompare,
+	ePhaseSort,
+	ePhaseOutput,
+	ePhaseExe,
+	ePhaseCount
+} Phase;
+
+static const char *_phaseNames[ePhaseCount] = { "read", "classify", "compare", "sort", "output", "exe" };
+
+typedef enum
+{
+	eMetricSeconds = 0,
+	eMetricMBPerSecond,
+	eMetricCyclesPerByte,
+	eMetricInstructionsPerByte,
+	eMetricBranchMissesPerKB,
+	eMetricCacheMissesPerKB,
+	eMetricCount
+} Metric;
+
+static const char *_metricNames[eMetricCount] = 
+{ 
+	"seconds", "mbPerSecond", "cyclesPerByte", "instructionsPerByte", "branchMissesPerKB", "cacheMissesPerKB" 
+};
+
+typedef struct
+{
+	bool ran;
+	double seconds;
+	uint64_t counters[eCounterCount];
+} PhaseResult;
+
+// Everything the phases work on.
+typedef struct
+{
+	const char *pInputFile;
+	char *pText;
+	size_t bytes;
+	SortableVersion *pVersions;
+	size_t count;
+	BenchCounters counters;
+	PhaseResult results[ePhaseCount];
+} Pipeline;
+
+// A sink for compare results, so the compiler can't skip the compares.
+static volatile int _compareSink;
+
+static inline void StartPhase(Pipeline *pPipeline, Phase phase)
+{
+	pPipeline->results[phase].ran = true;
+	pPipeline->results[phase].seconds = BenchSeconds();
+	StartBenchCounters(&pPipeline->counters);
+}
+
+static inline void StopPhase(Pipeline *pPipeline, Phase phase)
+{
+	StopBenchCounters(&pPipeline->counters, pPipeline->results[phase].counters);
+	pPipeline->results[phase].seconds = BenchSeconds() - pPipeline->results[phase].seconds;
+}
+
+// NAN if the phase didn't run, or the counter isn't available.
+static double GetMetric(const Pipeline *pPipeline, Phase phase, Metric metric)
+{
+	const PhaseResult *pResult = &pPipeline->results[phase];
+	double bytes = (double)pPipeline->bytes;
+	BenchCounter counter = eCounterCycles;
+	double scale = 1.0;
+
+	if (!pResult->ran || (0 == pPipeline->bytes)) return NAN;
+
+	switch (metric)
+	{
+	case eMetricSeconds: return pResult->seconds;
+	case eMetricMBPerSecond: return (bytes / 1e6) / pResult->seconds;
+	case eMetricCyclesPerByte: counter = eCounterCycles; break;
+	case eMetricInstructionsPerByte: counter = eCounterInstructions; break;
+	case eMetricBranchMissesPerKB: counter = eCounterBranchMisses; scale = 1024.0; break;
+	case eMetricCacheMissesPerKB: counter = eCounterCacheMisses; scale = 1024.0; break;
+	default: return NAN;
+	}
+
+	if (BENCH_COUNTER_UNAVAILABLE == pResult->counters[counter]) return NAN;
+
+	return ((double)pResult->counters[counter] * scale) / bytes;
+}
+
+static bool WriteGeneratedInput(size_t count)
+{
+	BenchVersions versions;
+	FILE *pFile = OpenBenchFile(_generatedInputFile, "wb");
+
+	if ((NULL == pFile) || !MakeBenchVersions(&versions, count))
+	{
+		if (NULL != pFile) fclose(pFile);
+		return false;
+	}
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		fputs(versions.ppVersions[idx], pFile);
+		fputc('\n', pFile);
+	}
+
+	FreeBenchVersions(&versions);
+	return 0 == fclose(pFile);
+}
+
+// Read the whole file, and split it into null terminated lines, in place.
+static bool ReadPhase(Pipeline *pPipeline)
+{
+	StartPhase(pPipeline, ePhaseRead);
+
+	FILE *pFile = OpenBenchFile(pPipeline->pInputFile, "rb");
+
+	if ((NULL == pFile) || (0 != fseek(pFile, 0, SEEK_END)))
+	{
+		if (NULL != pFile) fclose(pFile);
+		return false;
+	}
+
+	long size = ftell(pFile);
+
+	rewind(pFile);
+	pPipeline->bytes = (size > 0) ? (size_t)size : 0;
+	pPipeline->pText = malloc(pPipeline->bytes + 1);
+
+	if ((NULL == pPipeline->pText) || (pPipeline->bytes != fread(pPipeline->pText, 1, pPipeline->bytes, pFile)))
+	{
+		fclose(pFile);
+		return false;
+	}
+
+	fclose(pFile);
+	pPipeline->pText[pPipeline->bytes] = '\n';
+
+	size_t lineCount = 0;
+
+	for (size_t idx = 0; idx < pPipeline->bytes; idx++)
+	{
+		if ('\n' == pPipeline->pText[idx]) lineCount++;
+	}
+
+	pPipeline->pVersions = malloc((lineCount + 1) * sizeof(SortableVersion));
+
+	if (NULL == pPipeline->pVersions) return false;
+
+	for (char *pLine = pPipeline->pText; pLine < pPipeline->pText + pPipeline->bytes; )
+	{
+		// The input may hold null bytes, so stay within the text we read.
+		char *pEnd = memchr(pLine, '\n', (size_t)(pPipeline->pText + pPipeline->bytes + 1 - pLine));
+
+		*pEnd = '\0';
+
+		if ((pEnd > pLine) && ('\r' == pEnd[-1])) pEnd[-1] = '\0';
+
+		pPipeline->pVersions[pPipeline->count++].pVersion = pLine;
+		pLine = pEnd + 1;
+	}
+
+	StopPhase(pPipeline, ePhaseRead);
+	return true;
+}
+
+static void ClassifyPhase(Pipeline *pPipeline)
+{
+	StartPhase(pPipeline, ePhaseClassify);
+
+	for (size_t idx = 0; idx < pPipeline->count; idx++)
+	{
+		ClassifyVersionCandidate(pPipeline->pVersions[idx].pVersion, &pPipeline->pVersions[idx].record);
+	}
+
+	StopPhase(pPipeline, ePhaseClassify);
+}
+
+// Each version against the next, in file order.
+static void ComparePhase(Pipeline *pPipeline)
+{
+	int sum = 0;
+
+	StartPhase(pPipeline, ePhaseCompare);
+
+	for (size_t idx = 1; idx < pPipeline->count; idx++)
+	{
+		sum += CompareSortableVersions(&pPipeline->pVersions[idx - 1], &pPipeline->pVersions[idx]);
+	}
+
+	StopPhase(pPipeline, ePhaseCompare);
+	_compareSink = sum;
+}
+
+static bool SortPhase(Pipeline *pPipeline)
+{
+	StartPhase(pPipeline, ePhaseSort);
+
+	bool sorted = SortVersions(pPipeline->pVersions, pPipeline->count, 0);
+
+	StopPhase(pPipeline, ePhaseSort);
+	return sorted;
+}
+
+static bool OutputPhase(Pipeline *pPipeline)
+{
+	StartPhase(pPipeline, ePhaseOutput);
+
+	FILE *pFile = OpenBenchFile(_outputFile, "wb");
+
+	if (NULL == pFile) return false;
+
+	for (size_t idx = 0; idx < pPipeline->count; idx++)
+	{
+		fputs(pPipeline->pVersions[idx].pVersion, pFile);
+		fputc('\n', pFile);
+	}
+
+	bool written = (0 == fclose(pFile));
+
+	StopPhase(pPipeline, ePhaseOutput);
+	return written;
+}
+
+// SemVerExe -sort on the same file, counters included.
+static bool ExePhase(Pipeline *pPipeline, const char *pExeFile)
+{
+	size_t length = strlen(pExeFile) + strlen(pPipeline->pInputFile) + strlen(_outputFile) + 32;
+	char *pCommand = malloc(length);
+
+	if (NULL == pCommand) return false;
+
+	snprintf(pCommand, length, "\"%s\" -sort \"%s\" \"%s\"", pExeFile, pPipeline->pInputFile, _outputFile);
+
+	StartPhase(pPipeline, ePhaseExe);
+
+	int exitCode = system(pCommand);
+
+	StopPhase(pPipeline, ePhaseExe);
+
+	free(pCommand);
+	return 0 == exitCode;
+}
+
+static void PrintMetric(double value, const char *pFormat)
+{
+	if (isnan(value))
+	{
+		printf("%*s", atoi(pFormat + 1), "n/a");
+	}
+	else
+	{
+		printf(pFormat, value);
+	}
+}
+
+static void PrintTable(const Pipeline *pPipeline)
+{
+	printf("%zu versions, %zu bytes, from %s\n", pPipeline->count, pPipeline->bytes, pPipeline->pInputFile);
+	printf("phase      seconds     MB/s  cycles/B   instr/B  brmiss/KB  $miss/KB\n");
+
+	for (int phase = 0; phase < ePhaseCount; phase++)
+	{
+		if (!pPipeline->results[phase].ran) continue;
+
+		printf("%-8s", _phaseNames[phase]);
+		PrintMetric(GetMetric(pPipeline, phase, eMetricSeconds), "%10.4f");
+		PrintMetric(GetMetric(pPipeline, phase, eMetricMBPerSecond), "%9.1f");
+		PrintMetric(GetMetric(pPipeline, phase, eMetricCyclesPerByte), "%10.2f");
+		PrintMetric(GetMetric(pPipeline, phase, eMetricInstructionsPerByte), "%10.2f");
+		PrintMetric(GetMetric(pPipeline, phase, eMetricBranchMissesPerKB), "%11.3f");
+		PrintMetric(GetMetric(pPipeline, phase, eMetricCacheMissesPerKB), "%10.3f");
+		printf("\n");
+	}
+}
+
+static bool WriteJsonReport(const Pipeline *pPipeline, const char *pJsonFile)
+{
+	FILE *pFile = OpenBenchFile(pJsonFile, "wb");
+
+	if (NULL == pFile) return false;
+
+	fprintf(pFile, "{\n  \"benchmark\": \"pipeline\",\n  \"versions\": %zu,\n  \"bytes\": %zu,\n  \"phases\": [", pPipeline->count, pPipeline->bytes);
+
+	const char *pSeparator = "\n";
+
+	for (int phase = 0; phase < ePhaseCount; phase++)
+	{
+		const PhaseResult *pResult = &pPipeline->results[phase];
+
+		if (!pResult->ran) continue;
+
+		fprintf(pFile, "%s    { \"name\": \"%s\"", pSeparator, _phaseNames[phase]);
+
+		for (int counter = 0; counter < eCounterCount; counter++)
+		{
+			if (BENCH_COUNTER_UNAVAILABLE == pResult->counters[counter])
+			{
+				fprintf(pFile, ", \"%s\": null", GetBenchCounterName(counter));
+			}
+			else
+			{
+				fprintf(pFile, ", \"%s\": %llu", GetBenchCounterName(counter), (unsigned long long)pResult->counters[counter]);
+			}
+		}
+
+		for (int metric = 0; metric < eMetricCount; metric++)
+		{
+			double value = GetMetric(pPipeline, phase, metric);
+
+			if (isnan(value))
+			{
+				fprintf(pFile, ", \"%s\": null", _metricNames[metric]);
+			}
+			else
+			{
+				fprintf(pFile, ", \"%s\": %.6g", _metricNames[metric], value);
+			}
+		}
+
+		fprintf(pFile, " }");
+		pSeparator = ",\n";
+	}
+
+	fprintf(pFile, "\n  ]\n}\n");
+	return 0 == fclose(pFile);
+}
+
+static int FindName(const char *pName, const char **ppNames, int count)
+{
+	for (int idx = 0; idx < count; idx++)
+	{
+		if (0 == strcmp(pName, ppNames[idx])) return idx;
+	}
+
+	return -1;
+}
+
+// Returns how many limits were exceeded, or -1 if the file is bad.
+static int CheckLimits(const Pipeline *pPipeline, const char *pLimitsFile)
+{
+	FILE *pFile = OpenBenchFile(pLimitsFile, "r");
+	char line[256];
+	int exceeded = 0;
+	int lineNumber = 0;
+
+	if (NULL == pFile)
+	{
+		printf("Can't open %s\n", pLimitsFile);
+		return -1;
+	}
+
+	while ((exceeded >= 0) && (NULL != fgets(line, sizeof(line), pFile)))
+	{
+		char phaseName[32];
+		char metricName[32];
+		char kind[4];
+		double limit;
+		char *pComment = strchr(line, '#');
+
+		lineNumber++;
+
+		if (NULL != pComment) *pComment = '\0';
+
+		int fields = sscanf(line, "%31s %31s %3s %lf", phaseName, metricName, kind, &limit);
+
+		if (fields <= 0) continue;
+
+		int phase = FindName(phaseName, _phaseNames, ePhaseCount);
+		int metric = FindName(metricName, _metricNames, eMetricCount);
+		bool isMinimum = (4 == fields) && (0 == strcmp(kind, "min"));
+
+		if ((4 != fields) || (phase < 0) || (metric < 0) || (!isMinimum && (0 != strcmp(kind, "max"))))
+		{
+			printf("%s(%d): expected <phase> <metric> max|min <value>\n", pLimitsFile, lineNumber);
+			exceeded = -1;
+			break;
+		}
+
+		double value = GetMetric(pPipeline, phase, metric);
+
+		if (isnan(value))
+		{
+			printf("Limit %s %s not checked, it wasn't measured.\n", phaseName, metricName);
+		}
+		else if (isMinimum ? (value < limit) : (value > limit))
+		{
+			printf("Limit exceeded: %s %s is %.4g, the %s is %.4g\n", 
+				phaseName, metricName, value, isMinimum ? "minimum" : "maximum", limit);
+			exceeded++;
+		}
+	}
+
+	fclose(pFile);
+	return exceeded;
+}
+
+int BenchPipeline(size_t count, const BenchOptions *pOptions)
+{
+	Pipeline pipeline;
+
+	memset(&pipeline, 0, sizeof(pipeline));
+	pipeline.pInputFile = (NULL != pOptions->pInputFile) ? pOptions->pInputFile : _generatedInputFile;
+
+	if ((NULL == pOptions->pInputFile) && !WriteGeneratedInput(count))
+	{
+		printf("Can't write %s\n", _generatedInputFile);
+		return -2;
+	}
+
+	OpenBenchCounters(&pipeline.counters);
+
+	int exitCode = 0;
+
+	if (!ReadPhase(&pipeline))
+	{
+		printf("Can't read %s\n", pipeline.pInputFile);
+		exitCode = -2;
+	}
+	else
+	{
+		ClassifyPhase(&pipeline);
+		ComparePhase(&pipeline);
+
+		if (!SortPhase(&pipeline) || !OutputPhase(&pipeline))
+		{
+			printf("Out of memory, or can't write %s\n", _outputFile);
+			exitCode = -2;
+		}
+		else if ((NULL != pOptions->pExeFile) && !ExePhase(&pipeline, pOptions->pExeFile))
+		{
+			printf("%s failed.\n", pOptions->pExeFile);
+			exitCode = -2;
+		}
+	}
+
+	CloseBenchCounters(&pipeline.counters);
+
+	if (0 == exitCode)
+	{
+		PrintTable(&pipeline);
+
+		if ((NULL != pOptions->pJsonFile) && !WriteJsonReport(&pipeline, pOptions->pJsonFile))
+		{
+			printf("Can't write %s\n", pOptions->pJsonFile);
+			exitCode = -2;
+		}
+	}
+
+	if ((0 == exitCode) && (NULL != pOptions->pLimitsFile))
+	{
+		int exceeded = CheckLimits(&pipeline, pOptions->pLimitsFile);
+
+		exitCode = (exceeded < 0) ? -2 : ((exceeded > 0) ? -1 : 0);
+	}
+
+	for (size_t idx = 0; pipeline.results[ePhaseClassify].ran && (idx < pipeline.count); idx++)
+	{
+		FreeVersionParseData(&pipeline.pVersions[idx].record);
+	}
+
+	free(pipeline.pVersions);
+	free(pipeline.pText);
+	remove(_outputFile);
+
+	if (NULL == pOptions->pInputFile) remove(_generatedInputFile);
+
+	return exitCode;
+}
@@ -0,0 +1,90 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerBench_h_Defined
+#define _SharperHacks_SemVerBench_h_Defined
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// A set of generated version strings, with a realistic spread of triples,
+// prerelease and meta tags, and some duplicates.
+typedef struct
+{
+	char **ppVersions;
+	size_t *pLengths;
+	size_t count;
+	char *pText;
+} BenchVersions;
+
+// A fixed generator, so every run, and every platform, sees the same data.
+uint32_t NextBenchRandom(uint32_t *pSeed);
+
+// Generates count versions, the same ones every time for the same count.
+bool MakeBenchVersions(BenchVersions *pVersions, size_t count);
+void FreeBenchVersions(BenchVersions *pVersions);
+
+// fopen(), without the MSVC deprecation warnings.
+FILE* OpenBenchFile(const char *pFileName, const char *pMode);
+
+// Seconds since some fixed point, from the best clock the platform has.
+double BenchSeconds(void);
+
+// The hardware counters we read around each benchmark phase.
+typedef enum
+{
+	eCounterCycles = 0,
+	eCounterInstructions,
+	eCounterBranchMisses,
+	eCounterCacheMisses,
+	eCounterCount
+} BenchCounter;
+
+// Reported for a counter the platform, or the machine, doesn't give us.
+#define BENCH_COUNTER_UNAVAILABLE UINT64_MAX
+
+// User mode counts for this thread, and any threads or processes it starts
+// while the counters are running.  Linux perf_event_open() only, everywhere
+// else every counter is unavailable.
+typedef struct
+{
+	int fds[eCounterCount];
+} BenchCounters;
+
+void OpenBenchCounters(BenchCounters *pCounters);
+void CloseBenchCounters(BenchCounters *pCounters);
+void StartBenchCounters(BenchCounters *pCounters);
+void StopBenchCounters(BenchCounters *pCounters, uint64_t *pValues);
+const char* GetBenchCounterName(BenchCounter counter);
+
+// Options that follow the count on the command line.  Benchmarks ignore the
+// ones they don't support.
+typedef struct
+{
+	const char *pInputFile;		// Versions to use, one per line, instead of generated ones.
+	const char *pJsonFile;		// Write a JSON report here.
+	const char *pLimitsFile;	// Fail the run if any limit in here is exceeded.
+	const char *pExeFile;		// A SemVerExe to time, as a phase of its own.
+} BenchOptions;
+
+// Benchmarks.  Each returns the exit code.
+
+int BenchCache(size_t count, const BenchOptions *pOptions);
+int BenchColumn(size_t count, const BenchOptions *pOptions);
+int BenchIndex(size_t count, const BenchOptions *pOptions);
+int BenchLockfile(size_t count, const BenchOptions *pOptions);
+int BenchPipeline(size_t count, const BenchOptions *pOptions);
+int BenchSet(size_t count, const BenchOptions *pOptions);
+int BenchSort(size_t count, const BenchOptions *pOptions);
+int BenchValidate(size_t count, const BenchOptions *pOptions);
+
+#endif
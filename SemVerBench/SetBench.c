@@ -0,0 +1,120 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Compares a VersionSet with an array of SortableVersion's holding the same
+// versions: bytes used, time to build, and time to sort on one thread.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerSet.h"
+#include "..\SemVerLib\SemVerSort.h"
+#include "SemVerBench.h"
+
+// Tag arrays are allocated this many records at a time, see SemVer.c.
+#define TAG_BLOCK 5
+
+static size_t TagArrayBytes(size_t fieldCount)
+{
+	return ((fieldCount + TAG_BLOCK - 1) / TAG_BLOCK) * TAG_BLOCK * sizeof(ParsedTagRecord);
+}
+
+int BenchSet(size_t count, const BenchOptions *pOptions)
+{
+	(void)pOptions;
+
+	BenchVersions versions;
+	VersionSet set;
+	SortableVersion *pVersions = malloc(count * sizeof(SortableVersion));
+
+	InitVersionSet(&set);
+
+	if ((NULL == pVersions) || !MakeBenchVersions(&versions, count))
+	{
+		printf("Out of memory.\n");
+		free(pVersions);
+		return -2;
+	}
+
+	size_t rawBytes = 0;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		rawBytes += versions.pLengths[idx] + 1;
+	}
+
+	// Record per version, plus its own tag arrays and string, ignoring heap overhead.
+	double start = BenchSeconds();
+	size_t recordBytes = count * sizeof(SortableVersion) + rawBytes;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		VersionParseRecord *pRecord = &pVersions[idx].record;
+
+		pVersions[idx].pVersion = versions.ppVersions[idx];
+		ClassifyVersionCandidateN(versions.ppVersions[idx], versions.pLengths[idx], pRecord);
+
+		if (pRecord->hasPrereleaseTag) recordBytes += TagArrayBytes(pRecord->prereleaseFieldCount);
+		if (pRecord->hasMetaTag) recordBytes += TagArrayBytes(pRecord->metaFieldCount);
+	}
+
+	double recordBuild = BenchSeconds() - start;
+
+	start = BenchSeconds();
+	bool built = AddVersions(&set, (const char * const *)versions.ppVersions, versions.pLengths, count);
+	double setBuild = BenchSeconds() - start;
+
+	size_t setBytes = set.count * sizeof(VersionSetEntry) + set.tagCount * sizeof(VersionSetTag) + set.detailCount * sizeof(VersionSetDetail) + set.stringBytes;
+
+	start = BenchSeconds();
+	bool recordsSorted = SortVersions(pVersions, count, 1);
+	double recordSort = BenchSeconds() - start;
+
+	start = BenchSeconds();
+	bool setSorted = built && SortVersionSet(&set);
+	double setSort = BenchSeconds() - start;
+
+	int result = 0;
+
+	if (!recordsSorted || !setSorted)
+	{
+		printf("Out of memory.\n");
+		result = -2;
+	}
+	else
+	{
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			if (0 != strcmp(pVersions[idx].pVersion, GetVersionSetString(&set, idx)))
+			{
+				printf("SortVersionSet() and SortVersions() disagree at %zu.\n", idx);
+				result = -1;
+				break;
+			}
+		}
+
+		printf("VersionSet against SortableVersion records, %zu versions, %zu string bytes\n", count, rawBytes);
+		printf("layout        bytes/version  x strings  build ns/version  sort seconds\n");
+		printf("records       %13.1f %10.2f %17.1f %13.3f\n", (double)recordBytes / (double)count, (double)recordBytes / (double)rawBytes,
+			(recordBuild * 1e9) / (double)count, recordSort);
+		printf("VersionSet    %13.1f %10.2f %17.1f %13.3f\n", (double)setBytes / (double)count, (double)setBytes / (double)rawBytes,
+			(setBuild * 1e9) / (double)count, setSort);
+	}
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		FreeVersionParseData(&pVersions[idx].record);
+	}
+
+	free(pVersions);
+	FreeVersionSet(&set);
+	FreeBenchVersions(&versions);
+
+	return result;
+}
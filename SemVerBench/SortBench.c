@@ -0,0 +1,80 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Measures SortVersions() on 1, 2, 4 ... 32 threads, against the same data,
+// and reports the speedup over one thread.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerSort.h"
+#include "..\SemVerLib\SemVerThreads.h"
+#include "SemVerBench.h"
+
+#define MAX_SORT_THREADS 32
+
+int BenchSort(size_t count, const BenchOptions *pOptions)
+{
+	(void)pOptions;
+
+	BenchVersions versions;
+
+	SortableVersion *pOriginal = malloc(count * sizeof(SortableVersion));
+	SortableVersion *pVersions = malloc(count * sizeof(SortableVersion));
+
+	if ((NULL == pOriginal) || (NULL == pVersions) || !MakeBenchVersions(&versions, count))
+	{
+		printf("Out of memory.\n");
+		free(pOriginal);
+		free(pVersions);
+		return -2;
+	}
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		pOriginal[idx].pVersion = versions.ppVersions[idx];
+		ClassifyVersionCandidate(versions.ppVersions[idx], &pOriginal[idx].record);
+	}
+
+	printf("SortVersions(), %zu versions, %zu processors\n", count, GetSemVerProcessorCount());
+	printf("threads   seconds   speedup\n");
+
+	double oneThread = 0;
+
+	for (size_t threads = 1; threads <= MAX_SORT_THREADS; threads *= 2)
+	{
+		// The records are only moved, so a shallow copy is all we need.
+		memcpy(pVersions, pOriginal, count * sizeof(SortableVersion));
+
+		double start = BenchSeconds();
+		bool sorted = SortVersions(pVersions, count, threads);
+		double elapsed = BenchSeconds() - start;
+
+		if (!sorted)
+		{
+			printf("Out of memory.\n");
+			break;
+		}
+
+		if (1 == threads) oneThread = elapsed;
+
+		printf("%7zu %9.3f %9.2f\n", threads, elapsed, oneThread / elapsed);
+	}
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		FreeVersionParseData(&pOriginal[idx].record);
+	}
+
+	free(pOriginal);
+	free(pVersions);
+	FreeBenchVersions(&versions);
+
+	return 0;
+}
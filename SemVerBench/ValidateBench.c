@@ -0,0 +1,91 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Measures IsSemVer() against ClassifyVersionCandidateN(), on the same 
+// versions, and checks that they agree.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "..\SemVerLib\SemVer.h"
+#include "SemVerBench.h"
+
+// Every version is validated this many times, so short runs still measure.
+#define VALIDATE_PASSES 10
+
+// End every tenth version with a dot, so there's a share of invalid strings
+// to reject.
+static void DamageVersions(BenchVersions *pVersions)
+{
+	for (size_t idx = 0; idx < pVersions->count; idx += 10)
+	{
+		pVersions->ppVersions[idx][pVersions->pLengths[idx] - 1] = '.';
+	}
+}
+
+int BenchValidate(size_t count, const BenchOptions *pOptions)
+{
+	(void)pOptions;
+
+	BenchVersions versions;
+
+	if (!MakeBenchVersions(&versions, count))
+	{
+		printf("Out of memory.\n");
+		return -2;
+	}
+
+	DamageVersions(&versions);
+
+	size_t classified = 0;
+	double start = BenchSeconds();
+
+	for (int pass = 0; pass < VALIDATE_PASSES; pass++)
+	{
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			VersionParseRecord record;
+
+			ClassifyVersionCandidateN(versions.ppVersions[idx], versions.pLengths[idx], &record);
+			classified += (eSemVer_2_0_0 == record.versionType);
+			FreeVersionParseData(&record);
+		}
+	}
+
+	double classifySeconds = BenchSeconds() - start;
+	size_t validated = 0;
+
+	start = BenchSeconds();
+
+	for (int pass = 0; pass < VALIDATE_PASSES; pass++)
+	{
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			validated += IsSemVer(versions.ppVersions[idx], versions.pLengths[idx]);
+		}
+	}
+
+	double validateSeconds = BenchSeconds() - start;
+	double calls = (double)count * VALIDATE_PASSES;
+
+	printf("IsSemVer() against ClassifyVersionCandidateN(), %zu versions, %d passes\n", count, VALIDATE_PASSES);
+	printf("function                       ns/call    valid\n");
+	printf("ClassifyVersionCandidateN() %10.1f %8zu\n", (classifySeconds * 1e9) / calls, classified / VALIDATE_PASSES);
+	printf("IsSemVer()                  %10.1f %8zu\n", (validateSeconds * 1e9) / calls, validated / VALIDATE_PASSES);
+	printf("speedup %.2f\n", classifySeconds / validateSeconds);
+
+	FreeBenchVersions(&versions);
+
+	if (classified != validated)
+	{
+		printf("IsSemVer() and ClassifyVersionCandidateN() disagree.\n");
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Benchmarks for the library's hot paths.  Not part of the unit tests, 
+// because the numbers only mean something in a Release build, on a quiet
+// machine.
+//
+//   SemVerBench <benchmark> [count] [-input <file>] [-json <file>] [-limits <file>] [-exe <SemVerExe>]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SemVerBench.h"
+
+typedef int (*BenchHandler)(size_t count, const BenchOptions *pOptions);
+
+static struct {
+	char *pName;
+	BenchHandler handler;
+	size_t defaultCount;
+	char *pDescription;
+} _benchmarks[] =
+{
+	{ "pipeline", BenchPipeline, 1000000, "Read, classify, compare, sort and write a file, with hardware counters." },
+	{ "cache", BenchCache, 20000000, "ClassifyVersionCandidateCached() against no cache, 1 to 64 threads." },
+	{ "set", BenchSet, 5000000, "VersionSet bytes, build and sort time against SortableVersion records." },
+	{ "sort", BenchSort, 10000000, "SortVersions() speedup, 1 to 32 threads." },
+	{ "column", BenchColumn, 1000000, "CompareVersionColumn() against CompareVersions() per row." },
+	{ "lockfile", BenchLockfile, 1000000, "ScanLockfile() MB/s on generated lockfiles, or -input, against memcpy()." },
+	{ "issemver", BenchValidate, 1000000, "IsSemVer() against ClassifyVersionCandidateN()." },
+	{ "index", BenchIndex, 1000000, "FindContainingRanges() over 100000 range sets, against asking every set." },
+};
+
+#define BENCHMARK_COUNT (sizeof(_benchmarks) / sizeof(_benchmarks[0]))
+
+static int Usage(void)
+{
+	printf("SemVerBench <benchmark> [count] [-input <file>] [-json <file>] [-limits <file>] [-exe <SemVerExe>]\n");
+
+	for (size_t idx = 0; idx < BENCHMARK_COUNT; idx++)
+	{
+		printf("  %-10s %s Default count %zu.\n", _benchmarks[idx].pName, _benchmarks[idx].pDescription, _benchmarks[idx].defaultCount);
+	}
+
+	return -2;
+}
+
+// Fills in pOptions, and *pCount if there's a count, from argv[2] on.
+static bool ParseOptions(int argc, char **argv, size_t *pCount, BenchOptions *pOptions)
+{
+	memset(pOptions, 0, sizeof(BenchOptions));
+
+	for (int arg = 2; arg < argc; arg++)
+	{
+		const char **ppValue = NULL;
+
+		if (0 == strcmp(argv[arg], "-input")) ppValue = &pOptions->pInputFile;
+		else if (0 == strcmp(argv[arg], "-json")) ppValue = &pOptions->pJsonFile;
+		else if (0 == strcmp(argv[arg], "-limits")) ppValue = &pOptions->pLimitsFile;
+		else if (0 == strcmp(argv[arg], "-exe")) ppValue = &pOptions->pExeFile;
+
+		if (NULL != ppValue)
+		{
+			if (++arg == argc) return false;
+
+			*ppValue = argv[arg];
+		}
+		else if (2 == arg)
+		{
+			char *pEnd;
+			*pCount = strtoul(argv[arg], &pEnd, 10);
+
+			if ((0 == *pCount) || ('\0' != *pEnd)) return false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2) return Usage();
+
+	for (size_t idx = 0; idx < BENCHMARK_COUNT; idx++)
+	{
+		if (0 != strcmp(argv[1], _benchmarks[idx].pName)) continue;
+
+		size_t count = _benchmarks[idx].defaultCount;
+		BenchOptions options;
+
+		if (!ParseOptions(argc, argv, &count, &options)) return Usage();
+
+		return _benchmarks[idx].handler(count, &options);
+	}
+
+	return Usage();
+}
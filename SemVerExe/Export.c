@@ -0,0 +1,296 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Splits a file of version strings, one per line, into columns.
+//
+// CSV output has a header row, then one row per line of input:
+//
+//   version,type,major,minor,patch,prerelease,prerelease_fields,meta,meta_fields
+//
+// Fields other than version and type are empty for lines that aren't SemVer.
+//
+// Binary output is native endian, and is written in row groups so that we
+// never need more than one batch of lines in memory:
+//
+//   char     magic[8]            "SVCOLS01"
+//   then for each row group:
+//   uint32_t rowCount            Zero marks the end of the file.
+//   uint32_t stringBytes
+//   uint32_t stringOffsets[rowCount + 1]
+//   char     strings[stringBytes]  Not null terminated.
+//   uint8_t  versionType[rowCount]
+//   uint32_t columns[11][rowCount] In VersionColumns order, pMajorDigits first.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerBatch.h"
+#include "SemVerExe.h"
+
+// Matches the batch size that ForEachLineBatch() uses.
+#define EXPORT_BATCH_SIZE 4096
+
+// CSV rows are built up here, and written out when it's nearly full.
+#define EXPORT_BUFFER_SIZE (64 * 1024)
+
+#define COLUMN_COUNT 11
+
+static const char _magic[8] = { 'S', 'V', 'C', 'O', 'L', 'S', '0', '1' };
+
+static const char *_csvHeader = "version,type,major,minor,patch,prerelease,prerelease_fields,meta,meta_fields\n";
+
+typedef struct
+{
+	FILE *fp;
+	bool csv;
+	bool failed;
+
+	uint8_t versionTypes[EXPORT_BATCH_SIZE];
+	uint32_t columns[COLUMN_COUNT][EXPORT_BATCH_SIZE];
+	uint32_t stringOffsets[EXPORT_BATCH_SIZE + 1];
+	VersionColumns view;
+
+	char buffer[EXPORT_BUFFER_SIZE];
+	size_t bufferUsed;
+} ExportContext;
+
+static void Flush(ExportContext *pContext)
+{
+	if (pContext->bufferUsed != fwrite(pContext->buffer, 1, pContext->bufferUsed, pContext->fp))
+	{
+		pContext->failed = true;
+	}
+
+	pContext->bufferUsed = 0;
+}
+
+static void Emit(ExportContext *pContext, const char *pChars, size_t count)
+{
+	if (count > EXPORT_BUFFER_SIZE - pContext->bufferUsed)
+	{
+		Flush(pContext);
+
+		if (count > EXPORT_BUFFER_SIZE)
+		{
+			if (count != fwrite(pChars, 1, count, pContext->fp)) pContext->failed = true;
+			return;
+		}
+	}
+
+	memcpy(pContext->buffer + pContext->bufferUsed, pChars, count);
+	pContext->bufferUsed += count;
+}
+
+static void EmitUnsigned(ExportContext *pContext, uint32_t value)
+{
+	char digits[10];
+	size_t idx = sizeof(digits);
+
+	do
+	{
+		digits[--idx] = (char)('0' + (value % 10));
+		value /= 10;
+	} while (0 != value);
+
+	Emit(pContext, digits + idx, sizeof(digits) - idx);
+}
+
+// Invalid lines can contain anything, so they're quoted, with embedded quotes
+// doubled.  SemVer strings never need it.
+static void EmitQuoted(ExportContext *pContext, const char *pChars, size_t count)
+{
+	Emit(pContext, "\"", 1);
+
+	for (const char *pQuote; NULL != (pQuote = memchr(pChars, '"', count)); )
+	{
+		size_t run = (pQuote - pChars) + 1;
+		Emit(pContext, pChars, run);
+		Emit(pContext, "\"", 1);
+		pChars += run;
+		count -= run;
+	}
+
+	Emit(pContext, pChars, count);
+	Emit(pContext, "\"", 1);
+}
+
+static void EmitCsvRows(ExportContext *pContext, char **ppLines, const size_t *pLengths, size_t count)
+{
+	const VersionColumns *pc = &pContext->view;
+
+	for (size_t row = 0; row < count; row++)
+	{
+		const char *pLine = ppLines[row];
+
+		if (eSemVer_2_0_0 != pc->pVersionType[row])
+		{
+			const char *pRest = (eUnknownVersion == pc->pVersionType[row]) ? ",unknown,,,,,,,\n" : ",none,,,,,,,\n";
+
+			EmitQuoted(pContext, pLine, pLengths[row]);
+			Emit(pContext, pRest, strlen(pRest));
+			continue;
+		}
+
+		Emit(pContext, pLine, pLengths[row]);
+		Emit(pContext, ",semver,", 8);
+		Emit(pContext, pLine, pc->pMajorDigits[row]);
+		Emit(pContext, ",", 1);
+		Emit(pContext, pLine + pc->pMinorIdx[row], pc->pMinorDigits[row]);
+		Emit(pContext, ",", 1);
+		Emit(pContext, pLine + pc->pPatchIdx[row], pc->pPatchDigits[row]);
+		Emit(pContext, ",", 1);
+		Emit(pContext, pLine + pc->pPrereleaseIdx[row], pc->pPrereleaseLength[row]);
+		Emit(pContext, ",", 1);
+		EmitUnsigned(pContext, pc->pPrereleaseFieldCount[row]);
+		Emit(pContext, ",", 1);
+		Emit(pContext, pLine + pc->pMetaIdx[row], pc->pMetaLength[row]);
+		Emit(pContext, ",", 1);
+		EmitUnsigned(pContext, pc->pMetaFieldCount[row]);
+		Emit(pContext, "\n", 1);
+	}
+}
+
+static void EmitRowGroup(ExportContext *pContext, char **ppLines, const size_t *pLengths, size_t count)
+{
+	uint32_t rowCount = (uint32_t)count;
+	uint32_t stringBytes = 0;
+
+	for (size_t row = 0; row < count; row++)
+	{
+		pContext->stringOffsets[row] = stringBytes;
+		stringBytes += (uint32_t)pLengths[row];
+	}
+
+	pContext->stringOffsets[count] = stringBytes;
+
+	Emit(pContext, (const char*)&rowCount, sizeof(rowCount));
+	Emit(pContext, (const char*)&stringBytes, sizeof(stringBytes));
+	Emit(pContext, (const char*)pContext->stringOffsets, (count + 1) * sizeof(uint32_t));
+
+	for (size_t row = 0; row < count; row++)
+	{
+		Emit(pContext, ppLines[row], pLengths[row]);
+	}
+
+	Emit(pContext, (const char*)pContext->versionTypes, count);
+
+	for (size_t column = 0; column < COLUMN_COUNT; column++)
+	{
+		Emit(pContext, (const char*)pContext->columns[column], count * sizeof(uint32_t));
+	}
+}
+
+static bool ExportBatch(char **ppLines, const size_t *pLengths, size_t count, void *pContext)
+{
+	ExportContext *pExport = pContext;
+
+	ClassifyVersionBatch((const char * const *)ppLines, pLengths, count, &pExport->view);
+
+	if (pExport->csv)
+	{
+		EmitCsvRows(pExport, ppLines, pLengths, count);
+	}
+	else
+	{
+		EmitRowGroup(pExport, ppLines, pLengths, count);
+	}
+
+	return !pExport->failed;
+}
+
+static bool EndsWith(const char *pString, const char *pSuffix)
+{
+	size_t stringLength = strlen(pString);
+	size_t suffixLength = strlen(pSuffix);
+
+	return (stringLength >= suffixLength) && (0 == strcmp(pString + stringLength - suffixLength, pSuffix));
+}
+
+int ExportColumns(const char *pInputFileName, const char *pOutputFileName)
+{
+	FILE *fpIn = OpenFile(pInputFileName, "rb");
+
+	if (NULL == fpIn)
+	{
+		printf("Failed to open '%s'.\n", pInputFileName);
+		return -2;
+	}
+
+	ExportContext *pContext = calloc(1, sizeof(ExportContext));
+
+	if (NULL == pContext)
+	{
+		printf("Out of memory.\n");
+		fclose(fpIn);
+		return -2;
+	}
+
+	pContext->fp = OpenFile(pOutputFileName, "wb");
+
+	if (NULL == pContext->fp)
+	{
+		printf("Failed to create '%s'.\n", pOutputFileName);
+		fclose(fpIn);
+		free(pContext);
+		return -2;
+	}
+
+	pContext->csv = EndsWith(pOutputFileName, ".csv") || EndsWith(pOutputFileName, ".CSV");
+
+	// The view's column order is the file's column order.
+	VersionColumns *pView = &pContext->view;
+
+	pView->pVersionType = pContext->versionTypes;
+	pView->pMajorDigits = pContext->columns[0];
+	pView->pMinorIdx = pContext->columns[1];
+	pView->pMinorDigits = pContext->columns[2];
+	pView->pPatchIdx = pContext->columns[3];
+	pView->pPatchDigits = pContext->columns[4];
+	pView->pPrereleaseIdx = pContext->columns[5];
+	pView->pPrereleaseLength = pContext->columns[6];
+	pView->pPrereleaseFieldCount = pContext->columns[7];
+	pView->pMetaIdx = pContext->columns[8];
+	pView->pMetaLength = pContext->columns[9];
+	pView->pMetaFieldCount = pContext->columns[10];
+
+	if (pContext->csv)
+	{
+		Emit(pContext, _csvHeader, strlen(_csvHeader));
+	}
+	else
+	{
+		Emit(pContext, _magic, sizeof(_magic));
+	}
+
+	bool succeeded = ForEachLineBatch(fpIn, ExportBatch, pContext);
+
+	if (!pContext->csv)
+	{
+		uint32_t endMarker = 0;
+		Emit(pContext, (const char*)&endMarker, sizeof(endMarker));
+	}
+
+	Flush(pContext);
+	succeeded &= !pContext->failed;
+
+	if (0 != fclose(pContext->fp)) succeeded = false;
+
+	fclose(fpIn);
+	free(pContext);
+
+	if (!succeeded)
+	{
+		printf("Failed to export '%s' to '%s'.\n", pInputFileName, pOutputFileName);
+		return -2;
+	}
+
+	return 0;
+}
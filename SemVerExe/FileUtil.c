@@ -0,0 +1,121 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SemVerExe.h"
+
+// ForEachLineBatch() reads this much at a time, and hands over at most this
+// many lines at a time.  The block grows if a single line won't fit in it.
+#define LINE_BLOCK_SIZE (1024 * 1024)
+#define LINE_BATCH_SIZE 4096
+
+bool ForEachLineBatch(FILE *fp, LineBatchHandler handler, void *pContext)
+{
+	size_t blockSize = LINE_BLOCK_SIZE;
+
+	// One extra byte, so we can terminate a last line that has no newline.
+	char *pBlock = malloc(blockSize + 1);
+	char **ppLines = malloc(LINE_BATCH_SIZE * sizeof(char*));
+	size_t *pLengths = malloc(LINE_BATCH_SIZE * sizeof(size_t));
+
+	bool result = (NULL != pBlock) && (NULL != ppLines) && (NULL != pLengths);
+	size_t carried = 0;
+	bool atEnd = false;
+
+	while (result && !atEnd)
+	{
+		size_t length = carried + fread(pBlock + carried, 1, blockSize - carried, fp);
+		atEnd = (length < blockSize);
+
+		if (atEnd && (0 != length) && ('\n' != pBlock[length - 1]))
+		{
+			pBlock[length++] = '\n';
+		}
+
+		char *pStart = pBlock;
+		char *pEnd = pBlock + length;
+		char *pNewline;
+		size_t count = 0;
+
+		while (result && (NULL != (pNewline = memchr(pStart, '\n', pEnd - pStart))))
+		{
+			size_t lineLength = pNewline - pStart;
+
+			if ((0 != lineLength) && ('\r' == pStart[lineLength - 1])) lineLength--;
+
+			pStart[lineLength] = '\0';
+			ppLines[count] = pStart;
+			pLengths[count] = lineLength;
+			count++;
+
+			pStart = pNewline + 1;
+
+			if (LINE_BATCH_SIZE == count)
+			{
+				result = handler(ppLines, pLengths, count, pContext);
+				count = 0;
+			}
+		}
+
+		if (result && (0 != count))
+		{
+			result = handler(ppLines, pLengths, count, pContext);
+		}
+
+		carried = pEnd - pStart;
+
+		if (carried == blockSize)
+		{
+			// A single line filled the whole block.
+			char *pBigger = realloc(pBlock, (blockSize * 2) + 1);
+
+			if (NULL == pBigger)
+			{
+				result = false;
+				break;
+			}
+
+			pBlock = pBigger;
+			blockSize *= 2;
+		}
+		else
+		{
+			memmove(pBlock, pStart, carried);
+		}
+	}
+
+	free(pBlock);
+	free(ppLines);
+	free(pLengths);
+
+	return result;
+}
+
+FILE* OpenFile(const char *pFileName, const char *pMode)
+{
+#ifdef _MSC_VER
+	FILE *fp = NULL;
+	return (0 == fopen_s(&fp, pFileName, pMode)) ? fp : NULL;
+#else
+	return fopen(pFileName, pMode);
+#endif
+}
+
+FILE* OpenTempFile(void)
+{
+#ifdef _MSC_VER
+	FILE *fp = NULL;
+	return (0 == tmpfile_s(&fp)) ? fp : NULL;
+#else
+	return tmpfile();
+#endif
+}
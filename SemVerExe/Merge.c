@@ -0,0 +1,204 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Merges files of version strings, one per line, that are each already sorted
+// by -sort (or anything else that keeps SemVer lines in precedence order, 
+// ahead of the lines that aren't SemVer), into one sorted file.
+//
+// This is the library's VersionMerger fed by one line reader per file, so 
+// memory use depends on the number of files and the longest line, not on the
+// size of the files.  Every file's order is checked as it's read, and the 
+// merge stops at the first line that's out of place.  Empty lines are skipped.
+// When collapsing, only the first of a set of versions with equal precedence
+// (that differ only in build meta data, or not at all) is kept.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerMerge.h"
+#include "SemVerExe.h"
+
+// Each input file gets a buffer this big.
+#define MERGE_INPUT_BUFFER_SIZE (64 * 1024)
+
+typedef struct
+{
+	const char *pFileName;
+	FILE *fp;
+	char *pLine;
+	size_t capacity;
+	size_t lineNumber;
+	bool failed;
+} MergeFile;
+
+// VersionSourceProc for a MergeFile.  Reads the next non-empty line, without 
+// its '\n' or '\r'.
+static bool ReadMergeLine(void *pContext, const char **ppVersion, size_t *pLength)
+{
+	MergeFile *pFile = (MergeFile*)pContext;
+
+	for (;;)
+	{
+		size_t length = 0;
+
+		for (;;)
+		{
+			if (pFile->capacity - length < 2)
+			{
+				size_t capacity = (0 == pFile->capacity) ? 256 : pFile->capacity * 2;
+				char *pBigger = realloc(pFile->pLine, capacity);
+
+				if (NULL == pBigger)
+				{
+					pFile->failed = true;
+					return false;
+				}
+
+				pFile->pLine = pBigger;
+				pFile->capacity = capacity;
+			}
+
+			if (NULL == fgets(pFile->pLine + length, (int)(pFile->capacity - length), pFile->fp))
+			{
+				if (ferror(pFile->fp)) pFile->failed = true;
+				if (0 == length) return false;
+
+				// The last line has no newline.
+				break;
+			}
+
+			length += strlen(pFile->pLine + length);
+
+			if ('\n' == pFile->pLine[length - 1]) break;
+		}
+
+		pFile->lineNumber++;
+
+		while ((0 != length) && (('\n' == pFile->pLine[length - 1]) || ('\r' == pFile->pLine[length - 1]))) length--;
+
+		if (0 != length)
+		{
+			pFile->pLine[length] = '\0';
+			*ppVersion = pFile->pLine;
+			*pLength = length;
+			return true;
+		}
+	}
+}
+
+// Merge the files into fpOut, and report what went wrong, if anything.
+static bool WriteMergedLines(MergeFile *pFiles, const VersionSource *pSources, size_t count, FILE *fpOut, const char *pOutputFileName, bool collapseMeta)
+{
+	VersionMerger *pMerger = CreateVersionMerger(pSources, count, collapseMeta);
+
+	if (NULL == pMerger)
+	{
+		printf("Out of memory.\n");
+		return false;
+	}
+
+	size_t sourceIdx = 0;
+	const char *pLine;
+	size_t length;
+	MergeStatus status;
+
+	while (eMergeVersion == (status = NextMergedVersion(pMerger, &pLine, &length, &sourceIdx)))
+	{
+		if ((length != fwrite(pLine, 1, length, fpOut)) || (EOF == fputc('\n', fpOut)))
+		{
+			printf("Failed to write '%s'.\n", pOutputFileName);
+			FreeVersionMerger(pMerger);
+			return false;
+		}
+	}
+
+	FreeVersionMerger(pMerger);
+
+	// The merger can't tell a failed read from the end of a file.
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		if (pFiles[idx].failed)
+		{
+			printf("Failed to read '%s', after line %zu.\n", pFiles[idx].pFileName, pFiles[idx].lineNumber);
+			return false;
+		}
+	}
+
+	if (eMergeOutOfOrder == status)
+	{
+		printf("'%s' isn't sorted, line %zu is out of order.\n", pFiles[sourceIdx].pFileName, pFiles[sourceIdx].lineNumber);
+		return false;
+	}
+
+	if (eMergeEnd != status)
+	{
+		printf("Out of memory.\n");
+		return false;
+	}
+
+	return true;
+}
+
+int MergeVersionFiles(const char *pOutputFileName, char **ppInputFileNames, size_t count, bool collapseMeta)
+{
+	MergeFile *pFiles = calloc(count, sizeof(MergeFile));
+	VersionSource *pSources = calloc(count, sizeof(VersionSource));
+	bool succeeded = (NULL != pFiles) && (NULL != pSources);
+
+	if (!succeeded) printf("Out of memory.\n");
+
+	for (size_t idx = 0; succeeded && (idx < count); idx++)
+	{
+		pFiles[idx].pFileName = ppInputFileNames[idx];
+		pFiles[idx].fp = OpenFile(ppInputFileNames[idx], "rb");
+
+		if (NULL == pFiles[idx].fp)
+		{
+			printf("Failed to open '%s'.\n", ppInputFileNames[idx]);
+			succeeded = false;
+			break;
+		}
+
+		setvbuf(pFiles[idx].fp, NULL, _IOFBF, MERGE_INPUT_BUFFER_SIZE);
+		pSources[idx].pNext = ReadMergeLine;
+		pSources[idx].pContext = &pFiles[idx];
+	}
+
+	FILE *fpOut = succeeded ? OpenFile(pOutputFileName, "wb") : NULL;
+
+	if (succeeded && (NULL == fpOut))
+	{
+		printf("Failed to create '%s'.\n", pOutputFileName);
+		succeeded = false;
+	}
+
+	if (succeeded)
+	{
+		succeeded = WriteMergedLines(pFiles, pSources, count, fpOut, pOutputFileName, collapseMeta);
+
+		if ((0 != fclose(fpOut)) && succeeded)
+		{
+			printf("Failed to write '%s'.\n", pOutputFileName);
+			succeeded = false;
+		}
+	}
+
+	for (size_t idx = 0; (NULL != pFiles) && (idx < count); idx++)
+	{
+		if (NULL != pFiles[idx].fp) fclose(pFiles[idx].fp);
+		free(pFiles[idx].pLine);
+	}
+
+	free(pFiles);
+	free(pSources);
+
+	return succeeded ? 0 : -2;
+}
@@ -0,0 +1,306 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Streams a file of version strings, one per line, and reports the shapes 
+// they come in: how many digits each part of the triple has, how many fields
+// the tags have and how long those are, and where the invalid ones fail.  The
+// tag array block size and the length cases in CompareFields() were sized by
+// guesswork, this is how we check the guesses against real corpora.
+//
+// Everything here is worked out from the VersionParseRecord's, so it doesn't
+// need a library built with SEMVER_STATS.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVer.h"
+#include "..\SemVerLib\SemVerStats.h"
+#include "SemVerExe.h"
+
+// Histograms count 0 through 15 exactly, and everything bigger in the last bucket.
+#define PROFILE_BUCKET_COUNT 17
+
+typedef struct
+{
+	uint64_t counts[PROFILE_BUCKET_COUNT];
+	uint64_t total;
+} Histogram;
+
+typedef struct
+{
+	uint64_t lines;
+	uint64_t emptyLines;
+	uint64_t versionTypes[eSemVer_2_0_0 + 1];
+
+	Histogram lineLength;
+	Histogram majorDigits;
+	Histogram minorDigits;
+	Histogram patchDigits;
+
+	Histogram prereleaseFields;
+	Histogram prereleaseFieldLength;
+	Histogram metaFields;
+	Histogram metaFieldLength;
+
+	// Prerelease fields, and whole prerelease tags, by kind.
+	uint64_t numericFields;
+	uint64_t alphaNumericFields;
+	uint64_t numericTags;
+	uint64_t alphaNumericTags;
+	uint64_t mixedTags;
+
+	// Tags that outgrew their first block, and how many times they grew.
+	uint64_t prereleaseOverflows;
+	uint64_t metaOverflows;
+	uint64_t tagReallocations;
+
+	// Where invalid lines stopped.  Ended means we ran out of characters in 
+	// that state, rejected means some character wasn't allowed there.
+	uint64_t endedInState[SEMVER_STATS_STATE_COUNT];
+	uint64_t rejectedInState[SEMVER_STATS_STATE_COUNT];
+} ProfileContext;
+
+static const char *_stateNames[SEMVER_STATS_STATE_COUNT] =
+{
+	"eStart",
+	"eInMajor",
+	"eInMinor",
+	"eInPatch",
+	"eInPrereleaseFirstChar",
+	"eInPrereleaseFirstFieldChar",
+	"eInPreAlphaNumericField",
+	"eInPreNumericField",
+	"eInMetaFirstChar",
+	"eInMetaField",
+	"eInLenientExtra",
+};
+
+static const char *_versionTypeNames[eSemVer_2_0_0 + 1] = { "not a version", "unknown", "SemVer 2.0.0" };
+
+static double Percent(uint64_t count, uint64_t total)
+{
+	return (0 == total) ? 0.0 : (100.0 * (double)count) / (double)total;
+}
+
+static void AddToHistogram(Histogram *pHistogram, size_t value)
+{
+	pHistogram->counts[(value < PROFILE_BUCKET_COUNT - 1) ? value : PROFILE_BUCKET_COUNT - 1]++;
+	pHistogram->total++;
+}
+
+// How many times a tag with fieldCount fields had to grow its array.
+static size_t CountReallocations(size_t fieldCount)
+{
+	return (0 == fieldCount) ? 0 : (fieldCount - 1) / VERSION_TAG_BLOCK_SIZE;
+}
+
+static void ProfileTags(ProfileContext *pContext, const VersionParseRecord *pRecord)
+{
+	if (pRecord->hasPrereleaseTag)
+	{
+		size_t numeric = 0;
+
+		for (size_t idx = 0; idx < pRecord->prereleaseFieldCount; idx++)
+		{
+			const ParsedTagRecord *pField = &pRecord->pPrereleaseData[idx];
+
+			AddToHistogram(&pContext->prereleaseFieldLength, pField->fieldLength);
+			numeric += ('N' == pField->fieldType);
+		}
+
+		AddToHistogram(&pContext->prereleaseFields, pRecord->prereleaseFieldCount);
+		pContext->numericFields += numeric;
+		pContext->alphaNumericFields += pRecord->prereleaseFieldCount - numeric;
+
+		if (numeric == pRecord->prereleaseFieldCount)
+		{
+			pContext->numericTags++;
+		}
+		else if (0 == numeric)
+		{
+			pContext->alphaNumericTags++;
+		}
+		else
+		{
+			pContext->mixedTags++;
+		}
+
+		pContext->prereleaseOverflows += (pRecord->prereleaseFieldCount > VERSION_TAG_BLOCK_SIZE);
+		pContext->tagReallocations += CountReallocations(pRecord->prereleaseFieldCount);
+	}
+
+	if (pRecord->hasMetaTag)
+	{
+		for (size_t idx = 0; idx < pRecord->metaFieldCount; idx++)
+		{
+			AddToHistogram(&pContext->metaFieldLength, pRecord->pMetaData[idx].fieldLength);
+		}
+
+		AddToHistogram(&pContext->metaFields, pRecord->metaFieldCount);
+		pContext->metaOverflows += (pRecord->metaFieldCount > VERSION_TAG_BLOCK_SIZE);
+		pContext->tagReallocations += CountReallocations(pRecord->metaFieldCount);
+	}
+}
+
+static bool ProfileBatch(char **ppLines, const size_t *pLengths, size_t count, void *pContextArg)
+{
+	ProfileContext *pContext = pContextArg;
+	VersionParseRecord record;
+
+	for (size_t row = 0; row < count; row++)
+	{
+		size_t length = pLengths[row];
+
+		pContext->lines++;
+
+		if (0 == length)
+		{
+			pContext->emptyLines++;
+			continue;
+		}
+
+		AddToHistogram(&pContext->lineLength, length);
+		ClassifyVersionCandidateN(ppLines[row], length, &record);
+		pContext->versionTypes[record.versionType]++;
+
+		if (eSemVer_2_0_0 == record.versionType)
+		{
+			AddToHistogram(&pContext->majorDigits, record.majorDigits);
+			AddToHistogram(&pContext->minorDigits, record.minorDigits);
+			AddToHistogram(&pContext->patchDigits, record.patchDigits);
+			ProfileTags(pContext, &record);
+		}
+		else if (record.parsedIdx >= length)
+		{
+			pContext->endedInState[record.state]++;
+		}
+		else
+		{
+			pContext->rejectedInState[record.state]++;
+		}
+
+		FreeVersionParseData(&record);
+	}
+
+	return true;
+}
+
+static void PrintHistogram(const char *pTitle, const Histogram *pHistogram)
+{
+	uint64_t cumulative = 0;
+
+	printf("\n%s (%llu)\n", pTitle, (unsigned long long)pHistogram->total);
+
+	if (0 == pHistogram->total) return;
+
+	printf("  %5s %14s %8s %8s\n", "value", "count", "%", "cum %");
+
+	for (size_t idx = 0; idx < PROFILE_BUCKET_COUNT; idx++)
+	{
+		uint64_t count = pHistogram->counts[idx];
+
+		if (0 == count) continue;
+
+		cumulative += count;
+		printf("  %4zu%s %14llu %8.3f %8.3f\n", idx, (idx == PROFILE_BUCKET_COUNT - 1) ? "+" : " ",
+			(unsigned long long)count, Percent(count, pHistogram->total), Percent(cumulative, pHistogram->total));
+	}
+}
+
+static void PrintProfile(const char *pInputFileName, const ProfileContext *pContext)
+{
+	uint64_t semVerCount = pContext->versionTypes[eSemVer_2_0_0];
+	uint64_t tagCount = pContext->numericTags + pContext->alphaNumericTags + pContext->mixedTags;
+	uint64_t fieldCount = pContext->numericFields + pContext->alphaNumericFields;
+	uint64_t invalidCount = pContext->lines - pContext->emptyLines - semVerCount;
+
+	printf("Profile of '%s': %llu lines, %llu empty\n", pInputFileName, (unsigned long long)pContext->lines, (unsigned long long)pContext->emptyLines);
+
+	for (int type = eNotVersion; type <= eSemVer_2_0_0; type++)
+	{
+		printf("  %-14s %14llu %8.3f%%\n", _versionTypeNames[type], (unsigned long long)pContext->versionTypes[type],
+			Percent(pContext->versionTypes[type], pContext->lines - pContext->emptyLines));
+	}
+
+	PrintHistogram("Line length", &pContext->lineLength);
+	PrintHistogram("Major digits", &pContext->majorDigits);
+	PrintHistogram("Minor digits", &pContext->minorDigits);
+	PrintHistogram("Patch digits", &pContext->patchDigits);
+	PrintHistogram("Prerelease fields per tag", &pContext->prereleaseFields);
+	PrintHistogram("Prerelease field length", &pContext->prereleaseFieldLength);
+	PrintHistogram("Meta fields per tag", &pContext->metaFields);
+	PrintHistogram("Meta field length", &pContext->metaFieldLength);
+
+	printf("\nPrerelease field kinds\n");
+	printf("  numeric fields         %14llu %8.3f%%\n", (unsigned long long)pContext->numericFields, Percent(pContext->numericFields, fieldCount));
+	printf("  alphanumeric fields    %14llu %8.3f%%\n", (unsigned long long)pContext->alphaNumericFields, Percent(pContext->alphaNumericFields, fieldCount));
+	printf("  all numeric tags       %14llu %8.3f%%\n", (unsigned long long)pContext->numericTags, Percent(pContext->numericTags, tagCount));
+	printf("  all alphanumeric tags  %14llu %8.3f%%\n", (unsigned long long)pContext->alphaNumericTags, Percent(pContext->alphaNumericTags, tagCount));
+	printf("  mixed tags             %14llu %8.3f%%\n", (unsigned long long)pContext->mixedTags, Percent(pContext->mixedTags, tagCount));
+
+	printf("\nTag arrays, in blocks of %d fields\n", VERSION_TAG_BLOCK_SIZE);
+	printf("  prerelease overflows   %14llu %8.3f%% of SemVer\n", (unsigned long long)pContext->prereleaseOverflows, Percent(pContext->prereleaseOverflows, semVerCount));
+	printf("  meta overflows         %14llu %8.3f%% of SemVer\n", (unsigned long long)pContext->metaOverflows, Percent(pContext->metaOverflows, semVerCount));
+	printf("  reallocations          %14llu\n", (unsigned long long)pContext->tagReallocations);
+
+	printf("\nWhere invalid lines stopped (%llu)\n", (unsigned long long)invalidCount);
+
+	if (0 == invalidCount) return;
+
+	printf("  %-28s %14s %14s %8s\n", "state", "ended", "rejected", "%");
+
+	for (int state = eStart; state < SEMVER_STATS_STATE_COUNT; state++)
+	{
+		uint64_t count = pContext->endedInState[state] + pContext->rejectedInState[state];
+
+		if (0 == count) continue;
+
+		printf("  %-28s %14llu %14llu %8.3f\n", _stateNames[state], (unsigned long long)pContext->endedInState[state],
+			(unsigned long long)pContext->rejectedInState[state], Percent(count, invalidCount));
+	}
+}
+
+int ProfileVersionFile(const char *pInputFileName)
+{
+	FILE *fp = OpenFile(pInputFileName, "rb");
+
+	if (NULL == fp)
+	{
+		printf("Failed to open '%s'.\n", pInputFileName);
+		return -2;
+	}
+
+	ProfileContext *pContext = calloc(1, sizeof(ProfileContext));
+
+	if (NULL == pContext)
+	{
+		printf("Out of memory.\n");
+		fclose(fp);
+		return -2;
+	}
+
+	bool succeeded = ForEachLineBatch(fp, ProfileBatch, pContext);
+
+	fclose(fp);
+
+	if (succeeded)
+	{
+		PrintProfile(pInputFileName, pContext);
+	}
+	else
+	{
+		printf("Failed to read '%s'.\n", pInputFileName);
+	}
+
+	free(pContext);
+
+	return succeeded ? 0 : -2;
+}
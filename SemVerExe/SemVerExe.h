@@ -0,0 +1,41 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerExe_h_Defined
+#define _SharperHacks_SemVerExe_h_Defined
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Called by ForEachLineBatch() for each batch of lines read from a file.  
+// Lines are null terminated in place, and pLengths excludes the terminator and
+// any trailing '\r'.  The lines are only valid for the duration of the call.
+// Return false to stop reading.
+typedef bool (*LineBatchHandler)(char **ppLines, const size_t *pLengths, size_t count, void *pContext);
+
+// Reads fp a block at a time, and hands complete lines to handler in batches.
+// Returns false if handler asked us to stop, or we ran out of memory.
+bool ForEachLineBatch(FILE *fp, LineBatchHandler handler, void *pContext);
+
+// fopen() that keeps the VS SDL checks happy.
+FILE* OpenFile(const char *pFileName, const char *pMode);
+
+// A binary read/write temp file, that's deleted when it's closed.
+FILE* OpenTempFile(void);
+
+// Modes that live in their own source files.  Each returns the exit code.
+
+int ExportColumns(const char *pInputFileName, const char *pOutputFileName);
+int MergeVersionFiles(const char *pOutputFileName, char **ppInputFileNames, size_t count, bool collapseMeta);
+int ProfileVersionFile(const char *pInputFileName);
+int SortVersionFile(const char *pInputFileName, const char *pOutputFileName, size_t memoryBudget, bool collapseMeta);
+
+#endif
@@ -0,0 +1,624 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// Sorts a file of version strings, one per line, in SemVer precedence order.
+//
+// Lines are collected until they use up the memory budget, then sorted and
+// written out as a run.  If the whole file fits in one run, it goes straight 
+// to the output file.  Otherwise every run is spilled to a temp file.  The runs
+// are k-way merged into the output file.  Runs are merged a level at a time:
+// whenever the newest SORT_MERGE_FAN_IN runs are all from the same level, they
+// are merged into one run on the next level up, so each line is only rewritten
+// once per level.
+//
+// SemVer lines sort by CompareVersions(), and lines it says are equal are 
+// ordered by their bytes, so the output doesn't depend on the input order.
+// Lines that aren't SemVer follow all the SemVer lines, in byte order.  Empty
+// lines are dropped, and so are duplicates.  When collapsing, only the first
+// of a set of versions that differ only in build meta data is kept.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVer.h"
+#include "SemVerExe.h"
+
+// Lines are copied into blocks of a sixteenth of the memory budget, within 
+// these limits.  One long line may make a block bigger.
+#define SORT_MIN_ARENA_BLOCK_SIZE (4 * 1024)
+#define SORT_MAX_ARENA_BLOCK_SIZE (1024 * 1024)
+
+// Never merge more than this many runs at once.
+#define SORT_MERGE_FAN_IN 64
+
+// Each open run gets a buffer of a quarter of the memory budget divided by the
+// fan in, within these limits.  Run buffers count against the budget.
+#define SORT_MIN_RUN_BUFFER_SIZE (4 * 1024)
+#define SORT_MAX_RUN_BUFFER_SIZE (1024 * 1024)
+
+typedef struct
+{
+	const char *pLine;
+	size_t length;
+	VersionParseRecord record;
+} SortLine;
+
+typedef struct
+{
+	FILE *fp;
+	size_t level;
+} SortRun;
+
+typedef enum
+{
+	eRunLine,
+	eRunEnd,
+	eRunFailed
+} RunReadStatus;
+
+typedef struct
+{
+	char *pLine;
+	size_t length;
+	size_t capacity;
+	VersionParseRecord record;
+	FILE *fp;
+} RunReader;
+
+// Writes sorted lines, dropping duplicates.
+typedef struct
+{
+	FILE *fp;
+	bool collapseMeta;
+	bool failed;
+
+	char *pLast;
+	size_t lastLength;
+	size_t lastCapacity;
+	bool hasLast;
+	VersionParseRecord lastRecord;
+} SortWriter;
+
+typedef struct
+{
+	size_t budget;
+	size_t used;
+	size_t arenaBlockSize;
+	size_t runBufferSize;
+	bool collapseMeta;
+	bool failed;
+
+	// Text of the lines in the current run.
+	char **ppBlocks;
+	size_t blockCount;
+	size_t blockCapacity;
+	size_t blockUsed;
+	size_t blockSize;
+
+	SortLine *pLines;
+	size_t lineCount;
+	size_t lineCapacity;
+
+	// Runs that have been spilled to temp files, oldest first.  The levels 
+	// never go up from one run to the next.
+	SortRun *pRuns;
+	size_t runCount;
+	size_t runCapacity;
+} SortContext;
+
+static int CompareSortLines(const char *pLine1, size_t length1, const VersionParseRecord *pRecord1, const char *pLine2, size_t length2, const VersionParseRecord *pRecord2)
+{
+	bool isSemVer1 = (eSemVer_2_0_0 == pRecord1->versionType);
+	bool isSemVer2 = (eSemVer_2_0_0 == pRecord2->versionType);
+
+	if (isSemVer1 != isSemVer2) return isSemVer1 ? -1 : 1;
+
+	if (isSemVer1)
+	{
+		int result = CompareVersions(pLine1, pRecord1, pLine2, pRecord2);
+
+		if (0 != result) return result;
+	}
+
+	int result = memcmp(pLine1, pLine2, (length1 < length2) ? length1 : length2);
+
+	if (0 != result) return (result < 0) ? -1 : 1;
+	if (length1 != length2) return (length1 < length2) ? -1 : 1;
+
+	return 0;
+}
+
+static int CompareSortLineEntries(const void *p1, const void *p2)
+{
+	const SortLine *pLine1 = (const SortLine*)p1;
+	const SortLine *pLine2 = (const SortLine*)p2;
+
+	return CompareSortLines(pLine1->pLine, pLine1->length, &pLine1->record, pLine2->pLine, pLine2->length, &pLine2->record);
+}
+
+// Reads the next line of a run into pReader, and classifies it.
+static RunReadStatus ReadRunLine(RunReader *pReader)
+{
+	FreeVersionParseData(&pReader->record);
+	pReader->length = 0;
+
+	for (;;)
+	{
+		if (pReader->capacity - pReader->length < 2)
+		{
+			size_t capacity = (0 == pReader->capacity) ? 256 : pReader->capacity * 2;
+			char *pBigger = realloc(pReader->pLine, capacity);
+
+			if (NULL == pBigger) return eRunFailed;
+
+			pReader->pLine = pBigger;
+			pReader->capacity = capacity;
+		}
+
+		if (NULL == fgets(pReader->pLine + pReader->length, (int)(pReader->capacity - pReader->length), pReader->fp))
+		{
+			// Runs always end with a newline, so anything left over means the
+			// run is damaged.
+			return (ferror(pReader->fp) || (0 != pReader->length)) ? eRunFailed : eRunEnd;
+		}
+
+		pReader->length += strlen(pReader->pLine + pReader->length);
+
+		if ('\n' == pReader->pLine[pReader->length - 1])
+		{
+			pReader->pLine[--pReader->length] = '\0';
+			ClassifyVersionCandidateN(pReader->pLine, pReader->length, &pReader->record);
+			return eRunLine;
+		}
+	}
+}
+
+static bool ReaderLess(const RunReader *pReader1, const RunReader *pReader2)
+{
+	return CompareSortLines(pReader1->pLine, pReader1->length, &pReader1->record, pReader2->pLine, pReader2->length, &pReader2->record) < 0;
+}
+
+// Restore the min-heap property below idx.
+static void SiftDown(RunReader **ppHeap, size_t count, size_t idx)
+{
+	for (;;)
+	{
+		size_t smallest = idx;
+		size_t left = (2 * idx) + 1;
+		size_t right = left + 1;
+
+		if ((left < count) && ReaderLess(ppHeap[left], ppHeap[smallest])) smallest = left;
+		if ((right < count) && ReaderLess(ppHeap[right], ppHeap[smallest])) smallest = right;
+
+		if (smallest == idx) return;
+
+		RunReader *pSwap = ppHeap[idx];
+		ppHeap[idx] = ppHeap[smallest];
+		ppHeap[smallest] = pSwap;
+		idx = smallest;
+	}
+}
+
+// Write a line, unless it duplicates the last one.  A line that's written 
+// takes over pRecord's tag records, leaving it empty.
+static void WriteSortedLine(SortWriter *pWriter, const char *pLine, size_t length, VersionParseRecord *pRecord)
+{
+	if (pWriter->hasLast)
+	{
+		if ((length == pWriter->lastLength) && (0 == memcmp(pLine, pWriter->pLast, length))) return;
+
+		if (pWriter->collapseMeta && (eSemVer_2_0_0 == pRecord->versionType)
+			&& (0 == CompareVersions(pWriter->pLast, &pWriter->lastRecord, pLine, pRecord)))
+		{
+			return;
+		}
+	}
+
+	if (length + 1 > pWriter->lastCapacity)
+	{
+		char *pBigger = realloc(pWriter->pLast, length + 1);
+
+		if (NULL == pBigger)
+		{
+			pWriter->failed = true;
+			return;
+		}
+
+		pWriter->pLast = pBigger;
+		pWriter->lastCapacity = length + 1;
+	}
+
+	memcpy(pWriter->pLast, pLine, length);
+	pWriter->pLast[length] = '\0';
+	pWriter->lastLength = length;
+	pWriter->hasLast = true;
+
+	// The record's offsets hold for the copy too.
+	FreeVersionParseData(&pWriter->lastRecord);
+	pWriter->lastRecord = *pRecord;
+	memset(pRecord, 0, sizeof(*pRecord));
+
+	if ((length != fwrite(pLine, 1, length, pWriter->fp)) || (EOF == fputc('\n', pWriter->fp)))
+	{
+		pWriter->failed = true;
+	}
+}
+
+static void FreeSortWriter(SortWriter *pWriter)
+{
+	FreeVersionParseData(&pWriter->lastRecord);
+	free(pWriter->pLast);
+}
+
+static void InitSortWriter(SortWriter *pWriter, FILE *fp, bool collapseMeta)
+{
+	memset(pWriter, 0, sizeof(*pWriter));
+	pWriter->fp = fp;
+	pWriter->collapseMeta = collapseMeta;
+}
+
+// Merge count runs into fp.  The runs are closed, whether or not we succeed.
+static bool MergeRuns(SortRun *pRuns, size_t count, FILE *fp, bool collapseMeta)
+{
+	RunReader *pReaders = calloc(count, sizeof(RunReader));
+	RunReader **ppHeap = calloc(count, sizeof(RunReader*));
+	SortWriter writer;
+	size_t heapCount = 0;
+	bool result = (NULL != pReaders) && (NULL != ppHeap);
+
+	InitSortWriter(&writer, fp, collapseMeta);
+
+	for (size_t idx = 0; result && (idx < count); idx++)
+	{
+		pReaders[idx].fp = pRuns[idx].fp;
+		rewind(pRuns[idx].fp);
+
+		RunReadStatus status = ReadRunLine(&pReaders[idx]);
+
+		if (eRunLine == status) ppHeap[heapCount++] = &pReaders[idx];
+		if (eRunFailed == status) result = false;
+	}
+
+	for (size_t idx = heapCount / 2; result && (idx-- > 0); )
+	{
+		SiftDown(ppHeap, heapCount, idx);
+	}
+
+	while (result && (0 != heapCount) && !writer.failed)
+	{
+		RunReader *pNext = ppHeap[0];
+
+		WriteSortedLine(&writer, pNext->pLine, pNext->length, &pNext->record);
+
+		RunReadStatus status = ReadRunLine(pNext);
+
+		if (eRunFailed == status)
+		{
+			result = false;
+		}
+		else if (eRunEnd == status)
+		{
+			ppHeap[0] = ppHeap[--heapCount];
+		}
+
+		SiftDown(ppHeap, heapCount, 0);
+	}
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		if (NULL != pReaders)
+		{
+			FreeVersionParseData(&pReaders[idx].record);
+			free(pReaders[idx].pLine);
+		}
+
+		fclose(pRuns[idx].fp);
+	}
+
+	free(pReaders);
+	free(ppHeap);
+	FreeSortWriter(&writer);
+
+	return result && !writer.failed;
+}
+
+static FILE* OpenRun(SortContext *pContext)
+{
+	FILE *fp = OpenTempFile();
+
+	if (NULL != fp) setvbuf(fp, NULL, _IOFBF, pContext->runBufferSize);
+
+	return fp;
+}
+
+// Merge the newest count runs into one, a level above the oldest of them.
+static bool MergeNewestRuns(SortContext *pContext, size_t count)
+{
+	FILE *fpMerged = OpenRun(pContext);
+
+	if (NULL == fpMerged) return false;
+
+	SortRun *pFirst = &pContext->pRuns[pContext->runCount - count];
+	size_t level = pFirst->level + 1;
+	bool merged = MergeRuns(pFirst, count, fpMerged, pContext->collapseMeta) && (0 == fflush(fpMerged));
+
+	// The merged runs are closed, whether or not that worked.
+	pFirst->fp = fpMerged;
+	pFirst->level = level;
+	pContext->runCount -= count - 1;
+	pContext->used -= (count - 1) * pContext->runBufferSize;
+
+	return merged;
+}
+
+// Merge the newest SORT_MERGE_FAN_IN runs for as long as they're all from the
+// same level.
+static bool ReduceRuns(SortContext *pContext)
+{
+	while ((pContext->runCount >= SORT_MERGE_FAN_IN)
+		&& (pContext->pRuns[pContext->runCount - SORT_MERGE_FAN_IN].level == pContext->pRuns[pContext->runCount - 1].level))
+	{
+		if (!MergeNewestRuns(pContext, SORT_MERGE_FAN_IN)) return false;
+	}
+
+	return true;
+}
+
+// Sort the lines we're holding, and write them to fp.  Leaves the context empty.
+static bool WriteRun(SortContext *pContext, FILE *fp)
+{
+	SortWriter writer;
+
+	InitSortWriter(&writer, fp, pContext->collapseMeta);
+
+	qsort(pContext->pLines, pContext->lineCount, sizeof(SortLine), CompareSortLineEntries);
+
+	for (size_t idx = 0; idx < pContext->lineCount; idx++)
+	{
+		SortLine *pLine = &pContext->pLines[idx];
+
+		if (!writer.failed) WriteSortedLine(&writer, pLine->pLine, pLine->length, &pLine->record);
+
+		FreeVersionParseData(&pLine->record);
+	}
+
+	FreeSortWriter(&writer);
+
+	for (size_t idx = 0; idx < pContext->blockCount; idx++)
+	{
+		free(pContext->ppBlocks[idx]);
+	}
+
+	// The line array is kept for the next run.
+	pContext->blockCount = 0;
+	pContext->lineCount = 0;
+	pContext->used = (pContext->lineCapacity * sizeof(SortLine)) + (pContext->runCount * pContext->runBufferSize);
+
+	return !writer.failed;
+}
+
+// Sort the lines we're holding, and spill them to a new temp file.
+static bool SpillRun(SortContext *pContext)
+{
+	if (pContext->runCount == pContext->runCapacity)
+	{
+		size_t capacity = (0 == pContext->runCapacity) ? 16 : pContext->runCapacity * 2;
+		SortRun *pBigger = realloc(pContext->pRuns, capacity * sizeof(SortRun));
+
+		if (NULL == pBigger) return false;
+
+		pContext->pRuns = pBigger;
+		pContext->runCapacity = capacity;
+	}
+
+	FILE *fp = OpenRun(pContext);
+
+	if (NULL == fp) return false;
+
+	pContext->pRuns[pContext->runCount].fp = fp;
+	pContext->pRuns[pContext->runCount].level = 0;
+	pContext->runCount++;
+
+	return WriteRun(pContext, fp) && (0 == fflush(fp)) && ReduceRuns(pContext);
+}
+
+// Copy a line into the current run's text blocks.
+static char* StoreLine(SortContext *pContext, const char *pLine, size_t length)
+{
+	if ((0 == pContext->blockCount) || (length + 1 > pContext->blockSize - pContext->blockUsed))
+	{
+		if (pContext->blockCount == pContext->blockCapacity)
+		{
+			size_t capacity = (0 == pContext->blockCapacity) ? 16 : pContext->blockCapacity * 2;
+			char **ppBigger = realloc(pContext->ppBlocks, capacity * sizeof(char*));
+
+			if (NULL == ppBigger) return NULL;
+
+			pContext->ppBlocks = ppBigger;
+			pContext->blockCapacity = capacity;
+		}
+
+		size_t blockSize = (length + 1 > pContext->arenaBlockSize) ? length + 1 : pContext->arenaBlockSize;
+		char *pBlock = malloc(blockSize);
+
+		if (NULL == pBlock) return NULL;
+
+		pContext->ppBlocks[pContext->blockCount++] = pBlock;
+		pContext->blockSize = blockSize;
+		pContext->blockUsed = 0;
+		pContext->used += blockSize;
+	}
+
+	char *pStored = pContext->ppBlocks[pContext->blockCount - 1] + pContext->blockUsed;
+
+	memcpy(pStored, pLine, length);
+	pStored[length] = '\0';
+	pContext->blockUsed += length + 1;
+
+	return pStored;
+}
+
+static bool SortBatch(char **ppLines, const size_t *pLengths, size_t count, void *pContextArg)
+{
+	SortContext *pContext = (SortContext*)pContextArg;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		if (0 == pLengths[idx]) continue;
+
+		// Growing the line array counts too.
+		bool isFull = (pContext->used >= pContext->budget)
+			|| ((pContext->lineCount == pContext->lineCapacity) && (pContext->used + (pContext->lineCapacity * sizeof(SortLine)) > pContext->budget));
+
+		if (isFull && (0 != pContext->lineCount) && !SpillRun(pContext))
+		{
+			pContext->failed = true;
+			return false;
+		}
+
+		if (pContext->lineCount == pContext->lineCapacity)
+		{
+			size_t capacity = (0 == pContext->lineCapacity) ? 4096 : pContext->lineCapacity * 2;
+			SortLine *pBigger = realloc(pContext->pLines, capacity * sizeof(SortLine));
+
+			if (NULL == pBigger)
+			{
+				pContext->failed = true;
+				return false;
+			}
+
+			pContext->used += (capacity - pContext->lineCapacity) * sizeof(SortLine);
+			pContext->pLines = pBigger;
+			pContext->lineCapacity = capacity;
+		}
+
+		SortLine *pLine = &pContext->pLines[pContext->lineCount];
+
+		pLine->pLine = StoreLine(pContext, ppLines[idx], pLengths[idx]);
+
+		if (NULL == pLine->pLine)
+		{
+			pContext->failed = true;
+			return false;
+		}
+
+		pLine->length = pLengths[idx];
+		ClassifyVersionCandidateN(pLine->pLine, pLine->length, &pLine->record);
+		pContext->lineCount++;
+
+		// Tag records are allocated a block at a time.
+		size_t tagBlocks = ((pLine->record.prereleaseFieldCount + VERSION_TAG_BLOCK_SIZE - 1) / VERSION_TAG_BLOCK_SIZE)
+			+ ((pLine->record.metaFieldCount + VERSION_TAG_BLOCK_SIZE - 1) / VERSION_TAG_BLOCK_SIZE);
+
+		pContext->used += tagBlocks * VERSION_TAG_BLOCK_SIZE * sizeof(ParsedTagRecord);
+	}
+
+	return true;
+}
+
+static void FreeSortContext(SortContext *pContext)
+{
+	for (size_t idx = 0; idx < pContext->lineCount; idx++)
+	{
+		FreeVersionParseData(&pContext->pLines[idx].record);
+	}
+
+	for (size_t idx = 0; idx < pContext->blockCount; idx++)
+	{
+		free(pContext->ppBlocks[idx]);
+	}
+
+	for (size_t idx = 0; idx < pContext->runCount; idx++)
+	{
+		fclose(pContext->pRuns[idx].fp);
+	}
+
+	free(pContext->ppBlocks);
+	free(pContext->pLines);
+	free(pContext->pRuns);
+}
+
+int SortVersionFile(const char *pInputFileName, const char *pOutputFileName, size_t memoryBudget, bool collapseMeta)
+{
+	FILE *fpIn = OpenFile(pInputFileName, "rb");
+
+	if (NULL == fpIn)
+	{
+		printf("Failed to open '%s'.\n", pInputFileName);
+		return -2;
+	}
+
+	SortContext context;
+	memset(&context, 0, sizeof(context));
+	context.budget = memoryBudget;
+	context.collapseMeta = collapseMeta;
+	context.arenaBlockSize = memoryBudget / 16;
+
+	if (context.arenaBlockSize < SORT_MIN_ARENA_BLOCK_SIZE) context.arenaBlockSize = SORT_MIN_ARENA_BLOCK_SIZE;
+	if (context.arenaBlockSize > SORT_MAX_ARENA_BLOCK_SIZE) context.arenaBlockSize = SORT_MAX_ARENA_BLOCK_SIZE;
+
+	context.runBufferSize = memoryBudget / (4 * SORT_MERGE_FAN_IN);
+
+	if (context.runBufferSize < SORT_MIN_RUN_BUFFER_SIZE) context.runBufferSize = SORT_MIN_RUN_BUFFER_SIZE;
+	if (context.runBufferSize > SORT_MAX_RUN_BUFFER_SIZE) context.runBufferSize = SORT_MAX_RUN_BUFFER_SIZE;
+
+	bool succeeded = ForEachLineBatch(fpIn, SortBatch, &context) && !context.failed;
+	fclose(fpIn);
+
+	// Anything that's already spilled has to be merged, so spill the rest too.
+	if (succeeded && (0 != context.runCount) && (0 != context.lineCount))
+	{
+		succeeded = SpillRun(&context);
+	}
+
+	// Merge the smallest runs until the rest can be merged in one go.
+	while (succeeded && (context.runCount > SORT_MERGE_FAN_IN))
+	{
+		size_t excess = context.runCount - SORT_MERGE_FAN_IN + 1;
+
+		succeeded = MergeNewestRuns(&context, (excess < SORT_MERGE_FAN_IN) ? excess : SORT_MERGE_FAN_IN);
+	}
+
+	FILE *fpOut = succeeded ? OpenFile(pOutputFileName, "wb") : NULL;
+
+	if (succeeded && (NULL == fpOut))
+	{
+		printf("Failed to create '%s'.\n", pOutputFileName);
+		FreeSortContext(&context);
+		return -2;
+	}
+
+	if (succeeded)
+	{
+		if (0 == context.runCount)
+		{
+			succeeded = WriteRun(&context, fpOut);
+		}
+		else
+		{
+			setvbuf(fpOut, NULL, _IOFBF, context.runBufferSize);
+			succeeded = MergeRuns(context.pRuns, context.runCount, fpOut, collapseMeta);
+			context.runCount = 0;
+		}
+
+		if (0 != fclose(fpOut)) succeeded = false;
+	}
+
+	FreeSortContext(&context);
+
+	if (!succeeded)
+	{
+		printf("Failed to sort '%s', out of memory or temp file space.\n", pInputFileName);
+		return -2;
+	}
+
+	return 0;
+}
@@ -12,11 +12,24 @@
 // possible to fix it.
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "..\SemVerLib\SemVer.h"
+#include "..\SemVerLib\SemVerScan.h"
+#include "SemVerExe.h"
+
+// Scan() reads files a block at a time, and reports matches in batches.
+#define SCAN_BLOCK_SIZE (1024 * 1024)
+#define SCAN_BATCH_SIZE 1024
+
+// Merge() opens at most this many files at once.
+#define MERGE_MAX_FILES 256
+
+// Sort() uses this much memory, unless told otherwise.
+#define SORT_DEFAULT_BUDGET_MB 256
 
 static const char *_usage = 
 	"SemVer -option [arg ...]\n" \
@@ -31,6 +44,31 @@ static const char *_usage =
 	"      Outputs 'candidate1 < candidate2' and returns -1, if 1 < 2.\n" \
 	"      Outputs 'candidate1 == candidate2' and returns 0, if 1 == 2.\n" \
 	"      Outputs 'No semver: candidate' and returns -2, if either not SemVer.\n" \
+	"    -s | -scan <file>\n" \
+	"      Outputs '<offset> <version>' for every SemVer string embedded in file.\n" \
+	"      Returns 0, or -2 if the file can't be read.\n" \
+	"    -e | -export <versionFile> <outputFile>\n" \
+	"      Splits each line of versionFile into columns, and writes them to\n" \
+	"      outputFile.  CSV if outputFile ends with .csv, binary otherwise.\n" \
+	"      Returns 0, or -2 on I/O errors.\n" \
+	"    -p | -profile <versionFile>\n" \
+	"      Reports histograms of the shapes of the versions in versionFile, one\n" \
+	"      per line: digits in each part of the triple, tag field counts and\n" \
+	"      lengths, numeric and alphanumeric prerelease fields, tag arrays that\n" \
+	"      had to grow, and the parse state where invalid lines failed.\n" \
+	"      Returns 0, or -2 if the file can't be read.\n" \
+	"    -sort | -sortmeta <versionFile> <outputFile> [memoryMB]\n" \
+	"      Sorts the lines of versionFile by SemVer precedence, dropping\n" \
+	"      duplicates, and writes them to outputFile.  Lines that aren't SemVer\n" \
+	"      go last.  -sortmeta also keeps only the first of any versions that\n" \
+	"      differ only in build meta data.  Files bigger than memoryMB (default\n" \
+	"      256) are sorted in runs, using temp files.\n" \
+	"      Returns 0, or -2 on I/O errors.\n" \
+	"    -merge | -mergemeta <outputFile> <sortedFile> [sortedFile ...]\n" \
+	"      Merges up to 256 files that are already sorted, as by -sort, into\n" \
+	"      outputFile, checking the order of each as it goes.  -mergemeta also\n" \
+	"      keeps only the first of any versions that are equal in precedence.\n" \
+	"      Returns 0, or -2 if a file isn't sorted, or on I/O errors.\n" \
 	"\n";
 
 static const char _hyphen = '-';
@@ -44,8 +82,15 @@ static int _handlerIdx = 0;
 typedef int (*ArgHandler)(void);
 
 static int Compare(void);
+static int Export(void);
 static int Help(void);
+static int Merge(void);
+static int MergeMeta(void);
 static bool ParseArg(int idx);
+static int Profile(void);
+static int Scan(void);
+static int Sort(void);
+static int SortMeta(void);
 static int Validate(void);
 
 
@@ -53,12 +98,23 @@ static struct {
 	char *ptoken;
 	ArgHandler handler;
 	int argCount;
+	int optionalArgCount;
 } _argHandlers[] = 
 {
 	{{"v"}, Validate, 1},
 	{{"c"}, Compare, 2},
+	{{"s"}, Scan, 1},
+	{{"e"}, Export, 2},
+	{{"p"}, Profile, 1},
 	{{"validate"}, Validate, 1},
 	{{"compare"}, Compare, 2},
+	{{"scan"}, Scan, 1},
+	{{"export"}, Export, 2},
+	{{"profile"}, Profile, 1},
+	{{"sort"}, Sort, 2, 1},
+	{{"sortmeta"}, SortMeta, 2, 1},
+	{{"merge"}, Merge, 2, MERGE_MAX_FILES - 1},
+	{{"mergemeta"}, MergeMeta, 2, MERGE_MAX_FILES - 1},
 	{{"?"}, Help, 0},
 	{{"h"}, Help, 0},
 	{{"help"}, Help, 0},
@@ -102,6 +158,11 @@ static int Compare(void)
 	return result;
 }
 
+static int Export(void)
+{
+	return ExportColumns(_argv[_argIdx + 1], _argv[_argIdx + 2]);
+}
+
 static bool HandleArgs(int argc, char **argv)
 {
 	if (argc < 1) return false;
@@ -126,7 +187,7 @@ static int Help(void)
 
 static int MatchArg(char *token)
 {
-	for (int idx = 0; idx < sizeof _argHandlers; idx++)
+	for (int idx = 0; idx < (int)(sizeof _argHandlers / sizeof _argHandlers[0]); idx++)
 	{
 		if (0 == strcmp(token, _argHandlers[idx].ptoken))
 		{
@@ -137,6 +198,16 @@ static int MatchArg(char *token)
 	return -1;
 }
 
+static int Merge(void)
+{
+	return MergeVersionFiles(_argv[_argIdx + 1], &_argv[_argIdx + 2], _argc - _argIdx - 2, false);
+}
+
+static int MergeMeta(void)
+{
+	return MergeVersionFiles(_argv[_argIdx + 1], &_argv[_argIdx + 2], _argc - _argIdx - 2, true);
+}
+
 static bool ParseArg(int idx)
 {
 	char *arg = _argv[idx];
@@ -147,7 +218,8 @@ static bool ParseArg(int idx)
 		if (-1 != matchedIdx)
 		{
 			int optionArgsFound = _argc - idx - 1;
-			if (optionArgsFound == _argHandlers[matchedIdx].argCount)
+			if ((optionArgsFound >= _argHandlers[matchedIdx].argCount)
+				&& (optionArgsFound <= _argHandlers[matchedIdx].argCount + _argHandlers[matchedIdx].optionalArgCount))
 			{
 				return true;
 			}
@@ -165,6 +237,131 @@ static bool ParseArg(int idx)
 	return false;
 }
 
+static int Profile(void)
+{
+	return ProfileVersionFile(_argv[_argIdx + 1]);
+}
+
+static int Scan(void)
+{
+	char *pFileName = _argv[_argIdx + 1];
+	FILE *fp = OpenFile(pFileName, "rb");
+
+	if (NULL == fp)
+	{
+		printf("Failed to open '%s'.\n", pFileName);
+		return -2;
+	}
+
+	char *pBlock = malloc(SCAN_BLOCK_SIZE);
+	SemVerMatch *pMatches = malloc(SCAN_BATCH_SIZE * sizeof(SemVerMatch));
+
+	if ((NULL == pBlock) || (NULL == pMatches))
+	{
+		printf("Out of memory.\n");
+		fclose(fp);
+		free(pBlock);
+		free(pMatches);
+		return -2;
+	}
+
+	// File offset of pBlock[0], and count of bytes carried over from the end
+	// of the previous block.
+	size_t blockSize = SCAN_BLOCK_SIZE;
+	size_t blockOffset = 0;
+	size_t carried = 0;
+	bool atEnd = false;
+
+	while (!atEnd)
+	{
+		size_t length = carried + fread(pBlock + carried, 1, blockSize - carried, fp);
+		atEnd = (length < blockSize);
+
+		// Unless this is the last block, a version could straddle its end.  So
+		// we stop short of the trailing run of SemVer characters, and carry it
+		// over to the next block, however long it is.
+		size_t scanLength = length;
+
+		if (!atEnd)
+		{
+			while ((0 != scanLength) && IsSemVerChar(pBlock[scanLength - 1])) scanLength--;
+		}
+
+		size_t offset = 0;
+		size_t count;
+
+		do
+		{
+			count = ScanForVersions(pBlock, scanLength, &offset, pMatches, SCAN_BATCH_SIZE);
+
+			for (size_t idx = 0; idx < count; idx++)
+			{
+				printf("%zu %.*s\n", blockOffset + pMatches[idx].offset, (int)pMatches[idx].length, pBlock + pMatches[idx].offset);
+				FreeVersionParseData(&pMatches[idx].record);
+			}
+		} while (SCAN_BATCH_SIZE == count);
+
+		carried = length - scanLength;
+		memmove(pBlock, pBlock + scanLength, carried);
+		blockOffset += scanLength;
+
+		// Leave room to read at least as much again as we carried, so a long
+		// run costs us one extra pass over it, and not one per block.
+		if (carried > blockSize / 2)
+		{
+			char *pGrown = (blockSize <= SIZE_MAX / 2) ? realloc(pBlock, blockSize * 2) : NULL;
+
+			if (NULL == pGrown)
+			{
+				printf("Out of memory.\n");
+				fclose(fp);
+				free(pBlock);
+				free(pMatches);
+				return -2;
+			}
+
+			pBlock = pGrown;
+			blockSize *= 2;
+		}
+	}
+
+	fclose(fp);
+	free(pBlock);
+	free(pMatches);
+
+	return 0;
+}
+
+// Shared by Sort() and SortMeta().
+static int SortFile(bool collapseMeta)
+{
+	size_t budgetMB = SORT_DEFAULT_BUDGET_MB;
+
+	if (_argIdx + 3 < _argc)
+	{
+		char *pEnd;
+		budgetMB = strtoul(_argv[_argIdx + 3], &pEnd, 10);
+
+		if ((0 == budgetMB) || ('\0' != *pEnd) || (budgetMB > SIZE_MAX / (1024 * 1024)))
+		{
+			printf("Memory budget '%s' must be a positive number of MB.\n", _argv[_argIdx + 3]);
+			return -2;
+		}
+	}
+
+	return SortVersionFile(_argv[_argIdx + 1], _argv[_argIdx + 2], budgetMB * 1024 * 1024, collapseMeta);
+}
+
+static int Sort(void)
+{
+	return SortFile(false);
+}
+
+static int SortMeta(void)
+{
+	return SortFile(true);
+}
+
 static int validate(char *candidate)
 {
 	VersionParseRecord *vpr = ClassifyVersionCandidate(candidate, NULL);
@@ -12,6 +12,7 @@
 // possible to fix it.
 
 #include "SemVer.h"
+#include "SemVerStats.h"
 
 #include <ctype.h>
 #include <memory.h>
@@ -37,15 +38,100 @@ static const char _hyphen = '-';
 static const char _plus = '+';
 static const char _zero = '0';
 
+// What a wide code unit outside of ASCII reads as.  Nothing accepts it.
+static const char _nonAscii = '\x7F';
+
 // When a tag is detected, we allocate space for this many ParsedTagRecord's.
 // When we run out, this is how many we attempt to expand it by. Considered 
 // using a linked list, but I think over-all, this will be faster, consume less
 // memory and provide better locality of data for cache hits.
-static const size_t _prereleaseDataAllocationCount = 5;
-static const size_t _metaDataAllocationCount = 5;
+static const size_t _prereleaseDataAllocationCount = VERSION_TAG_BLOCK_SIZE;
+static const size_t _metaDataAllocationCount = VERSION_TAG_BLOCK_SIZE;
+
+// See SemVerStats.h.  Without SEMVER_STATS, the counters compile to nothing.
+#ifdef SEMVER_STATS
+ #if defined(_MSC_VER)
+  #define SEMVER_THREAD_LOCAL __declspec(thread)
+ #elif defined(__GNUC__)
+  #define SEMVER_THREAD_LOCAL __thread
+ #else
+  #define SEMVER_THREAD_LOCAL _Thread_local
+ #endif
+
+static SEMVER_THREAD_LOCAL SemVerStats _stats;
+
+ #define CountStat(counter) (_stats.counter++)
+ #define CountStatBytes(counter, bytes) (_stats.counter += (bytes))
+#else
+ #define CountStat(counter) ((void)0)
+ #define CountStatBytes(counter, bytes) ((void)0)
+#endif
 
 // Private functions in alphabetical order...
 
+// Copies count characters from pSource to pBuffer[*pLength], for as long as 
+// there's room for them and a terminating null.  *pLength always advances, so
+// the caller can report the length it would have needed.
+static void AppendCanonical(char *pBuffer, size_t bufferSize, size_t *pLength, const char *pSource, size_t count)
+{
+	for (size_t idx = 0; idx < count; idx++, (*pLength)++)
+	{
+		if (*pLength + 1 < bufferSize) pBuffer[*pLength] = pSource[idx];
+	}
+}
+
+// For IsSemVer(), the character at idx, or a null once we're past length.
+static inline char CandidateChar(const char *pCandidate, size_t length, size_t idx)
+{
+	return (idx < length) ? pCandidate[idx] : _null;
+}
+
+// The code unit at idx, as a char.  Units outside of ASCII, narrow or wide,
+// come back as _nonAscii, so the classifier rejects them without looking any
+// further, and never hands ctype a negative char.
+static inline char CandidateUnit(const void *pCandidate, size_t unitSize, size_t idx)
+{
+	uint32_t unit;
+
+	if (sizeof(char) == unitSize)
+	{
+		unit = ((const unsigned char*)pCandidate)[idx];
+	}
+	else
+	{
+		unit = (sizeof(char16_t) == unitSize) ? ((const char16_t*)pCandidate)[idx] : ((const char32_t*)pCandidate)[idx];
+	}
+
+	return (unit < 0x80) ? (char)unit : _nonAscii;
+}
+
+// Lenient parses close each span in the version triple when they leave its
+// state, at idx.
+static inline void CloseLenientSpan(VersionSpan *pSpan, size_t idx)
+{
+	pSpan->length = idx - pSpan->idx;
+}
+
+// Where the digits of one part of the version triple are.
+static inline void ComponentSpan(const VersionParseRecord *pParsed, VersionComponent component, size_t *pIdx, size_t *pDigits)
+{
+	switch (component)
+	{
+		case eVersionMajor:
+			*pIdx = 0;
+			*pDigits = pParsed->majorDigits;
+			break;
+		case eVersionMinor:
+			*pIdx = pParsed->minorIdx;
+			*pDigits = pParsed->minorDigits;
+			break;
+		default:
+			*pIdx = pParsed->patchIdx;
+			*pDigits = pParsed->patchDigits;
+			break;
+	}
+}
+
 // Ensures that pParsed is properly initialized, or allocates an initialized
 // record if pParsed is NULL.
 static inline VersionParseRecord* InitializeParseDataRecord(VersionParseRecord *pParsed)
@@ -53,6 +139,8 @@ static inline VersionParseRecord* InitializeParseDataRecord(VersionParseRecord *
 	if (NULL == pParsed)
 	{
 		pParsed = calloc(1, sizeof(VersionParseRecord));
+		CountStat(recordAllocations);
+		CountStatBytes(bytesAllocated, sizeof(VersionParseRecord));
 	}
 	else
 	{
@@ -63,6 +151,58 @@ static inline VersionParseRecord* InitializeParseDataRecord(VersionParseRecord *
 	return pParsed;
 }
 
+// isdigit() is the same in every locale, so this is too, without the call.
+static inline bool IsDecimalDigit(char c)
+{
+	return (unsigned)(c - _zero) < 10;
+}
+
+// Lenient parses tolerate a single character prefix on the major version.
+static inline bool IsLenientPrefix(char c)
+{
+	return ('v' == c) || ('V' == c);
+}
+
+// *pHigh:*pLow = (*pHigh:*pLow * 10) + digit, unless that needs more than 128
+// bits.  Times ten is (value << 3) + (value << 1), so we never need a 128 bit
+// multiply, which C doesn't have everywhere.
+static bool MultiplyAdd128(uint64_t *pHigh, uint64_t *pLow, unsigned digit)
+{
+	// Anything at or above 2^125 is at least 1.25 * 2^128 once it's times ten,
+	// and below that the shifts below lose no bits.  Values between 2^128 / 10
+	// and 2^125 still overflow, which the checked adds below catch.
+	if (0 != (*pHigh >> 61)) return false;
+
+	uint64_t high8 = (*pHigh << 3) | (*pLow >> 61);
+	uint64_t low8 = *pLow << 3;
+	uint64_t high2 = (*pHigh << 1) | (*pLow >> 63);
+	uint64_t low2 = *pLow << 1;
+
+	uint64_t low = low8 + low2;
+	uint64_t carry = (low < low8) ? 1 : 0;
+
+	uint64_t high = high8 + high2;
+
+	if (high < high8) return false;
+
+	high += carry;
+
+	if (high < carry) return false;
+
+	low += digit;
+
+	if (low < digit)
+	{
+		if (UINT64_MAX == high) return false;
+		high++;
+	}
+
+	*pHigh = high;
+	*pLow = low;
+
+	return true;
+}
+
 // Reallocate a zeroed block on the heap and copy oldBlock into it.
 static inline void* recalloc(void *oldBlock, size_t currentCount, size_t additionalCount, size_t size)
 {
@@ -71,6 +211,63 @@ static inline void* recalloc(void *oldBlock, size_t currentCount, size_t additio
 	assert(NULL != newBlock);
 	memcpy(newBlock, oldBlock, size * currentCount);
 	free(oldBlock);
+	CountStat(tagReallocations);
+	CountStatBytes(bytesAllocated, (currentCount + additionalCount) * size);
+	return newBlock;
+}
+
+// Ensure that pLenient describes the canonical view of the string, after 
+// SetFinalVersion() has classified the raw string.  Any span that was still
+// open when we ran off the end of the string is closed at endIdx.
+static void SetFinalLenientVersion(VersionParseRecord *pParsed, LenientParseRecord *pLenient, size_t endIdx)
+{
+	VersionType canonicalType = pParsed->versionType;
+
+	switch (pParsed->state)
+	{
+		case eStart:
+			// Nothing but a prefix.
+			pParsed->versionType = eNotVersion;
+			canonicalType = eNotVersion;
+			break;
+
+		case eInMajor:
+			pLenient->major.length = endIdx - pLenient->major.idx;
+			pLenient->relaxations |= eRelaxedMissingComponent;
+			canonicalType = eSemVer_2_0_0;
+			break;
+
+		case eInMinor:
+			// "1." can't be fixed without guessing.
+			if (0 == pParsed->minorDigits) break;
+
+			pLenient->minor.length = endIdx - pLenient->minor.idx;
+			pLenient->relaxations |= eRelaxedMissingComponent;
+			canonicalType = eSemVer_2_0_0;
+			break;
+
+		case eInPatch:
+			pLenient->patch.length = endIdx - pLenient->patch.idx;
+			break;
+
+		case eInLenientExtra:
+			// "1.2.3." can't be fixed without guessing.
+			if (0 != pLenient->extra.length) canonicalType = eSemVer_2_0_0;
+			break;
+
+		default:
+			// We ran out of characters somewhere in a tag.
+			pLenient->tag.length = endIdx - pLenient->tag.idx;
+			break;
+	}
+
+	pLenient->versionType = canonicalType;
+
+	// The raw string is not SemVer if we had to bend the rules to get here.
+	if ((eRelaxedNone != pLenient->relaxations) && (eSemVer_2_0_0 == pParsed->versionType))
+	{
+		pParsed->versionType = eUnknownVersion;
+	}
 }
 
 // Ensure that pParsed data is set correctly, after running off the end
@@ -84,7 +281,9 @@ static inline VersionParseRecord* SetFinalVersion(VersionParseRecord *pParsed)
 	switch (pParsed->state)
 	{
 		case eInPatch:
-			// fall-thru...
+			// "1.2." runs out of characters before the first patch digit.
+			pParsed->versionType = (0 != pParsed->patchDigits) ? eSemVer_2_0_0 : eUnknownVersion;
+			break;
 		// If eInPrereleaseFirstChar, we failed to successfully advance.
 		// If eInPrereleaseFirstFieldChar, we failed to successfully advance.
 		case eInPreAlphaNumericField:
@@ -105,20 +304,71 @@ static inline VersionParseRecord* SetFinalVersion(VersionParseRecord *pParsed)
 // Called for all early exits from the state machine.
 static inline VersionParseRecord* SetVersionType(VersionParseRecord *p, VersionType vt)
 {
+	CountStat(rejectedInState[p->state]);
 	p->versionType = vt;
 	return p;
 }
 
-// Called from each of the two points in the state machine that jump into build
+// Called for strict early exits caused by a leading zero in the version triple.
+static inline VersionParseRecord* RejectLeadingZero(VersionParseRecord *p)
+{
+	CountStat(leadingZeroRejections);
+	return SetVersionType(p, eUnknownVersion);
+}
+
+// Lenient parses may drop leading zeros from any field in the version triple.
+// The span is moved up to the current digit, which is only a leading zero
+// itself if it's another zero.
+static inline void SkipLeadingZero(LenientParseRecord *pLenient, VersionSpan *pSpan, bool *pHasLeadingZero, char c, size_t idx)
+{
+	pLenient->relaxations |= eRelaxedLeadingZero;
+	pSpan->idx = idx;
+	*pHasLeadingZero = (_zero == c);
+}
+
+// Called from each of the points in the state machine that jump into build
 // meta processing.
-static void TransitionToMeta(VersionParseRecord *pParsed, const char *pIter, const char *pCandidate)
+static void TransitionToMeta(VersionParseRecord *pParsed)
 {
 	pParsed->pMetaData = calloc(_metaDataAllocationCount, sizeof(ParsedTagRecord));
 	assert(NULL != pParsed->pMetaData);
-	pParsed->pMetaData[0].fieldIdx = (pIter - pCandidate) + 1;
+	CountStat(tagAllocations);
+	CountStatBytes(bytesAllocated, _metaDataAllocationCount * sizeof(ParsedTagRecord));
+	pParsed->pMetaData[0].fieldIdx = pParsed->parsedIdx + 1;
 	pParsed->state = eInMetaFirstChar;
 }
 
+// Called from each of the points in the state machine that jump into
+// prerelease processing.
+static void TransitionToPrerelease(VersionParseRecord *pParsed)
+{
+	pParsed->pPrereleaseData = calloc(_prereleaseDataAllocationCount, sizeof(ParsedTagRecord));
+	assert(NULL != pParsed->pPrereleaseData);
+	CountStat(tagAllocations);
+	CountStatBytes(bytesAllocated, _prereleaseDataAllocationCount * sizeof(ParsedTagRecord));
+	pParsed->pPrereleaseData[0].fieldIdx = pParsed->parsedIdx + 1;
+	pParsed->state = eInPrereleaseFirstChar;
+}
+
+// Called from each of the points in the version triple that can start a tag.
+// c must be a hyphen or a plus.
+static void TransitionToTag(VersionParseRecord *pParsed, LenientParseRecord *pLenient, char c)
+{
+	if (NULL != pLenient)
+	{
+		pLenient->tag.idx = pParsed->parsedIdx;
+	}
+
+	if (_hyphen == c)
+	{
+		TransitionToPrerelease(pParsed);
+	}
+	else
+	{
+		TransitionToMeta(pParsed);
+	}
+}
+
 
 //
 // I make no apologies for the complexity of this function.  It's a state 
@@ -133,35 +383,54 @@ static void TransitionToMeta(VersionParseRecord *pParsed, const char *pIter, con
 // trying to avoid non standard library dependencies.  I also don't trust regex
 // compilers to do the right thing 100% of the time.
 //
-VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionParseRecord *pParsed)
+// When pLenient is NULL, this is a strict SemVer 2.0.0 parse.  Otherwise the
+// relaxations described in SemVer.h are applied as we go, so dirty data still
+// only costs a single pass.  Every lenient branch is on a path that the strict
+// parse would have rejected anyway, or is a once per string transition.
+//
+// We stop at the first null, or after length characters, whichever is first.
+//
+static VersionParseRecord* ClassifyCandidate(const void *pCandidate, size_t unitSize, size_t length, VersionParseRecord *pParsed, LenientParseRecord *pLenient)
 {
 	pParsed = InitializeParseDataRecord(pParsed);
+	CountStat(classifications);
 
-	if ((NULL == pCandidate) || (_null == pCandidate[0])) return SetVersionType(pParsed, eNotVersion);
-
-	const char *pIter = pCandidate;
+	if ((NULL == pCandidate) || (0 == length) || (_null == CandidateUnit(pCandidate, unitSize, 0))) return SetVersionType(pParsed, eNotVersion);
 
 	// Note that there are no look-aheads.  
 	// We parse the string one character at a time, for exactly O(n).
 
-	while(_null != *pIter)
+	// parsedIdx is always the index of c, so the length check is free.
+	while (pParsed->parsedIdx < length)
 	{
+		char c = CandidateUnit(pCandidate, unitSize, pParsed->parsedIdx);
+
+		if (_null == c) break;
+
 		switch( pParsed->state )
 		{
 			case eStart: // Expect first major version field digit.
 
-				// *pIter has the first character in the string.
+				// c has the first character in the string.
 			
 				// There's two ways out of this state.  Either this string doesn't
 				// look like any kind of version number, or it starts with a digit.
+				// A lenient parse may loop here once, to skip a 'v' prefix.
+
+				if (!isdigit(c))
+				{
+					if ((NULL == pLenient) || (0 != pParsed->parsedIdx) || !IsLenientPrefix(c)) return SetVersionType(pParsed, eNotVersion);
 
-				if (!isdigit(*pIter)) return SetVersionType(pParsed, eNotVersion);
+					pLenient->relaxations |= eRelaxedPrefix;
+					pLenient->major.idx = 1;
+					break;
+				}
 				
 				pParsed->state = eInMajor;
 				pParsed->majorDigits++;
 
 				// Only place we can legally encounter leading zero in major, is here.
-				if (_zero == *pIter) pParsed->majorHasLeadingZero = true; 
+				if (_zero == c) pParsed->majorHasLeadingZero = true; 
 
 				break;
 			
@@ -174,22 +443,46 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 				
 				// We've already consumed one digit to get into this state.
 
-				if (_dot == *pIter)	
+				if (_dot == c)	
 				{
 					if (pParsed->majorHasLeadingZero)
 					{
 						pParsed->isPrereleaseVersion = true;
 					}
 
-					pParsed->minorIdx = (pIter - pCandidate) + 1;
+					pParsed->minorIdx = pParsed->parsedIdx + 1;
 					pParsed->state = eInMinor;
 
+					if (NULL != pLenient)
+					{
+						CloseLenientSpan(&pLenient->major, pParsed->parsedIdx);
+						pLenient->minor.idx = pParsed->minorIdx;
+					}
+
+					break;
+				}
+
+				// "1-beta" and "1+meta" are missing both minor and patch.
+				if ((NULL != pLenient) && ((_hyphen == c) || (_plus == c)))
+				{
+					CloseLenientSpan(&pLenient->major, pParsed->parsedIdx);
+					pLenient->relaxations |= eRelaxedMissingComponent;
+					TransitionToTag(pParsed, pLenient, c);
 					break;
 				}
 				
-				// If we're looking at another digit AND majorHasLeadingZero, or there is
-				// any kind of trash, we have no clue what kind of version string this is.
-				if (!isdigit(*pIter) || pParsed->majorHasLeadingZero) return SetVersionType(pParsed, eUnknownVersion);
+				// If there is any kind of trash, we have no clue what kind of 
+				// version string this is.
+				if (!isdigit(c)) return SetVersionType(pParsed, eUnknownVersion);
+
+				// Same goes for another digit AND majorHasLeadingZero, unless
+				// we're being lenient.
+				if (pParsed->majorHasLeadingZero)
+				{
+					if (NULL == pLenient) return RejectLeadingZero(pParsed);
+
+					SkipLeadingZero(pLenient, &pLenient->major, &pParsed->majorHasLeadingZero, c, pParsed->parsedIdx);
+				}
 
 				pParsed->majorDigits++;
 
@@ -205,19 +498,42 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 				// terminates on a _null character.
 				// Otherwise, we count digits.
 
-				if (_dot == *pIter) 
+				if (_dot == c) 
 				{
 					if (0 == pParsed->minorDigits) return SetVersionType(pParsed, eUnknownVersion);
 
-					pParsed->patchIdx = (pIter - pCandidate) + 1;
+					pParsed->patchIdx = pParsed->parsedIdx + 1;
 					pParsed->state = eInPatch;
+
+					if (NULL != pLenient)
+					{
+						CloseLenientSpan(&pLenient->minor, pParsed->parsedIdx);
+						pLenient->patch.idx = pParsed->patchIdx;
+					}
+
+					break;
+				}
+
+				// "1.2-beta" and "1.2+meta" are missing the patch.
+				if ((NULL != pLenient) && (0 != pParsed->minorDigits) && ((_hyphen == c) || (_plus == c)))
+				{
+					CloseLenientSpan(&pLenient->minor, pParsed->parsedIdx);
+					pLenient->relaxations |= eRelaxedMissingComponent;
+					TransitionToTag(pParsed, pLenient, c);
 					break;
 				}
 
-				if (!isdigit(*pIter) || pParsed->minorHasLeadingZero) return SetVersionType(pParsed, eUnknownVersion);
+				if (!isdigit(c)) return SetVersionType(pParsed, eUnknownVersion);
 
-				if (_zero == *pIter)
+				if (pParsed->minorHasLeadingZero)
 				{
+					if (NULL == pLenient) return RejectLeadingZero(pParsed);
+
+					SkipLeadingZero(pLenient, &pLenient->minor, &pParsed->minorHasLeadingZero, c, pParsed->parsedIdx);
+				}
+				else if ((0 == pParsed->minorDigits) && (_zero == c))
+				{
+					// Only the first digit can be a leading zero.
 					pParsed->minorHasLeadingZero = true;
 				}
 
@@ -237,49 +553,70 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 
 				if (0 != pParsed->patchDigits)
 				{
-					if (_hyphen == *pIter) 
+					if ((_hyphen == c) || (_plus == c))
 					{
-						pParsed->pPrereleaseData = calloc(_prereleaseDataAllocationCount, sizeof(ParsedTagRecord));
-						assert(NULL != pParsed->pPrereleaseData);
-						pParsed->pPrereleaseData[0].fieldIdx = (pIter - pCandidate) + 1;
-						pParsed->state = eInPrereleaseFirstChar;
+						if (NULL != pLenient) CloseLenientSpan(&pLenient->patch, pParsed->parsedIdx);
+
+						TransitionToTag(pParsed, pLenient, c);
 						break;
 					}
 
-					if (_plus == *pIter)
+					if (_dot == c)
 					{
-						pParsed->pMetaData = calloc(_metaDataAllocationCount, sizeof(ParsedTagRecord));
-						assert(NULL != pParsed->pMetaData);
-						pParsed->pMetaData[0].fieldIdx = (pIter - pCandidate) + 1;
-						pParsed->state = eInMetaFirstChar;
+						// Four or more dotted fields, not SemVer.
+						if (NULL == pLenient) return SetVersionType(pParsed, eUnknownVersion); 
+
+						// But we can drop the fourth field from the canonical view.
+						CloseLenientSpan(&pLenient->patch, pParsed->parsedIdx);
+						pLenient->relaxations |= eRelaxedExtraComponent;
+						pLenient->extra.idx = pParsed->parsedIdx + 1;
+						pParsed->state = eInLenientExtra;
 						break;
 					}
-
-					// Four or more dotted fields, not SemVer.
-					if (_dot == *pIter) return SetVersionType(pParsed, eUnknownVersion); 
 				}
 				else // 0 == patchDigits
 				{
-					if ((_hyphen == *pIter) || (_plus == *pIter) || (_dot == *pIter))
+					if ((_hyphen == c) || (_plus == c) || (_dot == c))
 					{
 						return SetVersionType(pParsed, eUnknownVersion);
 					}
 				}
 
-				if (!isdigit(*pIter)) return SetVersionType(pParsed, eUnknownVersion);
+				if (!isdigit(c)) return SetVersionType(pParsed, eUnknownVersion);
 
-				if (pParsed->patchHasLeadingZero) return SetVersionType(pParsed, eUnknownVersion);
+				if (pParsed->patchHasLeadingZero)
+				{
+					// A second digit after a zero, counts as "other trash".
+					if (NULL == pLenient) return RejectLeadingZero(pParsed);
 
-				if (_zero == *pIter)
+					SkipLeadingZero(pLenient, &pLenient->patch, &pParsed->patchHasLeadingZero, c, pParsed->parsedIdx);
+				}
+				else if ((0 == pParsed->patchDigits) && (_zero == c))
 				{
-					// A second zero, counts as "other trash".
-					if (pParsed->patchHasLeadingZero) return SetVersionType(pParsed, eUnknownVersion);;
+					// Only the first digit can be a leading zero.
 					pParsed->patchHasLeadingZero = true;
 				}
 
 				pParsed->patchDigits++;
 				break;	
 
+			case eInLenientExtra: // Expect digits, hyphen or plus.
+
+				// Only lenient parses get here, after the dot that ends the
+				// patch field.  This field never makes it into the canonical 
+				// view, so we don't care about leading zeros.
+
+				if ((0 != pLenient->extra.length) && ((_hyphen == c) || (_plus == c)))
+				{
+					TransitionToTag(pParsed, pLenient, c);
+					break;
+				}
+
+				if (!isdigit(c)) return SetVersionType(pParsed, eUnknownVersion);
+
+				pLenient->extra.length++;
+				break;
+
 			case eInPrereleaseFirstChar: // Expect digits or alpha characters.
 
 				// There can be multiple dot seperated fields.
@@ -289,30 +626,41 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 				//   If a digit and it's 1..9, the field may be either numeric or alphanumeric.
 				//   If a character, the field is alphanumeric.
 
-				// We entered this state with pIter pointing to the first
+				// We entered this state with c holding the first
 				// candidate digit, so prereleaseDigits is currently zero.
-				if ((_plus == *pIter) || (_dot == *pIter)) return SetVersionType(pParsed, eUnknownVersion);
+				if ((_plus == c) || (_dot == c)) return SetVersionType(pParsed, eUnknownVersion);
 
 				// Fall-thru...
 			case eInPrereleaseFirstFieldChar:
 			{
 				// We should be looking at a valid field char at this point.
 
-				if (IsValidPrereleaseFieldChar(*pIter)) 
+				if (IsValidPrereleaseFieldChar(c)) 
 				{
+					// Make room for this field if we've used up the last block.
+					if ((0 != pParsed->prereleaseFieldCount) && (0 == pParsed->prereleaseFieldCount % _prereleaseDataAllocationCount))
+					{
+						pParsed->pPrereleaseData = recalloc(pParsed->pPrereleaseData, pParsed->prereleaseFieldCount, _prereleaseDataAllocationCount, sizeof(ParsedTagRecord));
+					}
+
 					ParsedTagRecord *ppdr = &(pParsed->pPrereleaseData[pParsed->prereleaseFieldCount]);
 
-					if (isdigit(*pIter)) 
+					ppdr->fieldIdx = pParsed->parsedIdx;
+
+					if (isdigit(c)) 
 					{
 						pParsed->state = eInPreNumericField;
-						if (_zero == *pIter) 
+						ppdr->fieldType = _numericT;
+
+						if (_zero == c) 
 						{
-							pParsed->pPrereleaseData[pParsed->prereleaseFieldCount].fieldHasLeadingZero = true;
+							ppdr->fieldHasLeadingZero = true;
 						}
 					}
 					else
 					{
 						pParsed->state = eInPreAlphaNumericField;
+						ppdr->fieldType = _alphanumT;
 					}
 
 					// We visit this code once per valid field.
@@ -335,18 +683,17 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 
 				ParsedTagRecord *ppdr = &(pParsed->pPrereleaseData[pParsed->prereleaseFieldCount - 1]);
 
-				if (_dot == *pIter)
+				if (_dot == c)
 				{
-					ppdr->fieldType = _alphanumT;
 					pParsed->state = eInPrereleaseFirstFieldChar;
 					break;
 				}
-				else if (_plus == *pIter)
+				else if (_plus == c)
 				{
-					TransitionToMeta(pParsed, pIter, pCandidate);
+					TransitionToMeta(pParsed);
 					break;
 				}
-				else if (!IsValidPrereleaseFieldChar(*pIter)) 
+				else if (!IsValidPrereleaseFieldChar(c)) 
 				{
 					return SetVersionType(pParsed, eUnknownVersion);
 				}
@@ -365,35 +712,38 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 				
 				ParsedTagRecord *ppdr = &(pParsed->pPrereleaseData[pParsed->prereleaseFieldCount - 1]);
 
-				if (!isdigit(*pIter))
+				if (!isdigit(c))
 				{
 					if (pParsed->fieldNeedsAlphaToPass)
 					{
-						if ((_dot == *pIter) || (_plus == *pIter))
+						if ((_dot == c) || (_plus == c))
 						{
 							pParsed->prereleaseFieldCount--;
+							CountStat(needsAlphaRejections);
 							return SetVersionType(pParsed, eUnknownVersion);
 						}
 					}
 
-					if (_dot == *pIter)
+					if (_dot == c)
 					{
-						ppdr->fieldLength = (pIter - pCandidate) + 1;
-						ppdr->fieldType = _alphanumT;
-
 						pParsed->state = eInPrereleaseFirstFieldChar;
+						break;
 					}
-					else if (_plus == *pIter)
+					else if (_plus == c)
 					{
-						TransitionToMeta(pParsed, pIter, pCandidate);
+						TransitionToMeta(pParsed);
 						break;
 					}
-					else if (isalpha(*pIter) || (_hyphen == *pIter))
+					else if (isalpha(c) || (_hyphen == c))
 					{
 						ppdr->fieldHasLeadingZero = false;
+						ppdr->fieldType = _alphanumT;
 						pParsed->state = eInPreAlphaNumericField;
 						pParsed->fieldNeedsAlphaToPass = false;
-						pParsed->pPrereleaseData[pParsed->prereleaseFieldCount].fieldHasLeadingZero = false;
+					}
+					else
+					{
+						return SetVersionType(pParsed, eUnknownVersion);
 					}
 				}
 				else if ((pParsed->pPrereleaseData[pParsed->prereleaseFieldCount - 1].fieldHasLeadingZero))
@@ -401,6 +751,8 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 					// At this point, we may not have a SemVer string at all, but if there's
 					// an alpha character in the field, it could pass.  So we mark this as
 					// needing an alpha character to succeed.
+					if (!pParsed->fieldNeedsAlphaToPass) CountStat(needsAlphaToPass);
+
 					pParsed->fieldNeedsAlphaToPass = true;
 				}
 
@@ -415,7 +767,16 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 				// Meta is a little bit simpler than prerelease. No worries 
 				// about leading zeros, but empty fields are still forbidden.
 
-				if (!IsValidMetaFieldChar(*pIter)) return SetVersionType(pParsed, eUnknownVersion);
+				if (!IsValidMetaFieldChar(c)) return SetVersionType(pParsed, eUnknownVersion);
+
+				// Make room for this field if we've used up the last block.
+				if ((0 != pParsed->metaFieldCount) && (0 == pParsed->metaFieldCount % _metaDataAllocationCount))
+				{
+					pParsed->pMetaData = recalloc(pParsed->pMetaData, pParsed->metaFieldCount, _metaDataAllocationCount, sizeof(ParsedTagRecord));
+				}
+
+				pParsed->pMetaData[pParsed->metaFieldCount].fieldIdx = pParsed->parsedIdx;
+				pParsed->pMetaData[pParsed->metaFieldCount].fieldLength = 1;
 
 				pParsed->state = eInMetaField;
 				pParsed->metaChars++;
@@ -428,22 +789,21 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 				// We get here only if the first character, and any subsequent characters were legal.  
 				// Watch for field delimiters and invalid characters.
 
-				if (_dot == *pIter)
+				if (_dot == c)
 				{
-					ParsedTagRecord *pmdr = &(pParsed->pMetaData[pParsed->metaFieldCount - 1]);
-					pmdr->fieldLength = (pIter - pCandidate) + 1;
 					pParsed->state = eInMetaFirstChar;
+					break;
 				}
-				else if (!IsValidMetaFieldChar(*pIter))
+				else if (!IsValidMetaFieldChar(c))
 				{
 					return SetVersionType(pParsed, eUnknownVersion);
 				}
 
+				pParsed->pMetaData[pParsed->metaFieldCount - 1].fieldLength++;
 				pParsed->metaChars++;
 				break;
 		}
 
-		pIter++;
 		pParsed->parsedIdx++;
 	} // end while(...)
 
@@ -451,28 +811,199 @@ VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionPars
 	// and there have been no obvious problems.  But whether we have a valid
 	// SemVer string depends on how far we got.
 
+	CountStat(completedInState[pParsed->state]);
+
 	if (pParsed->fieldNeedsAlphaToPass)
 	{
 		pParsed->prereleaseFieldCount--;
-		return SetVersionType(pParsed, eUnknownVersion);
+		pParsed->versionType = eUnknownVersion;
+		CountStat(needsAlphaRejections);
+	}
+	else
+	{
+		pParsed->hasPrereleaseTag = (NULL != pParsed->pPrereleaseData);
+		pParsed->isPrereleaseVersion |= pParsed->hasPrereleaseTag;
+		pParsed->hasMetaTag = (NULL != pParsed->pMetaData);
+
+		SetFinalVersion(pParsed);
+	}
+
+	if (NULL != pLenient)
+	{
+		SetFinalLenientVersion(pParsed, pLenient, pParsed->parsedIdx);
+	}
+
+	return pParsed;
+}
+
+VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionParseRecord *pParsed)
+{
+	return ClassifyCandidate(pCandidate, sizeof(char), SIZE_MAX, pParsed, NULL);
+}
+
+VersionParseRecord* ClassifyVersionCandidateN(const char *pCandidate, size_t length, VersionParseRecord *pParsed)
+{
+	return ClassifyCandidate(pCandidate, sizeof(char), length, pParsed, NULL);
+}
+
+VersionParseRecord* ClassifyVersionCandidate16(const char16_t *pCandidate, size_t length, VersionParseRecord *pParsed)
+{
+	return ClassifyCandidate(pCandidate, sizeof(char16_t), length, pParsed, NULL);
+}
+
+VersionParseRecord* ClassifyVersionCandidate32(const char32_t *pCandidate, size_t length, VersionParseRecord *pParsed)
+{
+	return ClassifyCandidate(pCandidate, sizeof(char32_t), length, pParsed, NULL);
+}
+
+// The same grammar as ClassifyCandidate(), with the same character tests, but
+// straight-line, because there's nothing to record along the way.
+bool IsSemVer(const char *pCandidate, size_t length)
+{
+	if (NULL == pCandidate) return false;
+
+	size_t idx = 0;
+	char c;
+
+	// The version triple.  A field is a single zero, or digits that don't start
+	// with one.
+	for (int field = 0; field < 3; field++)
+	{
+		if ((0 != field) && (_dot != CandidateChar(pCandidate, length, idx++))) return false;
+
+		c = CandidateChar(pCandidate, length, idx++);
+
+		if (!IsDecimalDigit(c)) return false;
+
+		if (_zero == c)
+		{
+			if (IsDecimalDigit(CandidateChar(pCandidate, length, idx))) return false;
+		}
+		else
+		{
+			while (IsDecimalDigit(CandidateChar(pCandidate, length, idx))) idx++;
+		}
+	}
+
+	c = CandidateChar(pCandidate, length, idx);
+
+	// Prerelease fields can't be empty, and all digit fields can't have a
+	// leading zero.
+	if (_hyphen == c)
+	{
+		do
+		{
+			size_t first = ++idx;
+			bool numeric = true;
+
+			while (IsValidPrereleaseFieldChar(c = CandidateChar(pCandidate, length, idx)))
+			{
+				numeric = numeric && IsDecimalDigit(c);
+				idx++;
+			}
+
+			if ((first == idx) || (numeric && (_zero == pCandidate[first]) && (idx - first > 1))) return false;
+		} while (_dot == c);
+	}
+
+	// Meta fields only have to be non-empty.
+	if (_plus == c)
+	{
+		do
+		{
+			size_t first = ++idx;
+
+			while (IsValidMetaFieldChar(c = CandidateChar(pCandidate, length, idx))) idx++;
+
+			if (first == idx) return false;
+		} while (_dot == c);
+	}
+
+	return _null == c;
+}
+
+VersionParseRecord* ClassifyVersionCandidateLenient(const char *pCandidate, VersionParseRecord *pParsed, LenientParseRecord *pLenient)
+{
+	assert(NULL != pLenient);
+	memset(pLenient, 0, sizeof(LenientParseRecord));
+
+	pParsed = ClassifyCandidate(pCandidate, sizeof(char), SIZE_MAX, pParsed, pLenient);
+
+	// Early exits from the state machine leave parsedIdx short of the null,
+	// and the canonical view is no better than the raw string.
+	if ((NULL == pCandidate) || (_null != pCandidate[pParsed->parsedIdx]))
+	{
+		pLenient->versionType = pParsed->versionType;
 	}
 
-	pParsed->hasPrereleaseTag = (NULL != pParsed->pPrereleaseData);
-	pParsed->isPrereleaseVersion |= pParsed->hasPrereleaseTag;
-	pParsed->hasMetaTag = (NULL != pParsed->pMetaData);
+	return pParsed;
+}
+
+void FreeVersionParseData(VersionParseRecord *pParsed)
+{
+	assert(NULL != pParsed);
 
-	return SetFinalVersion(pParsed);
+	free(pParsed->pPrereleaseData);
+	free(pParsed->pMetaData);
+	pParsed->pPrereleaseData = NULL;
+	pParsed->pMetaData = NULL;
 }
 
-// These should work for both unsigned and signed char.
-#define MakeUnsignedWord(b1, b2) ((uint16_t)((uint16_t)(((uint8_t)(b1) & 0xF) << 8) & ((uint16_t)(((uint8_t)(b2) & 0xF)))))
-#define MakeUnsignedDWord(b1, b2, b3, b4) ( ( (((uint32_t)MakeUnsignedWord((b1), (b2)) << 16) ) & (((uint32_t)MakeUnsignedWord((b3), (b4)))) ) )
-#define MakeUnsignedQWord(b1, b2, b3, b4, b5, b6, b7, b8) ( ( ((uint64_t)MakeUnsignedDWord((b1), (b2), (b3), (b4)) << 32) & ((uint64_t)MakeUnsignedDWord((b5), (b6), (b7), (b8))) ) )
+size_t FormatCanonicalVersion(const char *pCandidate, const LenientParseRecord *pLenient, char *pBuffer, size_t bufferSize)
+{
+	assert(NULL != pCandidate);
+	assert(NULL != pLenient);
+	assert((NULL != pBuffer) || (0 == bufferSize));
+
+	if (eSemVer_2_0_0 != pLenient->versionType) return 0;
+
+	size_t length = 0;
+
+	AppendCanonical(pBuffer, bufferSize, &length, pCandidate + pLenient->major.idx, pLenient->major.length);
+	AppendCanonical(pBuffer, bufferSize, &length, &_dot, 1);
+
+	// Missing minor and patch fields are rendered as "0".
+	if (0 != pLenient->minor.length)
+	{
+		AppendCanonical(pBuffer, bufferSize, &length, pCandidate + pLenient->minor.idx, pLenient->minor.length);
+	}
+	else
+	{
+		AppendCanonical(pBuffer, bufferSize, &length, &_zero, 1);
+	}
+
+	AppendCanonical(pBuffer, bufferSize, &length, &_dot, 1);
+
+	if (0 != pLenient->patch.length)
+	{
+		AppendCanonical(pBuffer, bufferSize, &length, pCandidate + pLenient->patch.idx, pLenient->patch.length);
+	}
+	else
+	{
+		AppendCanonical(pBuffer, bufferSize, &length, &_zero, 1);
+	}
+
+	AppendCanonical(pBuffer, bufferSize, &length, pCandidate + pLenient->tag.idx, pLenient->tag.length);
+
+	if (0 != bufferSize)
+	{
+		pBuffer[(length < bufferSize) ? length : bufferSize - 1] = _null;
+	}
+
+	return length;
+}
+
+// These should work for both unsigned and signed char.  The first byte ends
+// up in the most significant position, so comparing the packed values gives 
+// the same result as comparing the bytes one at a time.
+#define MakeUnsignedWord(b1, b2) ((uint16_t)(((uint16_t)(uint8_t)(b1) << 8) | (uint16_t)(uint8_t)(b2)))
+#define MakeUnsignedDWord(b1, b2, b3, b4) ( ((uint32_t)MakeUnsignedWord((b1), (b2)) << 16) | (uint32_t)MakeUnsignedWord((b3), (b4)) )
+#define MakeUnsignedQWord(b1, b2, b3, b4, b5, b6, b7, b8) ( ((uint64_t)MakeUnsignedDWord((b1), (b2), (b3), (b4)) << 32) | (uint64_t)MakeUnsignedDWord((b5), (b6), (b7), (b8)) )
 
 static inline int CompareBytes(char b1, char b2)
 {
-	if (b1 > b2) return 1;
-	if (b1 < b2) return -1;
+	if ((uint8_t)b1 > (uint8_t)b2) return 1;
+	if ((uint8_t)b1 < (uint8_t)b2) return -1;
 	return 0;
 }
 
@@ -513,6 +1044,8 @@ static int CompareFields(const char *pV1, size_t idx1, const char *pV2, size_t i
 {
 	int result;
 
+	CountStat(compareFieldLengths[(count < SEMVER_STATS_FIELD_LENGTH_COUNT - 1) ? count : SEMVER_STATS_FIELD_LENGTH_COUNT - 1]);
+
 	pV1 += idx1;
 	pV2 += idx2;
 
@@ -603,7 +1136,7 @@ static int CompareFields(const char *pV1, size_t idx1, const char *pV2, size_t i
 			{
 				// Recursion should be safe, until we start seeing prerelease
 				// fields that are several hundred bytes long (unlikely).
-				result = CompareFields(pV1, idx1 + 8, pV2, idx2 + 8, count - 8);
+				result = CompareFields(pV1, 8, pV2, 8, count - 8);
 			}
 			break;
 	}
@@ -612,24 +1145,66 @@ static int CompareFields(const char *pV1, size_t idx1, const char *pV2, size_t i
 }
 
 
-// Applies sorting logic to prerelease tags.
-static int ComparePrereleaseTags(const char *pV1, const VersionParseRecord *pdr1, const char *pV2, const VersionParseRecord *pdr2)
+// CompareFields() for wide code units.  They're all ASCII by now, so this is
+// the same order.
+static int CompareWideFields(const void *pV1, size_t idx1, const void *pV2, size_t idx2, size_t count, size_t unitSize)
 {
-	if (pdr1->prereleaseFieldCount > pdr2->prereleaseFieldCount) return 1;
-	if (pdr1->prereleaseFieldCount < pdr2->prereleaseFieldCount) return -1;
-	// else they have the same number of fields, try comparing the field types and lengths.
+	CountStat(compareFieldLengths[(count < SEMVER_STATS_FIELD_LENGTH_COUNT - 1) ? count : SEMVER_STATS_FIELD_LENGTH_COUNT - 1]);
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		uint32_t unit1 = (sizeof(char16_t) == unitSize) ? ((const char16_t*)pV1)[idx1 + idx] : ((const char32_t*)pV1)[idx1 + idx];
+		uint32_t unit2 = (sizeof(char16_t) == unitSize) ? ((const char16_t*)pV2)[idx2 + idx] : ((const char32_t*)pV2)[idx2 + idx];
+
+		if (unit1 != unit2) return (unit1 > unit2) ? 1 : -1;
+	}
+
+	return 0;
+}
+
+static inline int CompareUnitFields(const void *pV1, size_t idx1, const void *pV2, size_t idx2, size_t count, size_t unitSize)
+{
+	if (sizeof(char) == unitSize) return CompareFields(pV1, idx1, pV2, idx2, count);
 
-	for (size_t idx = 0; idx < pdr1->prereleaseFieldCount; idx++)
+	return CompareWideFields(pV1, idx1, pV2, idx2, count, unitSize);
+}
+
+// Applies SemVer precedence rules to a pair of prerelease fields.
+static int ComparePrereleaseFields(const void *pV1, const ParsedTagRecord *ptr1, const void *pV2, const ParsedTagRecord *ptr2, size_t unitSize)
+{
+	// Numeric fields always have lower precedence than alphanumeric fields.
+	if (ptr1->fieldType > ptr2->fieldType) return 1;
+	if (ptr1->fieldType < ptr2->fieldType) return -1;
+
+	if (_numericT == ptr1->fieldType)
 	{
-		if (pdr1->pPrereleaseData[idx].fieldType > pdr2->pPrereleaseData[idx].fieldType) return 1;
-		if (pdr1->pPrereleaseData[idx].fieldType < pdr2->pPrereleaseData[idx].fieldType) return -1;
-		// else they have the same type, so check their lengths.
+		// No leading zeros, so the longer number is the bigger number.
+		if (ptr1->fieldLength > ptr2->fieldLength) return 1;
+		if (ptr1->fieldLength < ptr2->fieldLength) return -1;
+
+		return CompareUnitFields(pV1, ptr1->fieldIdx, pV2, ptr2->fieldIdx, ptr1->fieldLength, unitSize);
+	}
 
-		if (pdr1->pPrereleaseData[idx].fieldLength > pdr2->pPrereleaseData[idx].fieldLength) return 1;
-		if (pdr1->pPrereleaseData[idx].fieldLength < pdr2->pPrereleaseData[idx].fieldLength) return -1;
-		// else they have matching field lengths, now we must compare contents...
+	// Alphanumeric fields are compared lexically in ASCII order, so a field that
+	// is a prefix of the other one sorts first.
+	size_t commonLength = (ptr1->fieldLength < ptr2->fieldLength) ? ptr1->fieldLength : ptr2->fieldLength;
+	int result = CompareUnitFields(pV1, ptr1->fieldIdx, pV2, ptr2->fieldIdx, commonLength, unitSize);
 
-		int result = CompareFields(pV1, pdr1->pPrereleaseData[idx].fieldIdx, pV2, pdr2->pPrereleaseData[idx].fieldIdx, pdr1->pPrereleaseData[idx].fieldLength);
+	if (0 != result) return result;
+	if (ptr1->fieldLength > ptr2->fieldLength) return 1;
+	if (ptr1->fieldLength < ptr2->fieldLength) return -1;
+
+	return 0;
+}
+
+// Applies sorting logic to prerelease tags.
+static int ComparePrereleaseTags(const void *pV1, const VersionParseRecord *pdr1, const void *pV2, const VersionParseRecord *pdr2, size_t unitSize)
+{
+	size_t commonCount = (pdr1->prereleaseFieldCount < pdr2->prereleaseFieldCount) ? pdr1->prereleaseFieldCount : pdr2->prereleaseFieldCount;
+
+	for (size_t idx = 0; idx < commonCount; idx++)
+	{
+		int result = ComparePrereleaseFields(pV1, &pdr1->pPrereleaseData[idx], pV2, &pdr2->pPrereleaseData[idx], unitSize);
 
 		// When they compare the same, we have to compare the next field, if any.
 		if (0 == result) continue;
@@ -638,20 +1213,28 @@ static int ComparePrereleaseTags(const char *pV1, const VersionParseRecord *pdr1
 		return result;
 	}
 
-	// If we ran out of fields without returning a result, then they must be equal.
+	// If we ran out of fields without finding a difference, the one with more
+	// fields has the higher precedence.
+	if (pdr1->prereleaseFieldCount > pdr2->prereleaseFieldCount) return 1;
+	if (pdr1->prereleaseFieldCount < pdr2->prereleaseFieldCount) return -1;
+
 	return 0;
 }
 
-int CompareVersions(const char *pV1, const VersionParseRecord *pdr1, const char *pV2, const VersionParseRecord *pdr2)
+// CompareVersions(), for strings of unitSize code units.
+static int CompareUnitVersions(const void *pV1, const VersionParseRecord *pdr1, const void *pV2, const VersionParseRecord *pdr2, size_t unitSize)
 {
 	assert(NULL != pV1);
 	assert(NULL != pdr1);
 	assert(NULL != pV2);
 	assert(NULL != pdr2);
 
+	CountStat(compares);
+
 	if ( (pdr1->versionType != eSemVer_2_0_0) || (pdr2->versionType != eSemVer_2_0_0))
 	{
 		// We don't know how to compare non-SemVer strings.
+		CountStat(compareDecisions[eDecidedNotSemVer]);
 		return -2;
 	}
 
@@ -661,60 +1244,197 @@ int CompareVersions(const char *pV1, const VersionParseRecord *pdr1, const char
 
 	if (pdr1->majorDigits == pdr2->majorDigits)
 	{
-		int fieldCompareResult = CompareFields(pV1, 0, pV2, 0, pdr1->majorDigits);
+		int fieldCompareResult = CompareUnitFields(pV1, 0, pV2, 0, pdr1->majorDigits, unitSize);
 
 		if (0 != fieldCompareResult)
 		{
+			CountStat(compareDecisions[eDecidedAtMajor]);
 			return fieldCompareResult;
 		}
 
 		if (pdr1->minorDigits == pdr2->minorDigits)
 		{
-			fieldCompareResult = CompareFields(pV1, pdr1->minorIdx, pV2, pdr2->minorIdx, pdr1->minorDigits);
+			fieldCompareResult = CompareUnitFields(pV1, pdr1->minorIdx, pV2, pdr2->minorIdx, pdr1->minorDigits, unitSize);
 
 			if (0 != fieldCompareResult)
 			{
+				CountStat(compareDecisions[eDecidedAtMinor]);
 				return fieldCompareResult;
 			}
 
 			if (pdr1->patchDigits == pdr2->patchDigits)
 			{
-				fieldCompareResult = CompareFields(pV1, pdr1->patchIdx, pV2, pdr2->patchIdx, pdr1->patchDigits);
+				fieldCompareResult = CompareUnitFields(pV1, pdr1->patchIdx, pV2, pdr2->patchIdx, pdr1->patchDigits, unitSize);
 
 				if (0 != fieldCompareResult)
 				{
+					CountStat(compareDecisions[eDecidedAtPatch]);
 					return fieldCompareResult;
 				}
 
 				// At this point we have equal triples.
 				// If one or the other is lacking a prerlease tag, it's "bigger".
 				
-				if (pdr1->hasPrereleaseTag && !pdr2->hasPrereleaseTag) return 1;
-				if (!pdr1->hasPrereleaseTag && pdr2->hasPrereleaseTag) return -1;
-
-				if (pdr1->prereleaseFieldCount == pdr2->prereleaseFieldCount)
-				{
-					return ComparePrereleaseTags(pV1, pdr1, pV2, pdr2);
-				}
-				else
+				if (pdr1->hasPrereleaseTag != pdr2->hasPrereleaseTag)
 				{
-					return pdr1->prereleaseFieldCount > pdr2->prereleaseFieldCount ? 1 : -1;
+					CountStat(compareDecisions[eDecidedAtPrereleasePresence]);
+					return pdr1->hasPrereleaseTag ? -1 : 1;
 				}
+
+				CountStat(compareDecisions[eDecidedAtPrereleaseFields]);
+				return ComparePrereleaseTags(pV1, pdr1, pV2, pdr2, unitSize);
 			}
 			else
 			{
+				CountStat(compareDecisions[eDecidedAtPatch]);
 				return pdr1->patchDigits > pdr2->patchDigits ? 1 : -1;
 			}
 		}
 		else
 		{
+			CountStat(compareDecisions[eDecidedAtMinor]);
 			return pdr1->minorDigits > pdr2->minorDigits ? 1 : -1;
 		}
 	}
 	else
 	{
+		CountStat(compareDecisions[eDecidedAtMajor]);
 		return pdr1->majorDigits > pdr2->majorDigits ? 1 : -1;
 	}
 
 	return -2;
 }
+
+int CompareVersions(const char *pV1, const VersionParseRecord *pdr1, const char *pV2, const VersionParseRecord *pdr2)
+{
+	return CompareUnitVersions(pV1, pdr1, pV2, pdr2, sizeof(char));
+}
+
+int CompareVersions16(const char16_t *pV1, const VersionParseRecord *pdr1, const char16_t *pV2, const VersionParseRecord *pdr2)
+{
+	return CompareUnitVersions(pV1, pdr1, pV2, pdr2, sizeof(char16_t));
+}
+
+int CompareVersions32(const char32_t *pV1, const VersionParseRecord *pdr1, const char32_t *pV2, const VersionParseRecord *pdr2)
+{
+	return CompareUnitVersions(pV1, pdr1, pV2, pdr2, sizeof(char32_t));
+}
+
+ComponentStatus GetVersionComponent(const char *pVersion, VersionParseRecord *pParsed, VersionComponent component, uint64_t *pValue)
+{
+	assert(NULL != pVersion);
+	assert(NULL != pParsed);
+	assert(component < eVersionComponentCount);
+	assert(NULL != pValue);
+
+	if (eSemVer_2_0_0 != pParsed->versionType)
+	{
+		*pValue = 0;
+		return eComponentNotSemVer;
+	}
+
+	uint8_t bit = (uint8_t)(1 << component);
+
+	if (0 == (pParsed->componentsCached & bit))
+	{
+		size_t idx;
+		size_t digits;
+		uint64_t value = 0;
+
+		ComponentSpan(pParsed, component, &idx, &digits);
+
+		for (const char *pDigit = pVersion + idx; pDigit < pVersion + idx + digits; pDigit++)
+		{
+			unsigned digit = (unsigned)(*pDigit - _zero);
+
+			if (value > (UINT64_MAX - digit) / 10)
+			{
+				value = UINT64_MAX;
+				pParsed->componentsOverflowed |= bit;
+				break;
+			}
+
+			value = (value * 10) + digit;
+		}
+
+		pParsed->componentValues[component] = value;
+		pParsed->componentsCached |= bit;
+	}
+
+	*pValue = pParsed->componentValues[component];
+
+	return (0 != (pParsed->componentsOverflowed & bit)) ? eComponentOverflow : eComponentOk;
+}
+
+ComponentStatus GetVersionComponent128(const char *pVersion, const VersionParseRecord *pParsed, VersionComponent component, uint64_t *pHigh, uint64_t *pLow)
+{
+	assert(NULL != pVersion);
+	assert(NULL != pParsed);
+	assert(component < eVersionComponentCount);
+	assert((NULL != pHigh) && (NULL != pLow));
+
+	*pHigh = 0;
+	*pLow = 0;
+
+	if (eSemVer_2_0_0 != pParsed->versionType) return eComponentNotSemVer;
+
+	uint8_t bit = (uint8_t)(1 << component);
+
+	if ((0 != (pParsed->componentsCached & bit)) && (0 == (pParsed->componentsOverflowed & bit)))
+	{
+		*pLow = pParsed->componentValues[component];
+		return eComponentOk;
+	}
+
+	size_t idx;
+	size_t digits;
+
+	ComponentSpan(pParsed, component, &idx, &digits);
+
+	for (const char *pDigit = pVersion + idx; pDigit < pVersion + idx + digits; pDigit++)
+	{
+		if (!MultiplyAdd128(pHigh, pLow, (unsigned)(*pDigit - _zero)))
+		{
+			*pHigh = UINT64_MAX;
+			*pLow = UINT64_MAX;
+			return eComponentOverflow;
+		}
+	}
+
+	return eComponentOk;
+}
+
+bool GetSemVerStats(SemVerStats *pStats)
+{
+	assert(NULL != pStats);
+
+#ifdef SEMVER_STATS
+	*pStats = _stats;
+	return true;
+#else
+	memset(pStats, 0, sizeof(SemVerStats));
+	return false;
+#endif
+}
+
+void ResetSemVerStats(void)
+{
+#ifdef SEMVER_STATS
+	memset(&_stats, 0, sizeof(SemVerStats));
+#endif
+}
+
+void AddSemVerStats(SemVerStats *pTotal, const SemVerStats *pStats)
+{
+	assert(NULL != pTotal);
+	assert(NULL != pStats);
+
+	// SemVerStats is nothing but uint64_t counters.
+	uint64_t *pTo = (uint64_t*)pTotal;
+	const uint64_t *pFrom = (const uint64_t*)pStats;
+
+	for (size_t idx = 0; idx < sizeof(SemVerStats) / sizeof(uint64_t); idx++)
+	{
+		pTo[idx] += pFrom[idx];
+	}
+}
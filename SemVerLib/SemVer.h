@@ -13,6 +13,8 @@
 
 #include <stdlib.h>  // for size_t.
 #include <stdbool.h> // for bool.
+#include <stdint.h>  // for uint64_t.
+#include <uchar.h>   // for char16_t and char32_t.
 
 // The lack of an unambiguous distinction between v1 and v2 of SemVer
 // is it's most glaring defect.  But a v1 string also qualifies as a v2 string,
@@ -40,9 +42,32 @@ typedef enum
 	eInPreAlphaNumericField,
 	eInPreNumericField,
 	eInMetaFirstChar,
-	eInMetaField
+	eInMetaField,
+	eInLenientExtra		// Only reachable via ClassifyVersionCandidateLenient().
 } ParseState;
 
+// The parts of the version triple, for GetVersionComponent().
+typedef enum
+{
+	eVersionMajor = 0,
+	eVersionMinor,
+	eVersionPatch,
+	eVersionComponentCount
+} VersionComponent;
+
+// How GetVersionComponent() and GetVersionComponent128() went.
+typedef enum
+{
+	eComponentOk = 0,
+	eComponentOverflow,		// Too many digits for the width asked for.  The value is saturated.
+	eComponentNotSemVer		// The record isn't eSemVer_2_0_0, so there's no value.
+} ComponentStatus;
+
+// The classifier allocates prerelease and meta tag records in blocks of this
+// many, and grows them a block at a time.  Code that accounts for that memory
+// should use this, rather than a copy of it.
+#define VERSION_TAG_BLOCK_SIZE 5
+
 typedef struct _ParsedTagRecord
 {
 	// Points to first valid field character, not the delims.
@@ -56,6 +81,7 @@ typedef struct _ParsedTagRecord
 
 	// 'N' == numeric. Because 'N' < 'a' in the ASCII table.
 	// 'a' == alphanumeric. Becuase 'a' > 'N' in the ASCII table.
+	// Only applies to prerelease fields. Never set for meta.
 	char fieldType;
 
 } ParsedTagRecord;
@@ -80,6 +106,8 @@ typedef struct _VersionParseRecord
 	size_t majorDigits;
 	size_t minorDigits;
 	size_t patchDigits;
+
+	// Tag character counts don't include the delims.
 	size_t prereleaseChars;
 	size_t prereleaseFieldCount;
 	size_t metaChars;
@@ -116,8 +144,64 @@ typedef struct _VersionParseRecord
 	// For each character that is successfully parsed, parsedIdx is incremented.
 	size_t parsedIdx;
 
+	// The version triple's values, converted by GetVersionComponent() the first
+	// time each one is asked for.  Bit (1 << VersionComponent) of 
+	// componentsCached says the value is in componentValues, and the same bit
+	// of componentsOverflowed says it didn't fit.  Classification clears both.
+	uint64_t componentValues[eVersionComponentCount];
+	uint8_t componentsCached;
+	uint8_t componentsOverflowed;
+
 } VersionParseRecord;
 
+// The relaxations ClassifyVersionCandidateLenient() may apply to a near-SemVer
+// string.  These are bit flags, more than one may apply to the same string.
+typedef enum
+{
+	eRelaxedNone = 0,
+	eRelaxedPrefix = 0x01,				// "v1.2.3" or "V1.2.3".
+	eRelaxedMissingComponent = 0x02,	// "1" or "1.2", with or without tags.
+	eRelaxedExtraComponent = 0x04,		// "1.2.3.4", the fourth field is dropped.
+	eRelaxedLeadingZero = 0x08			// "01.2.3", "1.02.3" or "1.2.03".
+} Relaxation;
+
+// A run of characters in a version string.  
+typedef struct _VersionSpan
+{
+	size_t idx;
+	size_t length;
+} VersionSpan;
+
+// Describes the canonical SemVer view of a near-SemVer string, as offsets into
+// the original string.  The canonical string is: 
+//
+//   major '.' minor '.' patch tag
+//
+// where a zero length minor or patch stands for "0", and tag is copied verbatim
+// (including its leading '-' or '+') when its length is non-zero.  Nothing is
+// copied unless you ask FormatCanonicalVersion() to do it for you.
+typedef struct _LenientParseRecord
+{
+	// The classification of the canonical view.  eSemVer_2_0_0 means that the
+	// canonical view is SemVer 2 compliant, regardless of relaxations.
+	VersionType versionType;
+
+	// Bitwise OR of the Relaxation values that were applied.
+	unsigned relaxations;
+
+	// Leading zeros and prefixes are not included in these spans.
+	VersionSpan major;
+	VersionSpan minor;
+	VersionSpan patch;
+
+	// The dropped fourth component of "1.2.3.4" style strings.
+	VersionSpan extra;
+
+	// Prerelease and/or meta tag, starting at the '-' or '+' delimiter.
+	VersionSpan tag;
+
+} LenientParseRecord;
+
 /// <summary>
 /// Determine the best version type.
 /// </summary>
@@ -127,6 +211,85 @@ typedef struct _VersionParseRecord
 /// </remarks>
 extern VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, VersionParseRecord *pParsed);
 
+/// <summary>
+/// Same as ClassifyVersionCandidate(), but stops after length characters, so
+/// pCandidate can point into a larger buffer and needn't be null terminated.
+/// </summary>
+/// <remarks>
+/// Both narrow classifiers read bytes as unsigned.  A byte of 0x80 or more
+/// (UTF-8, Latin-1, or just binary) fails classification right there, the same
+/// as a wide unit outside of ASCII, whatever the locale or char signedness.
+/// </remarks>
+extern VersionParseRecord* ClassifyVersionCandidateN(const char *pCandidate, size_t length, VersionParseRecord *pParsed);
+
+/// <summary>
+/// Same as ClassifyVersionCandidateN(), but reads UTF-16 code units in place,
+/// with no transcoding.  Use SIZE_MAX for length if pCandidate is null 
+/// terminated.
+/// </summary>
+/// <remarks>
+/// Units are in the machine's byte order, which is UTF-16LE everywhere we 
+/// build.  The record's indexes and lengths count code units, and the first
+/// unit outside of ASCII fails classification right there, since SemVer is
+/// all ASCII.  Otherwise the record is exactly what ClassifyVersionCandidateN()
+/// gives for the same characters.
+/// </remarks>
+extern VersionParseRecord* ClassifyVersionCandidate16(const char16_t *pCandidate, size_t length, VersionParseRecord *pParsed);
+
+/// <summary>
+/// ClassifyVersionCandidate16(), for UTF-32.
+/// </summary>
+extern VersionParseRecord* ClassifyVersionCandidate32(const char32_t *pCandidate, size_t length, VersionParseRecord *pParsed);
+
+/// <summary>
+/// True if the first length characters of pCandidate (or up to the first null)
+/// are a SemVer 2.0.0 string.
+/// </summary>
+/// <remarks>
+/// Always gives the same verdict as ClassifyVersionCandidateN(), but records
+/// nothing, allocates nothing, and never looks at a character twice.  Use it 
+/// when yes or no is all you need.
+/// </remarks>
+extern bool IsSemVer(const char *pCandidate, size_t length);
+
+/// <summary>
+/// Frees the tag arrays that classification allocated, but not the record.
+/// </summary>
+/// <remarks>
+/// Call this before discarding, or re-using, a record you allocated yourself.
+/// Records allocated by passing NULL to a classifier must also be free()'d.
+/// </remarks>
+extern void FreeVersionParseData(VersionParseRecord *pParsed);
+
+/// <summary>
+/// Classify a candidate that may only be near-SemVer, in the same single pass
+/// as ClassifyVersionCandidate().
+/// </summary>
+/// <remarks>
+/// Prefixes ('v' or 'V'), missing minor/patch components, an extra fourth
+/// component and leading zeros in the version triple are tolerated, and 
+/// reported in pLenient->relaxations.  pParsed describes the raw string as 
+/// the relaxed parse saw it, so once a relaxation applies it can go further
+/// than ClassifyVersionCandidate() would, and its state may be 
+/// eInLenientExtra.  Its versionType is never eSemVer_2_0_0 when relaxations
+/// were applied.  Use pLenient->versionType to find out whether the canonical
+/// view is compliant.
+/// </remarks>
+extern VersionParseRecord* ClassifyVersionCandidateLenient(const char *pCandidate, VersionParseRecord *pParsed, LenientParseRecord *pLenient);
+
+/// <summary>
+/// Copy the canonical view of pCandidate into pBuffer.
+/// </summary>
+/// <param name="pCandidate">The string passed to ClassifyVersionCandidateLenient().</param>
+/// <param name="pLenient">The record it filled.</param>
+/// <param name="pBuffer">Receives the null terminated canonical string. May be NULL if bufferSize is zero.</param>
+/// <returns>
+/// The length of the canonical string, not including the terminating null.
+/// If the return value is >= bufferSize, the output was truncated.
+/// Zero if pLenient->versionType is not eSemVer_2_0_0.
+/// </returns>
+extern size_t FormatCanonicalVersion(const char *pCandidate, const LenientParseRecord *pLenient, char *pBuffer, size_t bufferSize);
+
 /// <summary>
 /// Applies SemVer rules to compare pV1 to pV2.
 /// </summary>
@@ -146,11 +309,55 @@ extern VersionParseRecord* ClassifyVersionCandidate(const char *pCandidate, Vers
 /// </returns>
 extern int CompareVersions(const char *pV1, const VersionParseRecord *pdr1, const char *pV2, const VersionParseRecord *pdr2);
 
+/// <summary>
+/// CompareVersions(), for strings classified by ClassifyVersionCandidate16().
+/// </summary>
+extern int CompareVersions16(const char16_t *pV1, const VersionParseRecord *pdr1, const char16_t *pV2, const VersionParseRecord *pdr2);
+
+/// <summary>
+/// CompareVersions(), for strings classified by ClassifyVersionCandidate32().
+/// </summary>
+extern int CompareVersions32(const char32_t *pV1, const VersionParseRecord *pdr1, const char32_t *pV2, const VersionParseRecord *pdr2);
+
+/// <summary>
+/// The value of one part of a SemVer string's version triple.
+/// </summary>
+/// <param name="pVersion">The string pParsed was classified from.</param>
+/// <param name="pParsed">
+/// The first call for each component converts its digits and caches the
+/// result here, later calls just return it.  So don't share a record between
+/// threads while calling this.
+/// </param>
+/// <param name="pValue">Receives the value, or UINT64_MAX if it overflowed.</param>
+/// <returns>
+/// eComponentOverflow for values bigger than UINT64_MAX, which SemVer allows.
+/// Use GetVersionComponent128() for those, or the digits themselves, which
+/// are exact at any length.
+/// </returns>
+extern ComponentStatus GetVersionComponent(const char *pVersion, VersionParseRecord *pParsed, VersionComponent component, uint64_t *pValue);
+
+/// <summary>
+/// GetVersionComponent() for values up to 128 bits, as two halves.
+/// </summary>
+/// <remarks>
+/// Values that fit in 64 bits come from the cache, when they're in it.  The
+/// rest are converted every time, so they cost nothing to the callers that
+/// never see one.
+/// </remarks>
+/// <param name="pHigh">Receives the top 64 bits, or UINT64_MAX if it overflowed.</param>
+/// <param name="pLow">Receives the bottom 64 bits, or UINT64_MAX if it overflowed.</param>
+extern ComponentStatus GetVersionComponent128(const char *pVersion, const VersionParseRecord *pParsed, VersionComponent component, uint64_t *pHigh, uint64_t *pLow);
+
 // Helpers.
 
-#define IsValidTagFieldChar(c) (isalpha(c) || isdigit(c) || ((char)(c) == '-'))
+// ASCII range checks, rather than ctype, so they don't depend on the locale,
+// and any char is safe to pass.
+#define IsValidTagFieldChar(c) ((('a' <= (c)) && ((c) <= 'z')) || (('A' <= (c)) && ((c) <= 'Z')) || (('0' <= (c)) && ((c) <= '9')) || ((char)(c) == '-'))
 #define IsValidPrereleaseFieldChar(c) IsValidTagFieldChar(c)
 #define IsValidMetaFieldChar(c) IsValidTagFieldChar(c)
 
+// Characters that can appear somewhere in a SemVer string.
+#define IsSemVerChar(c) (IsValidTagFieldChar(c) || ((char)(c) == '.') || ((char)(c) == '+'))
+
 #endif
 
@@ -0,0 +1,321 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerBatch.h"
+
+#include <assert.h>
+#include <memory.h>
+
+// Use SSE2 to compare four rows at a time, wherever we can count on having it.
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+ #define SEMVER_BATCH_SSE2
+ #include <emmintrin.h>
+#endif
+
+// Stores value in pColumn[row], if the caller asked for that column.
+#define SetColumn(pColumn, row, value) do { if (NULL != (pColumn)) (pColumn)[(row)] = (value); } while (0)
+
+// SelectVersionColumn() compares this many rows at a time, one bitmap word.
+#define SELECT_CHUNK_ROWS 64
+
+// One version, and the column it's being compared against.
+typedef struct
+{
+	const char *pVersion;
+	const VersionParseRecord *pParsed;
+	uint32_t major;
+	uint32_t minor;
+	uint32_t patch;
+	bool hasPrerelease;
+	// True when a field is too big for the value columns.
+	bool saturated;
+	const char * const *ppCandidates;
+	const size_t *pLengths;
+	const VersionColumns *pColumns;
+} ColumnCompare;
+
+// Private functions in alphabetical order...
+
+// The full CompareVersions() treatment, for rows the columns can't decide.
+static int8_t CompareRowStrings(const ColumnCompare *pCompare, size_t row)
+{
+	VersionParseRecord record;
+	size_t length = (NULL != pCompare->pLengths) ? pCompare->pLengths[row] : SIZE_MAX;
+
+	ClassifyVersionCandidateN(pCompare->ppCandidates[row], length, &record);
+
+	int result = CompareVersions(pCompare->ppCandidates[row], &record, pCompare->pVersion, pCompare->pParsed);
+
+	FreeVersionParseData(&record);
+	return (int8_t)result;
+}
+
+static inline int CompareValues(uint32_t value1, uint32_t value2)
+{
+	return (value1 < value2) ? -1 : ((value1 > value2) ? 1 : 0);
+}
+
+// The value of count digits, or VERSION_COLUMN_VALUE_MAX if that's less.
+static uint32_t FieldValue(const char *pDigits, size_t count)
+{
+	uint64_t value = 0;
+
+	if (count > 10) return VERSION_COLUMN_VALUE_MAX;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		value = (value * 10) + (uint64_t)(pDigits[idx] - '0');
+	}
+
+	return (value > VERSION_COLUMN_VALUE_MAX) ? VERSION_COLUMN_VALUE_MAX : (uint32_t)value;
+}
+
+// Finish a row, given how its triple compares to the version's.
+static int8_t FinishRow(const ColumnCompare *pCompare, size_t row, int tripleResult)
+{
+	const VersionColumns *pColumns = pCompare->pColumns;
+
+	if (eSemVer_2_0_0 != pColumns->pVersionType[row]) return -2;
+	if (pCompare->saturated) return CompareRowStrings(pCompare, row);
+	if (0 != tripleResult) return (int8_t)tripleResult;
+
+	// A prerelease is older than its release.
+	bool rowHasPrerelease = (0 != pColumns->pPrereleaseLength[row]);
+
+	if (rowHasPrerelease != pCompare->hasPrerelease) return rowHasPrerelease ? -1 : 1;
+	if (!rowHasPrerelease) return 0;
+
+	return CompareRowStrings(pCompare, row);
+}
+
+// Compare rows [first, first + count) into pResults[0 ... count - 1].
+static void CompareRows(const ColumnCompare *pCompare, size_t first, size_t count, int8_t *pResults)
+{
+	const VersionColumns *pColumns = pCompare->pColumns;
+	size_t row = first;
+	size_t end = first + count;
+
+#ifdef SEMVER_BATCH_SSE2
+	const __m128i major = _mm_set1_epi32((int)pCompare->major);
+	const __m128i minor = _mm_set1_epi32((int)pCompare->minor);
+	const __m128i patch = _mm_set1_epi32((int)pCompare->patch);
+
+	for (; !pCompare->saturated && (row + 4 <= end); row += 4)
+	{
+		__m128i majors = _mm_loadu_si128((const __m128i*)(pColumns->pMajorValue + row));
+		__m128i minors = _mm_loadu_si128((const __m128i*)(pColumns->pMinorValue + row));
+		__m128i patches = _mm_loadu_si128((const __m128i*)(pColumns->pPatchValue + row));
+
+		// Lexicographic, major first.  All ones in the lanes where it's true.
+		__m128i majorEqual = _mm_cmpeq_epi32(majors, major);
+		__m128i minorEqual = _mm_cmpeq_epi32(minors, minor);
+		__m128i greater = _mm_or_si128(_mm_cmpgt_epi32(majors, major),
+			_mm_and_si128(majorEqual, _mm_or_si128(_mm_cmpgt_epi32(minors, minor), _mm_and_si128(minorEqual, _mm_cmpgt_epi32(patches, patch)))));
+		__m128i less = _mm_or_si128(_mm_cmplt_epi32(majors, major),
+			_mm_and_si128(majorEqual, _mm_or_si128(_mm_cmplt_epi32(minors, minor), _mm_and_si128(minorEqual, _mm_cmplt_epi32(patches, patch)))));
+
+		// less - greater is -1, 0 or 1 in each lane, narrowed to bytes.
+		__m128i results = _mm_sub_epi32(less, greater);
+		results = _mm_packs_epi16(_mm_packs_epi32(results, results), results);
+
+		uint32_t types;
+		uint32_t packed = (uint32_t)_mm_cvtsi128_si32(results);
+		int decided = _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(less, greater)));
+		int8_t *pOut = pResults + (row - first);
+
+		memcpy(&types, pColumns->pVersionType + row, sizeof(types));
+		memcpy(pOut, &packed, sizeof(packed));
+
+		// Ties, and rows that aren't SemVer, are rare enough to finish one by one.
+		if ((0xF != decided) || ((eSemVer_2_0_0 * 0x01010101u) != types))
+		{
+			for (size_t lane = 0; lane < 4; lane++)
+			{
+				pOut[lane] = FinishRow(pCompare, row + lane, pOut[lane]);
+			}
+		}
+	}
+#endif
+
+	for (; row < end; row++)
+	{
+		int tripleResult = CompareValues(pColumns->pMajorValue[row], pCompare->major);
+
+		if (0 == tripleResult) tripleResult = CompareValues(pColumns->pMinorValue[row], pCompare->minor);
+		if (0 == tripleResult) tripleResult = CompareValues(pColumns->pPatchValue[row], pCompare->patch);
+
+		pResults[row - first] = FinishRow(pCompare, row, tripleResult);
+	}
+}
+
+// Fill in everything about pVersion that CompareRows() needs.  False if it
+// isn't SemVer.
+static bool InitColumnCompare(ColumnCompare *pCompare, const char *pVersion, const VersionParseRecord *pParsed, const char * const *ppCandidates, const size_t *pLengths, const VersionColumns *pColumns)
+{
+	assert(NULL != pVersion);
+	assert(NULL != pParsed);
+	assert(NULL != pColumns);
+	assert(NULL != pColumns->pVersionType);
+	assert((NULL != pColumns->pMajorValue) && (NULL != pColumns->pMinorValue) && (NULL != pColumns->pPatchValue));
+	assert(NULL != pColumns->pPrereleaseLength);
+
+	memset(pCompare, 0, sizeof(ColumnCompare));
+
+	pCompare->pVersion = pVersion;
+	pCompare->pParsed = pParsed;
+	pCompare->ppCandidates = ppCandidates;
+	pCompare->pLengths = pLengths;
+	pCompare->pColumns = pColumns;
+
+	if (eSemVer_2_0_0 != pParsed->versionType) return false;
+
+	pCompare->major = FieldValue(pVersion, pParsed->majorDigits);
+	pCompare->minor = FieldValue(pVersion + pParsed->minorIdx, pParsed->minorDigits);
+	pCompare->patch = FieldValue(pVersion + pParsed->patchIdx, pParsed->patchDigits);
+	pCompare->hasPrerelease = pParsed->hasPrereleaseTag;
+	pCompare->saturated = (VERSION_COLUMN_VALUE_MAX == pCompare->major)
+		|| (VERSION_COLUMN_VALUE_MAX == pCompare->minor)
+		|| (VERSION_COLUMN_VALUE_MAX == pCompare->patch);
+
+	return true;
+}
+
+size_t ClassifyVersionBatch(const char * const *ppCandidates, const size_t *pLengths, size_t count, const VersionColumns *pColumns)
+{
+	assert((NULL != ppCandidates) || (0 == count));
+	assert(NULL != pColumns);
+
+	// One record for the whole batch, we only need its scalar fields.
+	VersionParseRecord record;
+	size_t semVerCount = 0;
+
+	for (size_t row = 0; row < count; row++)
+	{
+		size_t length = (NULL != pLengths) ? pLengths[row] : SIZE_MAX;
+
+		ClassifyVersionCandidateN(ppCandidates[row], length, &record);
+
+		if ((eSemVer_2_0_0 != record.versionType) || (record.parsedIdx > UINT32_MAX))
+		{
+			FreeVersionParseData(&record);
+
+			VersionType versionType = (eSemVer_2_0_0 != record.versionType) ? record.versionType : eUnknownVersion;
+
+			SetColumn(pColumns->pVersionType, row, (uint8_t)versionType);
+			SetColumn(pColumns->pMajorDigits, row, 0);
+			SetColumn(pColumns->pMinorIdx, row, 0);
+			SetColumn(pColumns->pMinorDigits, row, 0);
+			SetColumn(pColumns->pPatchIdx, row, 0);
+			SetColumn(pColumns->pPatchDigits, row, 0);
+			SetColumn(pColumns->pPrereleaseIdx, row, 0);
+			SetColumn(pColumns->pPrereleaseLength, row, 0);
+			SetColumn(pColumns->pPrereleaseFieldCount, row, 0);
+			SetColumn(pColumns->pMetaIdx, row, 0);
+			SetColumn(pColumns->pMetaLength, row, 0);
+			SetColumn(pColumns->pMetaFieldCount, row, 0);
+			SetColumn(pColumns->pMajorValue, row, 0);
+			SetColumn(pColumns->pMinorValue, row, 0);
+			SetColumn(pColumns->pPatchValue, row, 0);
+			continue;
+		}
+
+		semVerCount++;
+
+		// The prerelease tag starts right after the patch and runs up to the 
+		// meta tag, if there is one, and the meta tag runs to the end.
+		size_t endIdx = record.parsedIdx;
+		size_t prereleaseLength = 0;
+		size_t prereleaseIdx = 0;
+		size_t metaLength = 0;
+		size_t metaIdx = 0;
+
+		if (record.hasMetaTag)
+		{
+			metaIdx = record.pMetaData[0].fieldIdx;
+			metaLength = endIdx - metaIdx;
+			endIdx = metaIdx - 1;
+		}
+
+		if (record.hasPrereleaseTag)
+		{
+			prereleaseIdx = record.pPrereleaseData[0].fieldIdx;
+			prereleaseLength = endIdx - prereleaseIdx;
+		}
+
+		FreeVersionParseData(&record);
+
+		SetColumn(pColumns->pVersionType, row, (uint8_t)eSemVer_2_0_0);
+		SetColumn(pColumns->pMajorDigits, row, (uint32_t)record.majorDigits);
+		SetColumn(pColumns->pMinorIdx, row, (uint32_t)record.minorIdx);
+		SetColumn(pColumns->pMinorDigits, row, (uint32_t)record.minorDigits);
+		SetColumn(pColumns->pPatchIdx, row, (uint32_t)record.patchIdx);
+		SetColumn(pColumns->pPatchDigits, row, (uint32_t)record.patchDigits);
+		SetColumn(pColumns->pPrereleaseIdx, row, (uint32_t)prereleaseIdx);
+		SetColumn(pColumns->pPrereleaseLength, row, (uint32_t)prereleaseLength);
+		SetColumn(pColumns->pPrereleaseFieldCount, row, (uint32_t)record.prereleaseFieldCount);
+		SetColumn(pColumns->pMetaIdx, row, (uint32_t)metaIdx);
+		SetColumn(pColumns->pMetaLength, row, (uint32_t)metaLength);
+		SetColumn(pColumns->pMetaFieldCount, row, (uint32_t)record.metaFieldCount);
+		SetColumn(pColumns->pMajorValue, row, FieldValue(ppCandidates[row], record.majorDigits));
+		SetColumn(pColumns->pMinorValue, row, FieldValue(ppCandidates[row] + record.minorIdx, record.minorDigits));
+		SetColumn(pColumns->pPatchValue, row, FieldValue(ppCandidates[row] + record.patchIdx, record.patchDigits));
+	}
+
+	return semVerCount;
+}
+
+void CompareVersionColumn(const char *pVersion, const VersionParseRecord *pParsed, const char * const *ppCandidates, const size_t *pLengths, const VersionColumns *pColumns, size_t count, int8_t *pResults)
+{
+	assert((NULL != pResults) || (0 == count));
+
+	ColumnCompare compare;
+
+	if (!InitColumnCompare(&compare, pVersion, pParsed, ppCandidates, pLengths, pColumns))
+	{
+		memset(pResults, -2, count);
+		return;
+	}
+
+	CompareRows(&compare, 0, count, pResults);
+}
+
+size_t SelectVersionColumn(const char *pVersion, const VersionParseRecord *pParsed, const char * const *ppCandidates, const size_t *pLengths, const VersionColumns *pColumns, size_t count, int wanted, uint64_t *pBitmap)
+{
+	assert((NULL != pBitmap) || (0 == count));
+
+	ColumnCompare compare;
+	bool comparable = InitColumnCompare(&compare, pVersion, pParsed, ppCandidates, pLengths, pColumns);
+	size_t selected = 0;
+
+	for (size_t first = 0; first < count; first += SELECT_CHUNK_ROWS)
+	{
+		int8_t results[SELECT_CHUNK_ROWS];
+		size_t chunk = ((count - first) < SELECT_CHUNK_ROWS) ? (count - first) : SELECT_CHUNK_ROWS;
+		uint64_t bits = 0;
+
+		if (comparable)
+		{
+			CompareRows(&compare, first, chunk, results);
+		}
+		else
+		{
+			memset(results, -2, chunk);
+		}
+
+		for (size_t idx = 0; idx < chunk; idx++)
+		{
+			bits |= (uint64_t)(wanted == results[idx]) << idx;
+		}
+
+		pBitmap[first / SELECT_CHUNK_ROWS] = bits;
+
+		for (; 0 != bits; bits &= bits - 1) selected++;
+	}
+
+	return selected;
+}
@@ -0,0 +1,103 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerBatch_h_Defined
+#define _SharperHacks_SemVerBatch_h_Defined
+
+#include <stdint.h>
+
+#include "SemVer.h"
+
+// Parallel arrays (structure of arrays) that ClassifyVersionBatch() fills, one
+// element per candidate.  They're all caller provided, and any of them can be
+// NULL if you don't need that column.
+//
+// Indexes are relative to the start of each candidate string, and point to the
+// first character of the field, not the delims.  Lengths don't include delims,
+// so a prerelease tag of "alpha.1" has a length of 7 and a field count of 2.
+// Every column except pVersionType is zero for rows that aren't SemVer.
+//
+// 32 bits is plenty for anything that looks like a version string, and keeps
+// the columns small enough to stream straight into a database bulk load.
+//
+// The value columns hold the numbers in the version triple, with anything
+// bigger than VERSION_COLUMN_VALUE_MAX stored as VERSION_COLUMN_VALUE_MAX.
+// That's also the largest signed 32 bit value, so SIMD signed compares work.
+typedef struct _VersionColumns
+{
+	uint8_t *pVersionType;		// VersionType values.
+
+	uint32_t *pMajorDigits;		// Major always starts at index zero.
+	uint32_t *pMinorIdx;
+	uint32_t *pMinorDigits;
+	uint32_t *pPatchIdx;
+	uint32_t *pPatchDigits;
+
+	uint32_t *pPrereleaseIdx;
+	uint32_t *pPrereleaseLength;
+	uint32_t *pPrereleaseFieldCount;
+
+	uint32_t *pMetaIdx;
+	uint32_t *pMetaLength;
+	uint32_t *pMetaFieldCount;
+
+	uint32_t *pMajorValue;
+	uint32_t *pMinorValue;
+	uint32_t *pPatchValue;
+
+} VersionColumns;
+
+#define VERSION_COLUMN_VALUE_MAX 0x7FFFFFFFu
+
+/// <summary>
+/// Classify count candidates, and split them into columns.
+/// </summary>
+/// <param name="ppCandidates">Array of count version strings.</param>
+/// <param name="pLengths">
+/// Array of count string lengths, or NULL if the strings are null terminated.
+/// </param>
+/// <param name="pColumns">Column arrays, each with room for count elements.</param>
+/// <returns>The number of candidates that are eSemVer_2_0_0.</returns>
+/// <remarks>
+/// No per-row records are returned, so nothing needs to be freed.  Candidates 
+/// longer than UINT32_MAX are reported as eUnknownVersion.
+/// </remarks>
+extern size_t ClassifyVersionBatch(const char * const *ppCandidates, const size_t *pLengths, size_t count, const VersionColumns *pColumns);
+
+/// <summary>
+/// Compare every row of a column against one version.  pResults[row] is 
+/// exactly what CompareVersions(ppCandidates[row], ..., pVersion, pParsed) 
+/// would return.
+/// </summary>
+/// <remarks>
+/// Rows are decided from the value columns, four at a time with SSE2 where
+/// we have it, and the prerelease lengths.  Only rows whose triple ties with
+/// pVersion, where both have a prerelease tag, are classified again and 
+/// compared as strings.  When a field of pVersion is too big for the value 
+/// columns, every row is.
+/// </remarks>
+/// <param name="ppCandidates">The strings passed to ClassifyVersionBatch().</param>
+/// <param name="pLengths">The lengths passed to ClassifyVersionBatch().</param>
+/// <param name="pColumns">
+/// Filled by ClassifyVersionBatch(), and must include the type, value and 
+/// prerelease length columns.
+/// </param>
+/// <param name="pResults">Receives count results: -1, 0, 1, or -2 for rows that aren't SemVer.</param>
+extern void CompareVersionColumn(const char *pVersion, const VersionParseRecord *pParsed, const char * const *ppCandidates, const size_t *pLengths, const VersionColumns *pColumns, size_t count, int8_t *pResults);
+
+/// <summary>
+/// Same as CompareVersionColumn(), but sets a bit for each row whose result
+/// is wanted, and clears the rest.  Bit (row % 64) of pBitmap[row / 64].
+/// </summary>
+/// <param name="wanted">-1 for rows older than pVersion, 0 for equal or 1 for newer.</param>
+/// <returns>How many bits were set.</returns>
+extern size_t SelectVersionColumn(const char *pVersion, const VersionParseRecord *pParsed, const char * const *ppCandidates, const size_t *pLengths, const VersionColumns *pColumns, size_t count, int wanted, uint64_t *pBitmap);
+
+#endif
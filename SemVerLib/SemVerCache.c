@@ -0,0 +1,244 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerCache.h"
+#include "SemVerThreads.h"
+
+#include <assert.h>
+#include <memory.h>
+#include <stdint.h>
+
+// Each string can only live in one bucket of this many entries.
+static const size_t _bucketEntries = 4;
+
+// FNV-1a.
+static const uint64_t _hashSeed = 0xCBF29CE484222325ull;
+static const uint64_t _hashPrime = 0x100000001B3ull;
+
+typedef struct
+{
+	// Zero until the entry is first written, and odd while it's being written.
+	SemVerAtomic sequence;
+	// Set by lookups, cleared by writers passing the entry over for eviction.
+	SemVerAtomic recentlyUsed;
+	uint64_t hash;
+	size_t length;
+	// The tag arrays are always NULL, the tags are in tags[].
+	VersionParseRecord record;
+	ParsedTagRecord tags[VERSION_CACHE_MAX_TAGS];
+	char text[VERSION_CACHE_MAX_LENGTH];
+} CacheEntry;
+
+struct _VersionParseCache
+{
+	CacheEntry *pEntries;
+	size_t bucketMask;
+};
+
+// Private functions in alphabetical order...
+
+// Copy a record's tags, prerelease first, into one array.
+static void GatherTags(const VersionParseRecord *pParsed, ParsedTagRecord *pTags)
+{
+	if (0 != pParsed->prereleaseFieldCount)
+	{
+		memcpy(pTags, pParsed->pPrereleaseData, pParsed->prereleaseFieldCount * sizeof(ParsedTagRecord));
+	}
+
+	if (0 != pParsed->metaFieldCount)
+	{
+		memcpy(pTags + pParsed->prereleaseFieldCount, pParsed->pMetaData, pParsed->metaFieldCount * sizeof(ParsedTagRecord));
+	}
+}
+
+static inline CacheEntry* GetBucket(const VersionParseCache *pCache, uint64_t hash)
+{
+	return &pCache->pEntries[(hash & pCache->bucketMask) * _bucketEntries];
+}
+
+static uint64_t HashVersion(const char *pCandidate, size_t length)
+{
+	uint64_t hash = _hashSeed;
+
+	for (size_t idx = 0; idx < length; idx++)
+	{
+		hash = (hash ^ (unsigned char)pCandidate[idx]) * _hashPrime;
+	}
+
+	return hash;
+}
+
+// Add a version to the cache, unless another thread is writing the entry it
+// would replace.
+static void InsertVersion(VersionParseCache *pCache, uint64_t hash, const char *pCandidate, size_t length, const VersionParseRecord *pParsed)
+{
+	CacheEntry *pBucket = GetBucket(pCache, hash);
+	size_t first = (size_t)(hash >> 32) % _bucketEntries;
+	CacheEntry *pVictim = NULL;
+
+	// Second chance: the first entry that's empty, or hasn't been used since
+	// it was last passed over, goes.  A bucket full of hot entries gives up
+	// the first one.
+	for (size_t step = 0; (NULL == pVictim) && (step < 2 * _bucketEntries); step++)
+	{
+		CacheEntry *pEntry = &pBucket[(first + step) % _bucketEntries];
+
+		if ((0 == LoadSemVerAtomic(&pEntry->sequence)) || (0 == LoadSemVerAtomic(&pEntry->recentlyUsed)))
+		{
+			pVictim = pEntry;
+		}
+		else
+		{
+			StoreSemVerAtomic(&pEntry->recentlyUsed, 0);
+		}
+	}
+
+	if (NULL == pVictim) pVictim = &pBucket[first];
+
+	long sequence = LoadSemVerAtomic(&pVictim->sequence);
+
+	if ((0 != (sequence & 1)) || !CompareExchangeSemVerAtomic(&pVictim->sequence, sequence, (long)((unsigned long)sequence + 1)))
+	{
+		return;
+	}
+
+	pVictim->hash = hash;
+	pVictim->length = length;
+	pVictim->record = *pParsed;
+	pVictim->record.pPrereleaseData = NULL;
+	pVictim->record.pMetaData = NULL;
+	GatherTags(pParsed, pVictim->tags);
+	memcpy(pVictim->text, pCandidate, length);
+	StoreSemVerAtomic(&pVictim->recentlyUsed, 0);
+
+	StoreSemVerAtomic(&pVictim->sequence, (long)((unsigned long)sequence + 2));
+}
+
+// Point the record's tag arrays at the result's own tags.
+static void SetTagPointers(CachedVersion *pResult)
+{
+	VersionParseRecord *pRecord = &pResult->record;
+
+	pRecord->pPrereleaseData = (0 != pRecord->prereleaseFieldCount) ? pResult->tags : NULL;
+	pRecord->pMetaData = (0 != pRecord->metaFieldCount) ? pResult->tags + pRecord->prereleaseFieldCount : NULL;
+	pResult->ownsTags = false;
+}
+
+// Copy a version's entry out of the cache, if it's there.
+static bool LookupVersion(const VersionParseCache *pCache, uint64_t hash, const char *pCandidate, size_t length, CachedVersion *pResult)
+{
+	CacheEntry *pBucket = GetBucket(pCache, hash);
+
+	for (size_t idx = 0; idx < _bucketEntries; idx++)
+	{
+		CacheEntry *pEntry = &pBucket[idx];
+		long sequence = LoadSemVerAtomic(&pEntry->sequence);
+
+		if ((0 == sequence) || (0 != (sequence & 1))) continue;
+
+		// If a writer gets in while we're looking, these reads may be garbage,
+		// but they're bounded, and the sequence number will tell us to ignore them.
+		if ((pEntry->hash != hash) || (pEntry->length != length) || (0 != memcmp(pEntry->text, pCandidate, length))) continue;
+
+		pResult->record = pEntry->record;
+
+		// A torn count is bounded here, and thrown away below.
+		size_t tagCount = pResult->record.prereleaseFieldCount + pResult->record.metaFieldCount;
+
+		if (tagCount > VERSION_CACHE_MAX_TAGS) tagCount = VERSION_CACHE_MAX_TAGS;
+
+		memcpy(pResult->tags, pEntry->tags, tagCount * sizeof(ParsedTagRecord));
+
+		SemVerAcquireFence();
+
+		if (LoadSemVerAtomic(&pEntry->sequence) != sequence) continue;
+
+		// Only write the shared line when it changes something.
+		if (0 == LoadSemVerAtomic(&pEntry->recentlyUsed)) StoreSemVerAtomic(&pEntry->recentlyUsed, 1);
+
+		SetTagPointers(pResult);
+		return true;
+	}
+
+	return false;
+}
+
+VersionParseCache* CreateVersionParseCache(size_t capacity)
+{
+	VersionParseCache *pCache = calloc(1, sizeof(VersionParseCache));
+
+	if (NULL == pCache) return NULL;
+
+	size_t bucketCount = 1;
+
+	while (bucketCount * _bucketEntries < capacity) bucketCount *= 2;
+
+	pCache->bucketMask = bucketCount - 1;
+	pCache->pEntries = calloc(bucketCount * _bucketEntries, sizeof(CacheEntry));
+
+	if (NULL == pCache->pEntries)
+	{
+		free(pCache);
+		return NULL;
+	}
+
+	return pCache;
+}
+
+void FreeVersionParseCache(VersionParseCache *pCache)
+{
+	if (NULL == pCache) return;
+
+	free(pCache->pEntries);
+	free(pCache);
+}
+
+const VersionParseRecord* ClassifyVersionCandidateCached(VersionParseCache *pCache, const char *pCandidate, size_t length, CachedVersion *pResult)
+{
+	assert(NULL != pCandidate);
+	assert(NULL != pResult);
+
+	bool cacheable = (NULL != pCache) && (length <= VERSION_CACHE_MAX_LENGTH);
+	uint64_t hash = 0;
+
+	if (cacheable)
+	{
+		hash = HashVersion(pCandidate, length);
+
+		if (LookupVersion(pCache, hash, pCandidate, length, pResult)) return &pResult->record;
+	}
+
+	VersionParseRecord parsed;
+
+	ClassifyVersionCandidateN(pCandidate, length, &parsed);
+
+	if (parsed.prereleaseFieldCount + parsed.metaFieldCount > VERSION_CACHE_MAX_TAGS)
+	{
+		pResult->record = parsed;
+		pResult->ownsTags = true;
+		return &pResult->record;
+	}
+
+	if (cacheable) InsertVersion(pCache, hash, pCandidate, length, &parsed);
+
+	pResult->record = parsed;
+	GatherTags(&parsed, pResult->tags);
+	SetTagPointers(pResult);
+	FreeVersionParseData(&parsed);
+
+	return &pResult->record;
+}
+
+void FreeCachedVersion(CachedVersion *pResult)
+{
+	assert(NULL != pResult);
+
+	if (pResult->ownsTags) FreeVersionParseData(&pResult->record);
+
+	pResult->ownsTags = false;
+}
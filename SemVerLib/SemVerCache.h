@@ -0,0 +1,77 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerCache_h_Defined
+#define _SharperHacks_SemVerCache_h_Defined
+
+#include "SemVer.h"
+
+// The longest string, and the most tag fields, a cache entry can hold.  
+// Anything bigger is classified every time.
+#define VERSION_CACHE_MAX_LENGTH 64
+#define VERSION_CACHE_MAX_TAGS 8
+
+// A fixed size table of parse results, keyed by string content, that any
+// number of threads can share.
+//
+// Lookups never lock, block, or allocate, and never write to shared memory
+// unless they find an entry whose recently used bit isn't set yet.  Each 
+// entry is guarded by a sequence number that's odd while it's being written:
+// a lookup copies the entry out, and only trusts the copy if the sequence
+// number didn't change meanwhile.  A lookup that races a writer simply misses.
+//
+// Memory is allocated once, up front.  Each string hashes to a bucket of four
+// entries, and a miss replaces the first entry in the bucket that hasn't been 
+// used since the last time it was passed over (second chance).  Writers that
+// collide on an entry don't wait, the loser just doesn't cache its result.
+typedef struct _VersionParseCache VersionParseCache;
+
+// Parse results returned by the cache, which belong to the caller.  The 
+// record's tag arrays point into tags[], unless the version had more tag 
+// fields than that.
+typedef struct _CachedVersion
+{
+	VersionParseRecord record;
+	ParsedTagRecord tags[VERSION_CACHE_MAX_TAGS];
+
+	// True if the record's tag arrays are on the heap.  Hands off.
+	bool ownsTags;
+} CachedVersion;
+
+/// <summary>
+/// Create a cache with room for at least capacity versions.
+/// </summary>
+/// <returns>NULL if we're out of memory.</returns>
+extern VersionParseCache* CreateVersionParseCache(size_t capacity);
+
+/// <summary>
+/// Free the cache.  No other thread may be using it.
+/// </summary>
+extern void FreeVersionParseCache(VersionParseCache *pCache);
+
+/// <summary>
+/// Same as ClassifyVersionCandidateN(), but looks in the cache first, and 
+/// adds to it on a miss.
+/// </summary>
+/// <param name="pCache">May be NULL, to classify without a cache.</param>
+/// <param name="pResult">
+/// Receives the parse results.  Pass it to FreeCachedVersion() when you're
+/// done with it, which costs nothing unless the version had more than 
+/// VERSION_CACHE_MAX_TAGS tag fields.
+/// </param>
+/// <returns>&pResult->record.</returns>
+extern const VersionParseRecord* ClassifyVersionCandidateCached(VersionParseCache *pCache, const char *pCandidate, size_t length, CachedVersion *pResult);
+
+/// <summary>
+/// Free any tag arrays ClassifyVersionCandidateCached() had to allocate.
+/// </summary>
+extern void FreeCachedVersion(CachedVersion *pResult);
+
+#endif
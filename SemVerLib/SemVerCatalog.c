@@ -0,0 +1,512 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerCatalog.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+ #define WIN32_LEAN_AND_MEAN
+ #include <windows.h>
+#else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+static const char _catalogMagic[8] = "SVCATLG";
+static const uint32_t _catalogFormatVersion = 1;
+static const uint32_t _catalogByteOrderMark = 0x01020304;
+
+// Sections start on this boundary, and the file size is a multiple of it.
+static const size_t _sectionAlignment = 8;
+
+static const size_t _initialCapacity = 256;
+
+// FNV-1a offset basis.
+static const uint64_t _checksumSeed = 0xCBF29CE484222325ull;
+
+// The writer keeps the three sections in memory until they're saved.
+struct _VersionCatalogWriter
+{
+	VersionCatalogEntry *pEntries;
+	size_t entryCount;
+	size_t entryCapacity;
+
+	ParsedTagRecord *pTags;
+	size_t tagCount;
+	size_t tagCapacity;
+
+	char *pStrings;
+	size_t stringBytes;
+	size_t stringCapacity;
+};
+
+//-------------------------------------------------------------------------------------------------
+// Private helpers, alphabetical order.
+
+static size_t AlignSection(size_t size)
+{
+	return (size + _sectionAlignment - 1) & ~(_sectionAlignment - 1);
+}
+
+// FNV-1a, but eight bytes at a time rather than one.  The input is always a
+// multiple of eight bytes, because every section is padded, so this can be
+// run over each section in turn with the same result as over the whole file.
+static uint64_t ChecksumWords(uint64_t checksum, const void *pData, size_t size)
+{
+	assert(0 == (size % sizeof(uint64_t)));
+
+	const unsigned char *pBytes = (const unsigned char*)pData;
+
+	for (size_t idx = 0; idx < size; idx += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, pBytes + idx, sizeof(word));
+		checksum = (checksum ^ word) * 0x100000001B3ull;
+	}
+
+	return checksum;
+}
+
+// Check that an entry's string, and every index its record holds, is inside
+// the catalog.  A matching checksum can't promise that, and when the checksum
+// isn't verified nothing else does.
+static bool EntryFits(const VersionCatalog *pCatalog, const VersionCatalogEntry *pEntry)
+{
+	const VersionCatalogHeader *pHeader = pCatalog->pHeader;
+	uint64_t length = pEntry->stringLength;
+
+	if ((pEntry->stringOffset >= pHeader->stringBytes) || (length >= pHeader->stringBytes - pEntry->stringOffset)) return false;
+	if ('\0' != pCatalog->pStrings[pEntry->stringOffset + length]) return false;
+
+	if (   (pEntry->majorDigits > length)
+		|| ((uint64_t)pEntry->minorIdx + pEntry->minorDigits > length)
+		|| ((uint64_t)pEntry->patchIdx + pEntry->patchDigits > length)
+		|| (pEntry->parsedIdx > length))
+	{
+		return false;
+	}
+
+	uint64_t tagCount = (uint64_t)pEntry->prereleaseFieldCount + pEntry->metaFieldCount;
+
+	if ((pEntry->firstTagIdx > pHeader->tagCount) || (tagCount > pHeader->tagCount - pEntry->firstTagIdx)) return false;
+
+	const ParsedTagRecord *pTags = &pCatalog->pTags[pEntry->firstTagIdx];
+
+	for (uint64_t idx = 0; idx < tagCount; idx++)
+	{
+		if ((pTags[idx].fieldIdx > length) || (pTags[idx].fieldLength > length - pTags[idx].fieldIdx)) return false;
+	}
+
+	return true;
+}
+
+// Make room for count more elements in a dynamic array.
+static bool Reserve(void **ppArray, size_t *pCapacity, size_t used, size_t count, size_t elementSize)
+{
+	if (used + count <= *pCapacity) return true;
+
+	size_t capacity = (0 == *pCapacity) ? _initialCapacity : *pCapacity;
+
+	while (capacity < used + count)
+	{
+		capacity *= 2;
+	}
+
+	if (capacity > (SIZE_MAX / elementSize)) return false;
+
+	void *pGrown = realloc(*ppArray, capacity * elementSize);
+
+	if (NULL == pGrown) return false;
+
+	*ppArray = pGrown;
+	*pCapacity = capacity;
+
+	return true;
+}
+
+// Check that count elements of elementSize at offset fit in the file.
+static bool SectionFits(const VersionCatalogHeader *pHeader, uint64_t offset, uint64_t count, size_t elementSize)
+{
+	if ((offset < sizeof(VersionCatalogHeader)) || (0 != (offset % _sectionAlignment))) return false;
+	if (offset > pHeader->fileSize) return false;
+	if (count > ((pHeader->fileSize - offset) / elementSize)) return false;
+
+	return true;
+}
+
+static bool WriteSection(FILE *pFile, const void *pData, size_t size, uint64_t *pChecksum)
+{
+	static const char padding[8] = { 0 };
+	size_t padded = AlignSection(size);
+
+	if ((0 != size) && (1 != fwrite(pData, size, 1, pFile))) return false;
+	if ((padded != size) && (1 != fwrite(padding, padded - size, 1, pFile))) return false;
+
+	// Hash exactly what we wrote, padding included.
+	size_t whole = size & ~(_sectionAlignment - 1);
+	*pChecksum = ChecksumWords(*pChecksum, pData, whole);
+
+	if (whole != size)
+	{
+		char tail[8] = { 0 };
+		memcpy(tail, (const char*)pData + whole, size - whole);
+		*pChecksum = ChecksumWords(*pChecksum, tail, sizeof(tail));
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Writing.
+
+VersionCatalogWriter* CreateVersionCatalogWriter(void)
+{
+	return (VersionCatalogWriter*)calloc(1, sizeof(VersionCatalogWriter));
+}
+
+bool AppendVersionCatalogEntry(VersionCatalogWriter *pWriter, const char *pVersion, size_t length)
+{
+	assert(NULL != pWriter);
+	assert((NULL != pVersion) || (0 == length));
+
+	if (length > UINT32_MAX) return false;
+
+	VersionParseRecord record;
+
+	ClassifyVersionCandidateN((NULL != pVersion) ? pVersion : "", length, &record);
+
+	size_t tagCount = record.prereleaseFieldCount + record.metaFieldCount;
+
+	if (   !Reserve((void**)&pWriter->pEntries, &pWriter->entryCapacity, pWriter->entryCount, 1, sizeof(VersionCatalogEntry))
+		|| !Reserve((void**)&pWriter->pTags, &pWriter->tagCapacity, pWriter->tagCount, tagCount, sizeof(ParsedTagRecord))
+		|| !Reserve((void**)&pWriter->pStrings, &pWriter->stringCapacity, pWriter->stringBytes, length + 1, sizeof(char)))
+	{
+		FreeVersionParseData(&record);
+		return false;
+	}
+
+	VersionCatalogEntry *pEntry = &pWriter->pEntries[pWriter->entryCount];
+	memset(pEntry, 0, sizeof(*pEntry));
+
+	pEntry->stringOffset = pWriter->stringBytes;
+	pEntry->firstTagIdx = pWriter->tagCount;
+	pEntry->stringLength = (uint32_t)length;
+	pEntry->majorDigits = (uint32_t)record.majorDigits;
+	pEntry->minorIdx = (uint32_t)record.minorIdx;
+	pEntry->minorDigits = (uint32_t)record.minorDigits;
+	pEntry->patchIdx = (uint32_t)record.patchIdx;
+	pEntry->patchDigits = (uint32_t)record.patchDigits;
+	pEntry->prereleaseChars = (uint32_t)record.prereleaseChars;
+	pEntry->prereleaseFieldCount = (uint32_t)record.prereleaseFieldCount;
+	pEntry->metaChars = (uint32_t)record.metaChars;
+	pEntry->metaFieldCount = (uint32_t)record.metaFieldCount;
+	pEntry->parsedIdx = (uint32_t)record.parsedIdx;
+	pEntry->versionType = (uint8_t)record.versionType;
+	pEntry->state = (uint8_t)record.state;
+
+	if (record.hasPrereleaseTag) pEntry->flags |= eCatalogHasPrereleaseTag;
+	if (record.hasMetaTag) pEntry->flags |= eCatalogHasMetaTag;
+	if (record.isPrereleaseVersion) pEntry->flags |= eCatalogIsPrereleaseVersion;
+	if (record.majorHasLeadingZero) pEntry->flags |= eCatalogMajorHasLeadingZero;
+	if (record.minorHasLeadingZero) pEntry->flags |= eCatalogMinorHasLeadingZero;
+	if (record.patchHasLeadingZero) pEntry->flags |= eCatalogPatchHasLeadingZero;
+
+	if (0 != record.prereleaseFieldCount)
+	{
+		memcpy(&pWriter->pTags[pWriter->tagCount], record.pPrereleaseData, record.prereleaseFieldCount * sizeof(ParsedTagRecord));
+		pWriter->tagCount += record.prereleaseFieldCount;
+	}
+
+	if (0 != record.metaFieldCount)
+	{
+		memcpy(&pWriter->pTags[pWriter->tagCount], record.pMetaData, record.metaFieldCount * sizeof(ParsedTagRecord));
+		pWriter->tagCount += record.metaFieldCount;
+	}
+
+	if (0 != length)
+	{
+		memcpy(&pWriter->pStrings[pWriter->stringBytes], pVersion, length);
+	}
+
+	pWriter->pStrings[pWriter->stringBytes + length] = '\0';
+	pWriter->stringBytes += length + 1;
+	pWriter->entryCount++;
+
+	FreeVersionParseData(&record);
+
+	return true;
+}
+
+CatalogStatus SaveVersionCatalog(VersionCatalogWriter *pWriter, const char *pFileName)
+{
+	assert(NULL != pWriter);
+	assert(NULL != pFileName);
+
+	VersionCatalogHeader header;
+	memset(&header, 0, sizeof(header));
+
+	memcpy(header.magic, _catalogMagic, sizeof(header.magic));
+	header.formatVersion = _catalogFormatVersion;
+	header.byteOrderMark = _catalogByteOrderMark;
+	header.sizeOfSizeT = (uint32_t)sizeof(size_t);
+	header.sizeOfTagRecord = (uint32_t)sizeof(ParsedTagRecord);
+	header.entryCount = pWriter->entryCount;
+	header.entriesOffset = AlignSection(sizeof(VersionCatalogHeader));
+	header.tagCount = pWriter->tagCount;
+	header.tagsOffset = header.entriesOffset + AlignSection(pWriter->entryCount * sizeof(VersionCatalogEntry));
+	header.stringBytes = pWriter->stringBytes;
+	header.stringsOffset = header.tagsOffset + AlignSection(pWriter->tagCount * sizeof(ParsedTagRecord));
+	header.fileSize = header.stringsOffset + AlignSection(pWriter->stringBytes);
+
+	FILE *pFile = NULL;
+
+#ifdef _MSC_VER
+	if (0 != fopen_s(&pFile, pFileName, "wb")) pFile = NULL;
+#else
+	pFile = fopen(pFileName, "wb");
+#endif
+
+	if (NULL == pFile) return eCatalogIoError;
+
+	// Write a placeholder header, then go back for it once the checksum is known.
+	uint64_t checksum = _checksumSeed;
+	uint64_t ignored = 0;
+
+	bool ok = WriteSection(pFile, &header, sizeof(header), &ignored)
+		&& WriteSection(pFile, pWriter->pEntries, pWriter->entryCount * sizeof(VersionCatalogEntry), &checksum)
+		&& WriteSection(pFile, pWriter->pTags, pWriter->tagCount * sizeof(ParsedTagRecord), &checksum)
+		&& WriteSection(pFile, pWriter->pStrings, pWriter->stringBytes, &checksum);
+
+	if (ok)
+	{
+		header.checksum = checksum;
+		ok = (0 == fseek(pFile, 0, SEEK_SET)) && (1 == fwrite(&header, sizeof(header), 1, pFile));
+	}
+
+	if (0 != fclose(pFile)) ok = false;
+
+	return ok ? eCatalogOk : eCatalogIoError;
+}
+
+void FreeVersionCatalogWriter(VersionCatalogWriter *pWriter)
+{
+	if (NULL == pWriter) return;
+
+	free(pWriter->pEntries);
+	free(pWriter->pTags);
+	free(pWriter->pStrings);
+	free(pWriter);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Mapping.
+
+#ifdef _WIN32
+
+static bool MapFile(const char *pFileName, VersionCatalog *pCatalog)
+{
+	HANDLE hFile = CreateFileA(pFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (INVALID_HANDLE_VALUE == hFile) return false;
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(hFile, &size) || (0 == size.QuadPart) || ((uint64_t)size.QuadPart > SIZE_MAX))
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (NULL == hMapping)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	void *pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (NULL == pView)
+	{
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return false;
+	}
+
+	pCatalog->pView = pView;
+	pCatalog->viewSize = (size_t)size.QuadPart;
+	pCatalog->hFile = hFile;
+	pCatalog->hMapping = hMapping;
+
+	return true;
+}
+
+static void UnmapFile(VersionCatalog *pCatalog)
+{
+	if (NULL != pCatalog->pView) UnmapViewOfFile(pCatalog->pView);
+	if (NULL != pCatalog->hMapping) CloseHandle((HANDLE)pCatalog->hMapping);
+	if (NULL != pCatalog->hFile) CloseHandle((HANDLE)pCatalog->hFile);
+}
+
+#else
+
+static bool MapFile(const char *pFileName, VersionCatalog *pCatalog)
+{
+	int fd = open(pFileName, O_RDONLY);
+
+	if (fd < 0) return false;
+
+	struct stat info;
+
+	if ((0 != fstat(fd, &info)) || (0 == info.st_size) || ((uint64_t)info.st_size > SIZE_MAX))
+	{
+		close(fd);
+		return false;
+	}
+
+	void *pView = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping holds its own reference to the file.
+	close(fd);
+
+	if (MAP_FAILED == pView) return false;
+
+	pCatalog->pView = pView;
+	pCatalog->viewSize = (size_t)info.st_size;
+
+	return true;
+}
+
+static void UnmapFile(VersionCatalog *pCatalog)
+{
+	if (NULL != pCatalog->pView) munmap(pCatalog->pView, pCatalog->viewSize);
+}
+
+#endif
+
+CatalogStatus OpenVersionCatalog(const char *pFileName, bool verifyChecksum, VersionCatalog *pCatalog)
+{
+	assert(NULL != pFileName);
+	assert(NULL != pCatalog);
+
+	memset(pCatalog, 0, sizeof(*pCatalog));
+
+	if (!MapFile(pFileName, pCatalog)) return eCatalogIoError;
+
+	const VersionCatalogHeader *pHeader = (const VersionCatalogHeader*)pCatalog->pView;
+	CatalogStatus status = eCatalogOk;
+
+	if (   (pCatalog->viewSize < sizeof(VersionCatalogHeader))
+		|| (0 != memcmp(pHeader->magic, _catalogMagic, sizeof(pHeader->magic)))
+		|| (_catalogFormatVersion != pHeader->formatVersion)
+		|| (_catalogByteOrderMark != pHeader->byteOrderMark)
+		|| (sizeof(size_t) != pHeader->sizeOfSizeT)
+		|| (sizeof(ParsedTagRecord) != pHeader->sizeOfTagRecord)
+		|| (pCatalog->viewSize != pHeader->fileSize)
+		|| !SectionFits(pHeader, pHeader->entriesOffset, pHeader->entryCount, sizeof(VersionCatalogEntry))
+		|| !SectionFits(pHeader, pHeader->tagsOffset, pHeader->tagCount, sizeof(ParsedTagRecord))
+		|| !SectionFits(pHeader, pHeader->stringsOffset, pHeader->stringBytes, sizeof(char))
+		|| (0 != (pHeader->fileSize % _sectionAlignment)))
+	{
+		status = eCatalogBadFormat;
+	}
+	else if (verifyChecksum)
+	{
+		size_t payloadOffset = (size_t)pHeader->entriesOffset;
+		uint64_t checksum = ChecksumWords(_checksumSeed, (const char*)pCatalog->pView + payloadOffset, pCatalog->viewSize - payloadOffset);
+
+		if (checksum != pHeader->checksum) status = eCatalogBadChecksum;
+	}
+
+	if (eCatalogOk != status)
+	{
+		CloseVersionCatalog(pCatalog);
+		return status;
+	}
+
+	const char *pBase = (const char*)pCatalog->pView;
+
+	pCatalog->pHeader = pHeader;
+	pCatalog->pEntries = (const VersionCatalogEntry*)(pBase + pHeader->entriesOffset);
+	pCatalog->pTags = (const ParsedTagRecord*)(pBase + pHeader->tagsOffset);
+	pCatalog->pStrings = pBase + pHeader->stringsOffset;
+	pCatalog->entryCount = (size_t)pHeader->entryCount;
+
+	return eCatalogOk;
+}
+
+void CloseVersionCatalog(VersionCatalog *pCatalog)
+{
+	if (NULL == pCatalog) return;
+
+	UnmapFile(pCatalog);
+	memset(pCatalog, 0, sizeof(*pCatalog));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Access.
+
+const char* GetCatalogVersion(const VersionCatalog *pCatalog, size_t idx, VersionParseRecord *pParsed)
+{
+	assert(NULL != pCatalog);
+	assert(idx < pCatalog->entryCount);
+	assert(NULL != pParsed);
+
+	const VersionCatalogEntry *pEntry = &pCatalog->pEntries[idx];
+
+	memset(pParsed, 0, sizeof(*pParsed));
+
+	if (!EntryFits(pCatalog, pEntry)) return NULL;
+
+	// The classifier never writes through these, and neither does CompareVersions(),
+	// so it's safe to hand out pointers into the read-only mapping.
+	ParsedTagRecord *pTags = (ParsedTagRecord*)&pCatalog->pTags[pEntry->firstTagIdx];
+
+	pParsed->versionType = (VersionType)pEntry->versionType;
+	pParsed->majorDigits = pEntry->majorDigits;
+	pParsed->minorDigits = pEntry->minorDigits;
+	pParsed->patchDigits = pEntry->patchDigits;
+	pParsed->prereleaseChars = pEntry->prereleaseChars;
+	pParsed->prereleaseFieldCount = pEntry->prereleaseFieldCount;
+	pParsed->metaChars = pEntry->metaChars;
+	pParsed->metaFieldCount = pEntry->metaFieldCount;
+	pParsed->minorIdx = pEntry->minorIdx;
+	pParsed->patchIdx = pEntry->patchIdx;
+	pParsed->isPrereleaseVersion = (0 != (pEntry->flags & eCatalogIsPrereleaseVersion));
+	pParsed->hasPrereleaseTag = (0 != (pEntry->flags & eCatalogHasPrereleaseTag));
+	pParsed->hasMetaTag = (0 != (pEntry->flags & eCatalogHasMetaTag));
+	pParsed->majorHasLeadingZero = (0 != (pEntry->flags & eCatalogMajorHasLeadingZero));
+	pParsed->minorHasLeadingZero = (0 != (pEntry->flags & eCatalogMinorHasLeadingZero));
+	pParsed->patchHasLeadingZero = (0 != (pEntry->flags & eCatalogPatchHasLeadingZero));
+	pParsed->pPrereleaseData = (0 != pEntry->prereleaseFieldCount) ? pTags : NULL;
+	pParsed->pMetaData = (0 != pEntry->metaFieldCount) ? pTags + pEntry->prereleaseFieldCount : NULL;
+	pParsed->state = (ParseState)pEntry->state;
+	pParsed->parsedIdx = pEntry->parsedIdx;
+
+	return pCatalog->pStrings + pEntry->stringOffset;
+}
+
+int CompareCatalogVersions(const VersionCatalog *pCatalog, size_t idx1, size_t idx2)
+{
+	VersionParseRecord record1;
+	VersionParseRecord record2;
+
+	const char *pV1 = GetCatalogVersion(pCatalog, idx1, &record1);
+	const char *pV2 = GetCatalogVersion(pCatalog, idx2, &record2);
+
+	if ((NULL == pV1) || (NULL == pV2)) return -2;
+
+	return CompareVersions(pV1, &record1, pV2, &record2);
+}
@@ -0,0 +1,169 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerCatalog_h_Defined
+#define _SharperHacks_SemVerCatalog_h_Defined
+
+#include <stdint.h>
+
+#include "SemVer.h"
+
+// A version catalog is a file of version strings and their parse results, laid
+// out so that it can be memory mapped and used as-is.  Everything in it is an 
+// offset or an index, so there are no pointers to fix-up after loading:
+//
+//   VersionCatalogHeader
+//   VersionCatalogEntry[entryCount]	One per version string.
+//   ParsedTagRecord[tagCount]			Prerelease fields, then meta fields, per entry.
+//   char[stringBytes]					Null terminated version strings.
+//
+// Each section starts on an eight byte boundary.  The file is written in the
+// byte order and ParsedTagRecord layout of the machine that wrote it, and the
+// header records enough about both that a foreign catalog is rejected rather
+// than misread.  The checksum covers everything after the header.
+
+typedef enum
+{
+	eCatalogOk = 0,
+	eCatalogIoError,		// Couldn't open, read, map or write the file.
+	eCatalogBadFormat,		// Not a catalog, a foreign or newer catalog, or truncated.
+	eCatalogBadChecksum		// Looks like a catalog, but it's been damaged.
+} CatalogStatus;
+
+typedef enum
+{
+	eCatalogHasPrereleaseTag = 0x01,
+	eCatalogHasMetaTag = 0x02,
+	eCatalogIsPrereleaseVersion = 0x04,
+	eCatalogMajorHasLeadingZero = 0x08,
+	eCatalogMinorHasLeadingZero = 0x10,
+	eCatalogPatchHasLeadingZero = 0x20
+} CatalogEntryFlag;
+
+typedef struct _VersionCatalogHeader
+{
+	char magic[8];				// "SVCATLG" and a null.
+	uint32_t formatVersion;
+	uint32_t byteOrderMark;		// 0x01020304, as the writer stored it.
+	uint32_t sizeOfSizeT;
+	uint32_t sizeOfTagRecord;
+	uint64_t fileSize;
+	uint64_t entryCount;
+	uint64_t entriesOffset;
+	uint64_t tagCount;
+	uint64_t tagsOffset;
+	uint64_t stringBytes;
+	uint64_t stringsOffset;
+	uint64_t checksum;
+} VersionCatalogHeader;
+
+// The compact form of a VersionParseRecord.  Indexes are relative to the start 
+// of the entry's string, just like they are in the record.
+typedef struct _VersionCatalogEntry
+{
+	uint64_t stringOffset;		// From the start of the string section.
+	uint64_t firstTagIdx;		// Into the tag section.
+	uint32_t stringLength;		// Not counting the null.
+	uint32_t majorDigits;
+	uint32_t minorIdx;
+	uint32_t minorDigits;
+	uint32_t patchIdx;
+	uint32_t patchDigits;
+	uint32_t prereleaseChars;
+	uint32_t prereleaseFieldCount;
+	uint32_t metaChars;
+	uint32_t metaFieldCount;
+	uint32_t parsedIdx;
+	uint8_t versionType;
+	uint8_t state;				// The ParseState classification stopped in.
+	uint8_t flags;				// CatalogEntryFlag bits.
+	uint8_t reserved;
+} VersionCatalogEntry;
+
+// An open catalog.  The section pointers point straight into the mapped file.
+typedef struct _VersionCatalog
+{
+	const VersionCatalogHeader *pHeader;
+	const VersionCatalogEntry *pEntries;
+	const ParsedTagRecord *pTags;
+	const char *pStrings;
+	size_t entryCount;
+
+	// Platform specific mapping state.  Hands off.
+	void *pView;
+	size_t viewSize;
+	void *hFile;
+	void *hMapping;
+} VersionCatalog;
+
+// Accumulates versions for SaveVersionCatalog().  Opaque.
+typedef struct _VersionCatalogWriter VersionCatalogWriter;
+
+/// <summary>
+/// Create an empty catalog writer.
+/// </summary>
+/// <returns>NULL if we're out of memory.</returns>
+extern VersionCatalogWriter* CreateVersionCatalogWriter(void);
+
+/// <summary>
+/// Classify a version string and add it, and its parse results, to the catalog.
+/// </summary>
+/// <param name="pVersion">Need not be null terminated.</param>
+/// <param name="length">Count of characters in pVersion.</param>
+/// <returns>
+/// False if we're out of memory, or the string is longer than UINT32_MAX.
+/// Strings that aren't SemVer are added too, so entry indexes always match
+/// the order of the calls.
+/// </returns>
+extern bool AppendVersionCatalogEntry(VersionCatalogWriter *pWriter, const char *pVersion, size_t length);
+
+/// <summary>
+/// Write everything appended so far to pFileName.
+/// </summary>
+extern CatalogStatus SaveVersionCatalog(VersionCatalogWriter *pWriter, const char *pFileName);
+
+extern void FreeVersionCatalogWriter(VersionCatalogWriter *pWriter);
+
+/// <summary>
+/// Map a catalog into memory.
+/// </summary>
+/// <param name="verifyChecksum">
+/// When false, the header is still validated, but the rest of the file is not
+/// touched until you use it, so opening even a very large catalog is nearly
+/// free.  Only skip verification for files you trust.
+/// </param>
+/// <param name="pCatalog">Receives the open catalog.</param>
+extern CatalogStatus OpenVersionCatalog(const char *pFileName, bool verifyChecksum, VersionCatalog *pCatalog);
+
+extern void CloseVersionCatalog(VersionCatalog *pCatalog);
+
+/// <summary>
+/// Get the string and parse results for catalog entry idx, without copying 
+/// either of them.
+/// </summary>
+/// <param name="pParsed">
+/// Receives a record whose tag arrays point into the catalog.  It's only valid
+/// until the catalog is closed, and must never be passed to 
+/// FreeVersionParseData().
+/// </param>
+/// <returns>
+/// The null terminated version string, or NULL if the entry points outside of
+/// the catalog, which only a damaged file can do.  The checksum doesn't rule
+/// that out, so every entry is checked.
+/// </returns>
+extern const char* GetCatalogVersion(const VersionCatalog *pCatalog, size_t idx, VersionParseRecord *pParsed);
+
+/// <summary>
+/// Same as CompareVersions(), for two catalog entries.
+/// </summary>
+/// <returns>-1, 0 or 1, or -2 if either isn't SemVer, or is damaged.</returns>
+extern int CompareCatalogVersions(const VersionCatalog *pCatalog, size_t idx1, size_t idx2);
+
+#endif
@@ -0,0 +1,424 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerIndex.h"
+#include "SemVerThreads.h"
+
+#include <assert.h>
+#include <memory.h>
+#include <string.h>
+
+// Don't bother with another thread for less than this many queries.
+#define MIN_QUERIES_PER_THREAD 1024
+
+// The slot FindContainingRangesBatch() gives versions that aren't SemVer.
+#define NO_SLOT SIZE_MAX
+
+// One thread's slice of a batch.  The first pass fills in pSlots, and the 
+// match counts in pStarts, the second copies the ids.
+typedef struct
+{
+	const VersionRangeIndex *pIndex;
+	const SortableVersion *pVersions;
+	size_t *pSlots;
+	size_t *pStarts;
+	uint32_t *pRangeIds;
+	size_t first;
+	size_t last;
+} BatchTask;
+
+// Private functions in alphabetical order...
+
+// Count, or store, id at a node.  Storing moves the node's start along.
+static inline void AddToNode(VersionRangeIndex *pIndex, size_t node, uint32_t id, bool store)
+{
+	if (store) pIndex->pRangeIds[pIndex->pNodeStarts[node]] = id;
+
+	pIndex->pNodeStarts[node]++;
+}
+
+// Count, or store, id at each of the nodes that exactly cover slots first to 
+// last, bottom up.
+static void CoverSlots(VersionRangeIndex *pIndex, size_t first, size_t last, uint32_t id, bool store)
+{
+	for (size_t left = first + pIndex->leafCount, right = last + pIndex->leafCount + 1; left < right; left /= 2, right /= 2)
+	{
+		if (0 != (left & 1)) AddToNode(pIndex, left++, id, store);
+		if (0 != (right & 1)) AddToNode(pIndex, --right, id, store);
+	}
+}
+
+// The number of bounds less than or equal to a SemVer version, which is its slot.
+static size_t FindSlot(const VersionRangeIndex *pIndex, const char *pVersion, const VersionParseRecord *pParsed)
+{
+	uint64_t key = GetPrecedenceKey(pVersion, pParsed);
+	size_t low = 0;
+	size_t high = pIndex->boundCount;
+
+	while (low < high)
+	{
+		size_t mid = low + ((high - low) / 2);
+		const VersionBound *pBound = &pIndex->pBounds[mid];
+		bool isBoundAbove = (key != pIndex->pKeys[mid])
+			? (key < pIndex->pKeys[mid])
+			: (CompareVersions(pVersion, pParsed, pBound->pVersion, &pBound->record) < 0);
+
+		if (isBoundAbove)
+		{
+			high = mid;
+		}
+		else
+		{
+			low = mid + 1;
+		}
+	}
+
+	return low;
+}
+
+// Copy the distinct bounds out of pSorted, which is in CompareVersions() order.
+static bool BuildBounds(VersionRangeIndex *pIndex, const SortableVersion *pSorted, size_t count)
+{
+	size_t distinctCount = 0;
+	size_t textBytes = 0;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		if ((0 == idx) || (0 != CompareSortableVersions(&pSorted[idx - 1], &pSorted[idx])))
+		{
+			distinctCount++;
+			textBytes += strlen(pSorted[idx].pVersion) + 1;
+		}
+	}
+
+	pIndex->pBounds = malloc(((0 == distinctCount) ? 1 : distinctCount) * sizeof(VersionBound));
+	pIndex->pKeys = malloc(((0 == distinctCount) ? 1 : distinctCount) * sizeof(uint64_t));
+	pIndex->pText = malloc((0 == textBytes) ? 1 : textBytes);
+
+	if ((NULL == pIndex->pBounds) || (NULL == pIndex->pKeys) || (NULL == pIndex->pText)) return false;
+
+	char *pNext = pIndex->pText;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		if ((0 != idx) && (0 == CompareSortableVersions(&pSorted[idx - 1], &pSorted[idx]))) continue;
+
+		VersionBound *pBound = &pIndex->pBounds[pIndex->boundCount];
+		size_t length = strlen(pSorted[idx].pVersion);
+
+		memcpy(pNext, pSorted[idx].pVersion, length + 1);
+		pBound->pVersion = pNext;
+		ClassifyVersionCandidateN(pNext, length, &pBound->record);
+		pIndex->pKeys[pIndex->boundCount++] = GetPrecedenceKey(pNext, &pBound->record);
+		pNext += length + 1;
+	}
+
+	return true;
+}
+
+// Store every interval of every set in the tree, once the bounds are in place.
+static bool BuildTree(VersionRangeIndex *pIndex, const VersionRangeSet *pRanges, size_t count)
+{
+	pIndex->leafCount = 1;
+
+	while (pIndex->leafCount < pIndex->boundCount + 1) pIndex->leafCount *= 2;
+
+	pIndex->pNodeStarts = calloc((2 * pIndex->leafCount) + 1, sizeof(size_t));
+
+	if (NULL == pIndex->pNodeStarts) return false;
+
+	// The first pass counts the ids at each node, the second stores them.
+	for (int pass = 0; pass < 2; pass++)
+	{
+		bool store = (1 == pass);
+
+		for (size_t rangeIdx = 0; rangeIdx < count; rangeIdx++)
+		{
+			const VersionRangeSet *pSet = &pRanges[rangeIdx];
+
+			for (size_t idx = 0; idx < pSet->count; idx++)
+			{
+				const VersionBound *pLower = &pSet->pIntervals[idx].lower;
+				const VersionBound *pUpper = &pSet->pIntervals[idx].upper;
+
+				// Versions from the lower bound, up to but not including the upper.
+				size_t first = (NULL == pLower->pVersion) ? 0 : FindSlot(pIndex, pLower->pVersion, &pLower->record);
+				size_t last = (NULL == pUpper->pVersion) ? pIndex->boundCount : FindSlot(pIndex, pUpper->pVersion, &pUpper->record) - 1;
+
+				CoverSlots(pIndex, first, last, (uint32_t)rangeIdx, store);
+			}
+		}
+
+		if (!store)
+		{
+			// Turn the counts into starts.
+			size_t total = 0;
+
+			for (size_t node = 0; node < 2 * pIndex->leafCount; node++)
+			{
+				size_t nodeCount = pIndex->pNodeStarts[node];
+				pIndex->pNodeStarts[node] = total;
+				total += nodeCount;
+			}
+
+			pIndex->pRangeIds = malloc(((0 == total) ? 1 : total) * sizeof(uint32_t));
+
+			if (NULL == pIndex->pRangeIds) return false;
+		}
+	}
+
+	// Storing left each start where the next node's starts, so shift them back.
+	memmove(pIndex->pNodeStarts + 1, pIndex->pNodeStarts, 2 * pIndex->leafCount * sizeof(size_t));
+	pIndex->pNodeStarts[0] = 0;
+
+	return true;
+}
+
+// The number of ids at the nodes from the slot's leaf to the root.
+static size_t CountSlotMatches(const VersionRangeIndex *pIndex, size_t slot)
+{
+	size_t found = 0;
+
+	for (size_t node = pIndex->leafCount + slot; node > 0; node /= 2)
+	{
+		found += pIndex->pNodeStarts[node + 1] - pIndex->pNodeStarts[node];
+	}
+
+	return found;
+}
+
+static void CountTaskProc(void *pArg)
+{
+	BatchTask *pTask = (BatchTask*)pArg;
+
+	for (size_t idx = pTask->first; idx < pTask->last; idx++)
+	{
+		const SortableVersion *pVersion = &pTask->pVersions[idx];
+
+		// An index that was never built matches nothing.
+		if ((eSemVer_2_0_0 == pVersion->record.versionType) && (NULL != pTask->pIndex->pNodeStarts))
+		{
+			pTask->pSlots[idx] = FindSlot(pTask->pIndex, pVersion->pVersion, &pVersion->record);
+			pTask->pStarts[idx + 1] = CountSlotMatches(pTask->pIndex, pTask->pSlots[idx]);
+		}
+		else
+		{
+			pTask->pSlots[idx] = NO_SLOT;
+			pTask->pStarts[idx + 1] = 0;
+		}
+	}
+}
+
+static void StoreTaskProc(void *pArg)
+{
+	BatchTask *pTask = (BatchTask*)pArg;
+	const VersionRangeIndex *pIndex = pTask->pIndex;
+
+	for (size_t idx = pTask->first; idx < pTask->last; idx++)
+	{
+		if (NO_SLOT == pTask->pSlots[idx]) continue;
+
+		uint32_t *pOut = pTask->pRangeIds + pTask->pStarts[idx];
+
+		for (size_t node = pIndex->leafCount + pTask->pSlots[idx]; node > 0; node /= 2)
+		{
+			size_t nodeCount = pIndex->pNodeStarts[node + 1] - pIndex->pNodeStarts[node];
+
+			memcpy(pOut, pIndex->pRangeIds + pIndex->pNodeStarts[node], nodeCount * sizeof(uint32_t));
+			pOut += nodeCount;
+		}
+	}
+}
+
+void InitVersionRangeIndex(VersionRangeIndex *pIndex)
+{
+	assert(NULL != pIndex);
+
+	memset(pIndex, 0, sizeof(VersionRangeIndex));
+}
+
+void FreeVersionRangeIndex(VersionRangeIndex *pIndex)
+{
+	assert(NULL != pIndex);
+
+	for (size_t idx = 0; idx < pIndex->boundCount; idx++)
+	{
+		FreeVersionParseData(&pIndex->pBounds[idx].record);
+	}
+
+	free(pIndex->pBounds);
+	free(pIndex->pKeys);
+	free(pIndex->pText);
+	free(pIndex->pNodeStarts);
+	free(pIndex->pRangeIds);
+	InitVersionRangeIndex(pIndex);
+}
+
+bool BuildVersionRangeIndex(VersionRangeIndex *pIndex, const VersionRangeSet *pRanges, size_t count)
+{
+	assert(NULL != pIndex);
+	assert((NULL != pRanges) || (0 == count));
+
+	if (count > UINT32_MAX) return false;
+
+	size_t boundCount = 0;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		boundCount += 2 * pRanges[idx].count;
+	}
+
+	// Shallow copies of the bounds, just for sorting.  The records still
+	// belong to the sets.
+	SortableVersion *pSorted = malloc(((0 == boundCount) ? 1 : boundCount) * sizeof(SortableVersion));
+
+	if (NULL == pSorted) return false;
+
+	size_t sortedCount = 0;
+
+	for (size_t rangeIdx = 0; rangeIdx < count; rangeIdx++)
+	{
+		for (size_t idx = 0; idx < pRanges[rangeIdx].count; idx++)
+		{
+			const VersionInterval *pInterval = &pRanges[rangeIdx].pIntervals[idx];
+
+			if (NULL != pInterval->lower.pVersion)
+			{
+				pSorted[sortedCount].pVersion = pInterval->lower.pVersion;
+				pSorted[sortedCount++].record = pInterval->lower.record;
+			}
+
+			if (NULL != pInterval->upper.pVersion)
+			{
+				pSorted[sortedCount].pVersion = pInterval->upper.pVersion;
+				pSorted[sortedCount++].record = pInterval->upper.record;
+			}
+		}
+	}
+
+	VersionRangeIndex index;
+	InitVersionRangeIndex(&index);
+	index.rangeCount = count;
+
+	bool succeeded = SortVersions(pSorted, sortedCount, 0) && BuildBounds(&index, pSorted, sortedCount) && BuildTree(&index, pRanges, count);
+
+	free(pSorted);
+
+	if (!succeeded)
+	{
+		FreeVersionRangeIndex(&index);
+		return false;
+	}
+
+	FreeVersionRangeIndex(pIndex);
+	*pIndex = index;
+
+	return true;
+}
+
+size_t FindContainingRanges(const VersionRangeIndex *pIndex, const char *pVersion, const VersionParseRecord *pParsed, uint32_t *pRangeIds, size_t maxIds)
+{
+	assert(NULL != pIndex);
+	assert(NULL != pVersion);
+	assert(NULL != pParsed);
+	assert((NULL != pRangeIds) || (0 == maxIds));
+
+	if ((eSemVer_2_0_0 != pParsed->versionType) || (NULL == pIndex->pNodeStarts)) return 0;
+
+	size_t found = 0;
+
+	for (size_t node = pIndex->leafCount + FindSlot(pIndex, pVersion, pParsed); node > 0; node /= 2)
+	{
+		for (size_t idx = pIndex->pNodeStarts[node]; idx < pIndex->pNodeStarts[node + 1]; idx++, found++)
+		{
+			if (found < maxIds) pRangeIds[found] = pIndex->pRangeIds[idx];
+		}
+	}
+
+	return found;
+}
+
+bool FindContainingRangesBatch(const VersionRangeIndex *pIndex, const SortableVersion *pVersions, size_t count, size_t threadCount, VersionRangeMatches *pMatches)
+{
+	assert(NULL != pIndex);
+	assert((NULL != pVersions) || (0 == count));
+	assert(NULL != pMatches);
+
+	memset(pMatches, 0, sizeof(VersionRangeMatches));
+
+	if (0 == threadCount) threadCount = GetSemVerProcessorCount();
+	if (threadCount > count / MIN_QUERIES_PER_THREAD) threadCount = count / MIN_QUERIES_PER_THREAD;
+	if (0 == threadCount) threadCount = 1;
+
+	size_t *pStarts = malloc((count + 1) * sizeof(size_t));
+	size_t *pSlots = malloc(((0 == count) ? 1 : count) * sizeof(size_t));
+	BatchTask *pTasks = malloc(threadCount * sizeof(BatchTask));
+
+	if ((NULL == pStarts) || (NULL == pSlots) || (NULL == pTasks))
+	{
+		free(pStarts);
+		free(pSlots);
+		free(pTasks);
+		return false;
+	}
+
+	for (size_t idx = 0; idx < threadCount; idx++)
+	{
+		pTasks[idx].pIndex = pIndex;
+		pTasks[idx].pVersions = pVersions;
+		pTasks[idx].pSlots = pSlots;
+		pTasks[idx].pStarts = pStarts;
+		pTasks[idx].pRangeIds = NULL;
+		pTasks[idx].first = (count * idx) / threadCount;
+		pTasks[idx].last = (count * (idx + 1)) / threadCount;
+	}
+
+	RunSemVerThreads(CountTaskProc, pTasks, sizeof(BatchTask), threadCount);
+
+	pStarts[0] = 0;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		pStarts[idx + 1] += pStarts[idx];
+	}
+
+	uint32_t *pRangeIds = malloc(((0 == pStarts[count]) ? 1 : pStarts[count]) * sizeof(uint32_t));
+
+	if (NULL == pRangeIds)
+	{
+		free(pStarts);
+		free(pSlots);
+		free(pTasks);
+		return false;
+	}
+
+	for (size_t idx = 0; idx < threadCount; idx++)
+	{
+		pTasks[idx].pRangeIds = pRangeIds;
+	}
+
+	RunSemVerThreads(StoreTaskProc, pTasks, sizeof(BatchTask), threadCount);
+
+	free(pSlots);
+	free(pTasks);
+
+	pMatches->pStarts = pStarts;
+	pMatches->pRangeIds = pRangeIds;
+	pMatches->count = count;
+
+	return true;
+}
+
+void FreeVersionRangeMatches(VersionRangeMatches *pMatches)
+{
+	assert(NULL != pMatches);
+
+	free(pMatches->pStarts);
+	free(pMatches->pRangeIds);
+	memset(pMatches, 0, sizeof(VersionRangeMatches));
+}
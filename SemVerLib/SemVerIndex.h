@@ -0,0 +1,118 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerIndex_h_Defined
+#define _SharperHacks_SemVerIndex_h_Defined
+
+#include <stdint.h>
+
+#include "SemVerRange.h"
+#include "SemVerSort.h"
+
+// An index over many VersionRangeSet's, say one per security advisory, that 
+// finds every set containing a version in O(log n + k) time, instead of 
+// asking each set in turn.
+//
+// The distinct bounds of every interval, sorted, cut the versions into slots:
+// slot s holds the versions that exactly s bounds are less than or equal to.
+// Each interval covers a run of slots, and is stored in the nodes of a 
+// segment tree over the slots that exactly cover that run, at most two per
+// level.  A query is one binary search of the bounds for the version's slot,
+// then a walk from that slot's leaf to the root, where every range id found 
+// on the way is a match.  The intervals of a set are disjoint, so no set is
+// found twice.
+//
+// Everything after the binary search is integer work.  Each bound also keeps
+// a key packed from its triple, so most steps of the search are a single 
+// integer compare, and CompareVersions() only breaks ties.
+//
+// The index is built once, and is read only after that, so any number of 
+// threads can query it at once.
+typedef struct _VersionRangeIndex
+{
+	// Every distinct interval bound, in CompareVersions() order.  The strings
+	// are in pText, and the records are owned by the index.
+	VersionBound *pBounds;
+	uint64_t *pKeys;
+	char *pText;
+	size_t boundCount;
+
+	// Slot s is leaf leafCount + s.  The ids of the sets stored at node n are
+	// pRangeIds[pNodeStarts[n]] up to pRangeIds[pNodeStarts[n + 1]].
+	size_t *pNodeStarts;
+	uint32_t *pRangeIds;
+	size_t leafCount;
+
+	size_t rangeCount;
+} VersionRangeIndex;
+
+// What FindContainingRangesBatch() found.  The ids of the sets containing
+// version idx are pRangeIds[pStarts[idx]] up to pRangeIds[pStarts[idx + 1]].
+typedef struct _VersionRangeMatches
+{
+	size_t *pStarts;
+	uint32_t *pRangeIds;
+	size_t count;
+} VersionRangeMatches;
+
+/// <summary>
+/// Initialize an empty index.
+/// </summary>
+extern void InitVersionRangeIndex(VersionRangeIndex *pIndex);
+
+/// <summary>
+/// Free everything the index owns, leaving it empty.
+/// </summary>
+extern void FreeVersionRangeIndex(VersionRangeIndex *pIndex);
+
+/// <summary>
+/// Replace the index's contents with count sets, whose ids are their 
+/// positions in pRanges.
+/// </summary>
+/// <remarks>
+/// The bounds are copied, so pRanges needn't outlive the index.  Costs a sort
+/// of the bounds, and O(log n) tree nodes per interval.
+/// </remarks>
+/// <returns>
+/// False if we ran out of memory, or count is more than UINT32_MAX, in which 
+/// case the index is untouched.
+/// </returns>
+extern bool BuildVersionRangeIndex(VersionRangeIndex *pIndex, const VersionRangeSet *pRanges, size_t count);
+
+/// <summary>
+/// Find the sets that contain a version.
+/// </summary>
+/// <param name="pParsed">From ClassifyVersionCandidate(pVersion).</param>
+/// <param name="pRangeIds">Receives up to maxIds set ids, in no particular order.  May be NULL if maxIds is zero.</param>
+/// <returns>
+/// The number of sets containing the version, which may be more than maxIds.
+/// Zero if pVersion isn't SemVer.
+/// </returns>
+extern size_t FindContainingRanges(const VersionRangeIndex *pIndex, const char *pVersion, const VersionParseRecord *pParsed, uint32_t *pRangeIds, size_t maxIds);
+
+/// <summary>
+/// Find the sets that contain each of count versions, on up to threadCount threads.
+/// </summary>
+/// <remarks>
+/// Each thread finds the slots of a slice of the versions, and counts their
+/// matches.  Then the counts are summed into pStarts, so that each thread can
+/// copy its slice's ids straight into place.
+/// </remarks>
+/// <param name="threadCount">Zero to use every processor.</param>
+/// <param name="pMatches">Receives the results.  Free them with FreeVersionRangeMatches().</param>
+/// <returns>False if we ran out of memory, in which case pMatches is empty.</returns>
+extern bool FindContainingRangesBatch(const VersionRangeIndex *pIndex, const SortableVersion *pVersions, size_t count, size_t threadCount, VersionRangeMatches *pMatches);
+
+/// <summary>
+/// Free what FindContainingRangesBatch() returned, leaving it empty.
+/// </summary>
+extern void FreeVersionRangeMatches(VersionRangeMatches *pMatches);
+
+#endif
@@ -0,0 +1,416 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerLockfile.h"
+
+#include <assert.h>
+#include <memory.h>
+#include <string.h>
+
+// DetectLockfileFormat() only looks this far in.
+static const size_t _detectLength = 512;
+
+static const char _nodeModules[] = "node_modules/";
+static const char _goModSuffix[] = "/go.mod";
+
+// Private functions in alphabetical order...
+
+// The offset of the closing quote of a JSON string whose text starts at 
+// offset, or length if it's unterminated.
+static size_t FindJsonStringEnd(const char *pBuffer, size_t length, size_t offset)
+{
+	while (offset < length)
+	{
+		const char *pQuote = memchr(pBuffer + offset, '"', length - offset);
+
+		if (NULL == pQuote) return length;
+
+		size_t end = pQuote - pBuffer;
+		size_t backslashes = 0;
+
+		while ((end - backslashes > offset) && ('\\' == pBuffer[end - backslashes - 1])) backslashes++;
+
+		// An even number of backslashes escape each other, not the quote.
+		if (0 == (backslashes % 2)) return end;
+
+		offset = end + 1;
+	}
+
+	return length;
+}
+
+// The offset of the first pText in pBuffer[0..length), or length.
+static size_t FindText(const char *pBuffer, size_t length, const char *pText)
+{
+	size_t textLength = strlen(pText);
+
+	for (size_t offset = 0; offset + textLength <= length; offset++)
+	{
+		if ((pBuffer[offset] == pText[0]) && (0 == memcmp(pBuffer + offset, pText, textLength))) return offset;
+	}
+
+	return length;
+}
+
+// The package name for a "version" in the innermost object.
+static void GetNpmPackageName(const LockfileScanner *pScanner, size_t *pOffset, size_t *pLength)
+{
+	*pOffset = 0;
+	*pLength = 0;
+
+	if ((0 == pScanner->depth) || (pScanner->depth > LOCKFILE_MAX_DEPTH)) return;
+
+	size_t offset = pScanner->keyOffset[pScanner->depth - 1];
+	size_t length = pScanner->keyLength[pScanner->depth - 1];
+	size_t prefixLength = strlen(_nodeModules);
+
+	// "node_modules/a/node_modules/@b/c" is "@b/c".
+	for (size_t idx = length; idx >= prefixLength; idx--)
+	{
+		if (0 == memcmp(pScanner->pBuffer + offset + idx - prefixLength, _nodeModules, prefixLength))
+		{
+			offset += idx;
+			length -= idx;
+			break;
+		}
+	}
+
+	*pOffset = offset;
+	*pLength = length;
+}
+
+static inline bool IsBlank(char c)
+{
+	return (' ' == c) || ('\t' == c) || ('\r' == c);
+}
+
+static inline bool IsJsonSpace(char c)
+{
+	return IsBlank(c) || ('\n' == c);
+}
+
+// The end of the line that starts at offset, not including the '\n'.
+static inline size_t LineEnd(const char *pBuffer, size_t length, size_t offset)
+{
+	const char *pNewline = memchr(pBuffer + offset, '\n', length - offset);
+
+	return (NULL == pNewline) ? length : (size_t)(pNewline - pBuffer);
+}
+
+// Matches a TOML line of the form: key = "value".
+static bool ParseTomlString(const char *pBuffer, size_t offset, size_t lineLength, const char *pKey, size_t *pValueOffset, size_t *pValueLength)
+{
+	size_t keyLength = strlen(pKey);
+	size_t end = offset + lineLength;
+
+	if ((lineLength <= keyLength) || (0 != memcmp(pBuffer + offset, pKey, keyLength))) return false;
+
+	offset += keyLength;
+
+	while ((offset < end) && IsBlank(pBuffer[offset])) offset++;
+
+	if ((offset == end) || ('=' != pBuffer[offset++])) return false;
+
+	while ((offset < end) && IsBlank(pBuffer[offset])) offset++;
+
+	if ((offset == end) || ('"' != pBuffer[offset]) || ('"' != pBuffer[end - 1]) || (end - offset < 2)) return false;
+
+	*pValueOffset = offset + 1;
+	*pValueLength = end - offset - 2;
+	return true;
+}
+
+static void SetEntry(LockfileEntry *pEntry, const char *pBuffer, size_t nameOffset, size_t nameLength, size_t versionOffset, size_t versionLength)
+{
+	pEntry->nameOffset = nameOffset;
+	pEntry->nameLength = nameLength;
+	pEntry->versionOffset = versionOffset;
+	pEntry->versionLength = versionLength;
+
+	ClassifyVersionCandidateN(pBuffer + versionOffset, versionLength, &pEntry->record);
+}
+
+// True if the span holds exactly pText.
+static inline bool SpanEquals(const char *pSpan, size_t length, const char *pText)
+{
+	return (strlen(pText) == length) && (0 == memcmp(pSpan, pText, length));
+}
+
+// Trim a line down to what's between leading blanks and a trailing "\r" or 
+// blanks.  Returns the new length, and moves *pOffset.
+static size_t TrimLine(const char *pBuffer, size_t *pOffset, size_t end)
+{
+	size_t offset = *pOffset;
+
+	while ((offset < end) && IsBlank(pBuffer[offset])) offset++;
+	while ((end > offset) && IsBlank(pBuffer[end - 1])) end--;
+
+	*pOffset = offset;
+	return end - offset;
+}
+
+// [[package]] tables, each with a name and a version.
+static size_t ScanCargo(LockfileScanner *pScanner, LockfileEntry *pEntries, size_t maxEntries)
+{
+	const char *pBuffer = pScanner->pBuffer;
+	size_t count = 0;
+
+	while ((count < maxEntries) && (pScanner->offset < pScanner->length))
+	{
+		size_t end = LineEnd(pBuffer, pScanner->length, pScanner->offset);
+		size_t offset = pScanner->offset;
+		size_t lineLength = TrimLine(pBuffer, &offset, end);
+
+		pScanner->offset = end + 1;
+
+		if ((0 != lineLength) && ('[' == pBuffer[offset]))
+		{
+			pScanner->inPackage = SpanEquals(pBuffer + offset, lineLength, "[[package]]");
+			pScanner->hasName = false;
+			pScanner->hasVersion = false;
+			pScanner->emitted = false;
+			continue;
+		}
+
+		if (!pScanner->inPackage || pScanner->emitted) continue;
+
+		if (ParseTomlString(pBuffer, offset, lineLength, "name", &pScanner->nameOffset, &pScanner->nameLength))
+		{
+			pScanner->hasName = true;
+		}
+		else if (ParseTomlString(pBuffer, offset, lineLength, "version", &pScanner->versionOffset, &pScanner->versionLength))
+		{
+			pScanner->hasVersion = true;
+		}
+
+		if (pScanner->hasName && pScanner->hasVersion)
+		{
+			SetEntry(&pEntries[count++], pBuffer, pScanner->nameOffset, pScanner->nameLength, pScanner->versionOffset, pScanner->versionLength);
+			pScanner->emitted = true;
+		}
+	}
+
+	if (pScanner->offset > pScanner->length) pScanner->offset = pScanner->length;
+
+	return count;
+}
+
+// Lines of: module v<version>[/go.mod] hash
+static size_t ScanGoSum(LockfileScanner *pScanner, LockfileEntry *pEntries, size_t maxEntries)
+{
+	const char *pBuffer = pScanner->pBuffer;
+	size_t goModLength = strlen(_goModSuffix);
+	size_t count = 0;
+
+	while ((count < maxEntries) && (pScanner->offset < pScanner->length))
+	{
+		size_t end = LineEnd(pBuffer, pScanner->length, pScanner->offset);
+		size_t offset = pScanner->offset;
+		size_t lineLength = TrimLine(pBuffer, &offset, end);
+
+		pScanner->offset = end + 1;
+		end = offset + lineLength;
+
+		size_t nameOffset = offset;
+
+		while ((offset < end) && !IsBlank(pBuffer[offset])) offset++;
+
+		size_t nameLength = offset - nameOffset;
+
+		while ((offset < end) && IsBlank(pBuffer[offset])) offset++;
+
+		size_t versionOffset = offset;
+
+		while ((offset < end) && !IsBlank(pBuffer[offset])) offset++;
+
+		size_t versionLength = offset - versionOffset;
+
+		if ((0 == nameLength) || (0 == versionLength)) continue;
+
+		if ('v' == pBuffer[versionOffset])
+		{
+			versionOffset++;
+			versionLength--;
+		}
+
+		bool isGoMod = (versionLength >= goModLength) && (0 == memcmp(pBuffer + versionOffset + versionLength - goModLength, _goModSuffix, goModLength));
+
+		if (isGoMod) versionLength -= goModLength;
+
+		// "/go.mod" lines usually just repeat the module's line.
+		bool repeated = isGoMod && pScanner->hasName
+			&& (nameLength == pScanner->nameLength) && (0 == memcmp(pBuffer + nameOffset, pBuffer + pScanner->nameOffset, nameLength))
+			&& (versionLength == pScanner->versionLength) && (0 == memcmp(pBuffer + versionOffset, pBuffer + pScanner->versionOffset, versionLength));
+
+		pScanner->hasName = true;
+		pScanner->nameOffset = nameOffset;
+		pScanner->nameLength = nameLength;
+		pScanner->versionOffset = versionOffset;
+		pScanner->versionLength = versionLength;
+
+		if (!repeated) SetEntry(&pEntries[count++], pBuffer, nameOffset, nameLength, versionOffset, versionLength);
+	}
+
+	if (pScanner->offset > pScanner->length) pScanner->offset = pScanner->length;
+
+	return count;
+}
+
+// Just enough JSON to know which object each "version" string is in.
+static size_t ScanNpm(LockfileScanner *pScanner, LockfileEntry *pEntries, size_t maxEntries)
+{
+	const char *pBuffer = pScanner->pBuffer;
+	size_t length = pScanner->length;
+	size_t count = 0;
+
+	while ((count < maxEntries) && (pScanner->offset < length))
+	{
+		char c = pBuffer[pScanner->offset++];
+
+		switch (c)
+		{
+			case '"':
+			{
+				size_t start = pScanner->offset;
+				size_t end = FindJsonStringEnd(pBuffer, length, start);
+				size_t next = (end < length) ? end + 1 : length;
+
+				while ((next < length) && IsJsonSpace(pBuffer[next])) next++;
+
+				if ((next < length) && (':' == pBuffer[next]))
+				{
+					pScanner->pendingKeyOffset = start;
+					pScanner->pendingKeyLength = end - start;
+					pScanner->hasPendingKey = true;
+					pScanner->offset = next + 1;
+					break;
+				}
+
+				pScanner->offset = (end < length) ? end + 1 : length;
+
+				if (pScanner->hasPendingKey && (0 == pScanner->skipDepth) && SpanEquals(pBuffer + pScanner->pendingKeyOffset, pScanner->pendingKeyLength, "version"))
+				{
+					size_t nameOffset;
+					size_t nameLength;
+
+					GetNpmPackageName(pScanner, &nameOffset, &nameLength);
+					SetEntry(&pEntries[count++], pBuffer, nameOffset, nameLength, start, end - start);
+				}
+
+				pScanner->hasPendingKey = false;
+				break;
+			}
+
+			case '{':
+			case '[':
+			{
+				bool hasKey = pScanner->hasPendingKey;
+				const char *pKey = pBuffer + pScanner->pendingKeyOffset;
+				size_t keyLength = pScanner->pendingKeyLength;
+
+				if (pScanner->depth < LOCKFILE_MAX_DEPTH)
+				{
+					pScanner->keyOffset[pScanner->depth] = hasKey ? pScanner->pendingKeyOffset : 0;
+					pScanner->keyLength[pScanner->depth] = hasKey ? keyLength : 0;
+				}
+
+				pScanner->depth++;
+				pScanner->hasPendingKey = false;
+
+				if (!hasKey || (2 != pScanner->depth) || (0 != pScanner->skipDepth)) break;
+
+				if (SpanEquals(pKey, keyLength, "packages"))
+				{
+					pScanner->sawPackages = true;
+				}
+				else if (pScanner->sawPackages && SpanEquals(pKey, keyLength, "dependencies"))
+				{
+					pScanner->skipDepth = pScanner->depth;
+				}
+
+				break;
+			}
+
+			case '}':
+			case ']':
+
+				if (pScanner->depth == pScanner->skipDepth) pScanner->skipDepth = 0;
+				if (0 != pScanner->depth) pScanner->depth--;
+
+				pScanner->hasPendingKey = false;
+				break;
+
+			case ',':
+
+				pScanner->hasPendingKey = false;
+				break;
+
+			default:
+
+				// Whitespace, numbers, true, false and null.
+				break;
+		}
+	}
+
+	return count;
+}
+
+LockfileFormat DetectLockfileFormat(const char *pBuffer, size_t length)
+{
+	assert((NULL != pBuffer) || (0 == length));
+
+	size_t offset = 0;
+
+	if (length > _detectLength) length = _detectLength;
+
+	// Skip a UTF-8 BOM, and whitespace.
+	if ((length >= 3) && (0 == memcmp(pBuffer, "\xEF\xBB\xBF", 3))) offset = 3;
+
+	while ((offset < length) && IsJsonSpace(pBuffer[offset])) offset++;
+
+	if (offset == length) return eLockfileUnknown;
+	if ('{' == pBuffer[offset]) return eLockfileNpm;
+
+	size_t lineEnd = LineEnd(pBuffer, length, offset);
+
+	if (FindText(pBuffer + offset, lineEnd - offset, " h1:") < lineEnd - offset) return eLockfileGoSum;
+	if (FindText(pBuffer, length, "[[package]]") < length) return eLockfileCargo;
+	if (FindText(pBuffer, length, "@generated by Cargo") < length) return eLockfileCargo;
+
+	return eLockfileUnknown;
+}
+
+void InitLockfileScanner(LockfileScanner *pScanner, LockfileFormat format, const char *pBuffer, size_t length)
+{
+	assert(NULL != pScanner);
+	assert((NULL != pBuffer) || (0 == length));
+
+	memset(pScanner, 0, sizeof(LockfileScanner));
+
+	pScanner->format = (eLockfileUnknown != format) ? format : DetectLockfileFormat(pBuffer, length);
+	pScanner->pBuffer = pBuffer;
+	pScanner->length = length;
+}
+
+size_t ScanLockfile(LockfileScanner *pScanner, LockfileEntry *pEntries, size_t maxEntries)
+{
+	assert(NULL != pScanner);
+	assert((NULL != pEntries) || (0 == maxEntries));
+
+	switch (pScanner->format)
+	{
+		case eLockfileNpm:
+			return ScanNpm(pScanner, pEntries, maxEntries);
+		case eLockfileCargo:
+			return ScanCargo(pScanner, pEntries, maxEntries);
+		case eLockfileGoSum:
+			return ScanGoSum(pScanner, pEntries, maxEntries);
+		default:
+			return 0;
+	}
+}
@@ -0,0 +1,114 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerLockfile_h_Defined
+#define _SharperHacks_SemVerLockfile_h_Defined
+
+#include "SemVer.h"
+
+// package-lock.json nesting deeper than this still parses, but versions down
+// there are reported without a package name.
+#define LOCKFILE_MAX_DEPTH 32
+
+typedef enum
+{
+	eLockfileUnknown = 0,
+	eLockfileNpm,		// package-lock.json, any lockfileVersion.
+	eLockfileCargo,		// Cargo.lock.
+	eLockfileGoSum		// go.sum.
+} LockfileFormat;
+
+// One package version found in a lockfile.  Spans are offsets into the buffer
+// that was scanned, nothing is copied.
+typedef struct _LockfileEntry
+{
+	// The package name.  For package-lock.json that's the key of the object
+	// holding the version, after the last "node_modules/", so it's empty for
+	// the root package.
+	size_t nameOffset;
+	size_t nameLength;
+
+	// The version, without quotes, and without go.sum's "v" prefix.
+	size_t versionOffset;
+	size_t versionLength;
+
+	// Parse results for the version, which may not be SemVer ("file:..", git 
+	// URLs and so on).  Indexes are relative to versionOffset.  Use 
+	// FreeVersionParseData() to release the tag arrays when you're done.
+	VersionParseRecord record;
+
+} LockfileEntry;
+
+// Where ScanLockfile() is up to.  Treat it as opaque.
+typedef struct _LockfileScanner
+{
+	LockfileFormat format;
+	const char *pBuffer;
+	size_t length;
+	size_t offset;
+
+	// package-lock.json: the key that opened each enclosing object, and the
+	// key waiting for its value.
+	size_t depth;
+	size_t keyOffset[LOCKFILE_MAX_DEPTH];
+	size_t keyLength[LOCKFILE_MAX_DEPTH];
+	size_t pendingKeyOffset;
+	size_t pendingKeyLength;
+	bool hasPendingKey;
+
+	// Lockfile versions 2 and up repeat every package in a legacy top level
+	// "dependencies" object, after "packages".  We skip it, while depth is
+	// above skipDepth.
+	bool sawPackages;
+	size_t skipDepth;
+
+	// Cargo.lock: the [[package]] table we're in.  go.sum: the previous line.
+	bool inPackage;
+	bool hasName;
+	bool hasVersion;
+	bool emitted;
+	size_t nameOffset;
+	size_t nameLength;
+	size_t versionOffset;
+	size_t versionLength;
+
+} LockfileScanner;
+
+/// <summary>
+/// Guess the format of a lockfile from the first few hundred bytes of it.
+/// </summary>
+extern LockfileFormat DetectLockfileFormat(const char *pBuffer, size_t length);
+
+/// <summary>
+/// Get ready to scan a whole lockfile, held in pBuffer.
+/// </summary>
+/// <param name="format">eLockfileUnknown to call DetectLockfileFormat().</param>
+/// <param name="pBuffer">Need not be null terminated, and must outlive the scan.</param>
+extern void InitLockfileScanner(LockfileScanner *pScanner, LockfileFormat format, const char *pBuffer, size_t length);
+
+/// <summary>
+/// Find the next package versions in the lockfile, and classify each one in
+/// place.
+/// </summary>
+/// <remarks>
+/// A single forward pass, with no DOM and no copies.  package-lock.json is
+/// tokenized just enough to track which object each "version" key is in, and
+/// the other formats are read a line at a time.  Go's "/go.mod" lines are 
+/// skipped when they repeat the line before.  Malformed input never fails, 
+/// it just stops yielding entries where it stops making sense.
+/// </remarks>
+/// <param name="pEntries">Receives up to maxEntries results, in file order.</param>
+/// <returns>
+/// The number of entries written.  Anything less than maxEntries means that 
+/// the end of the buffer has been reached.
+/// </returns>
+extern size_t ScanLockfile(LockfileScanner *pScanner, LockfileEntry *pEntries, size_t maxEntries);
+
+#endif
@@ -0,0 +1,259 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerMerge.h"
+#include "SemVerSort.h"
+
+#include <assert.h>
+#include <memory.h>
+
+// One stream, and its current version.
+typedef struct
+{
+	VersionSource source;
+	SortableVersion head;
+	size_t length;
+	bool exhausted;
+} MergeInput;
+
+struct _VersionMerger
+{
+	MergeInput *pInputs;
+	size_t count;
+
+	// pTree[0] is the input that won the last replay, and pTree[node] is the 
+	// input that lost at node.  Input idx sits at leaf idx + count.
+	size_t *pTree;
+
+	bool dropDuplicates;
+
+	// A copy of the version handed out last.
+	SortableVersion last;
+	char *pLast;
+	size_t lastCapacity;
+	bool hasLast;
+
+	// The input whose version was handed out last, and must move on.
+	size_t pending;
+	bool hasPending;
+
+	// Anything other than eMergeVersion is sticky.
+	MergeStatus status;
+	size_t failedIdx;
+};
+
+// Private functions in alphabetical order...
+
+// Does input idx1 win against input idx2?  An index of count is the sentinel
+// that seeds the tree, and beats everything.  Exhausted inputs lose to 
+// everything, and ties go to the lower index, to keep the merge stable.
+static bool InputBeats(const VersionMerger *pMerger, size_t idx1, size_t idx2)
+{
+	if (idx1 == pMerger->count) return true;
+	if (idx2 == pMerger->count) return false;
+
+	const MergeInput *pInput1 = &pMerger->pInputs[idx1];
+	const MergeInput *pInput2 = &pMerger->pInputs[idx2];
+
+	if (pInput1->exhausted != pInput2->exhausted) return pInput2->exhausted;
+
+	if (!pInput1->exhausted)
+	{
+		int order = CompareSortableVersions(&pInput1->head, &pInput2->head);
+
+		if (0 != order) return order < 0;
+	}
+
+	return idx1 < idx2;
+}
+
+// Fetch the input's next version into its head.
+static void ReadInput(MergeInput *pInput)
+{
+	const char *pVersion = NULL;
+	size_t length = 0;
+
+	if (!pInput->source.pNext(pInput->source.pContext, &pVersion, &length))
+	{
+		pInput->exhausted = true;
+		return;
+	}
+
+	pInput->head.pVersion = pVersion;
+	pInput->length = length;
+	ClassifyVersionCandidateN(pVersion, length, &pInput->head.record);
+}
+
+// Play winner up from its leaf, against the losers on the way to the root.
+static void ReplayInput(VersionMerger *pMerger, size_t winner)
+{
+	for (size_t node = (winner + pMerger->count) / 2; node > 0; node /= 2)
+	{
+		if (InputBeats(pMerger, pMerger->pTree[node], winner))
+		{
+			size_t loser = winner;
+			winner = pMerger->pTree[node];
+			pMerger->pTree[node] = loser;
+		}
+	}
+
+	pMerger->pTree[0] = winner;
+}
+
+// Keep a copy of the pending input's version as the last one handed out, then
+// move that input on, and check that it didn't go backwards.
+static bool AdvanceInput(VersionMerger *pMerger)
+{
+	size_t idx = pMerger->pending;
+	MergeInput *pInput = &pMerger->pInputs[idx];
+
+	if (pInput->length + 1 > pMerger->lastCapacity)
+	{
+		size_t capacity = (pInput->length + 1 > 2 * pMerger->lastCapacity) ? pInput->length + 1 : 2 * pMerger->lastCapacity;
+		char *pBigger = realloc(pMerger->pLast, capacity);
+
+		if (NULL == pBigger)
+		{
+			pMerger->status = eMergeOutOfMemory;
+			pMerger->failedIdx = idx;
+			return false;
+		}
+
+		pMerger->pLast = pBigger;
+		pMerger->lastCapacity = capacity;
+	}
+
+	memcpy(pMerger->pLast, pInput->head.pVersion, pInput->length);
+	pMerger->pLast[pInput->length] = '\0';
+
+	// The tags are relative to the start of the string, so the record can
+	// simply move over to the copy.
+	FreeVersionParseData(&pMerger->last.record);
+	pMerger->last.pVersion = pMerger->pLast;
+	pMerger->last.record = pInput->head.record;
+	memset(&pInput->head.record, 0, sizeof(pInput->head.record));
+	pMerger->hasLast = true;
+	pMerger->hasPending = false;
+
+	ReadInput(pInput);
+
+	if (!pInput->exhausted && (CompareSortableVersions(&pMerger->last, &pInput->head) > 0))
+	{
+		pMerger->status = eMergeOutOfOrder;
+		pMerger->failedIdx = idx;
+		return false;
+	}
+
+	ReplayInput(pMerger, idx);
+
+	return true;
+}
+
+VersionMerger* CreateVersionMerger(const VersionSource *pSources, size_t count, bool dropDuplicates)
+{
+	assert((NULL != pSources) || (0 == count));
+
+	VersionMerger *pMerger = calloc(1, sizeof(VersionMerger));
+
+	if (NULL == pMerger) return NULL;
+
+	// The tree always has a root, even with no inputs.
+	pMerger->pInputs = calloc((0 == count) ? 1 : count, sizeof(MergeInput));
+	pMerger->pTree = calloc((0 == count) ? 1 : count, sizeof(size_t));
+
+	if ((NULL == pMerger->pInputs) || (NULL == pMerger->pTree))
+	{
+		FreeVersionMerger(pMerger);
+		return NULL;
+	}
+
+	pMerger->count = count;
+	pMerger->dropDuplicates = dropDuplicates;
+	pMerger->status = (0 == count) ? eMergeEnd : eMergeVersion;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		assert(NULL != pSources[idx].pNext);
+
+		pMerger->pInputs[idx].source = pSources[idx];
+		pMerger->pTree[idx] = count;
+		ReadInput(&pMerger->pInputs[idx]);
+	}
+
+	// Every node starts out holding the sentinel, which loses its way out of
+	// the tree as the inputs are played in, from the last leaf to the first.
+	for (size_t idx = count; idx-- > 0; )
+	{
+		ReplayInput(pMerger, idx);
+	}
+
+	return pMerger;
+}
+
+void FreeVersionMerger(VersionMerger *pMerger)
+{
+	if (NULL == pMerger) return;
+
+	if (NULL != pMerger->pInputs)
+	{
+		for (size_t idx = 0; idx < pMerger->count; idx++)
+		{
+			FreeVersionParseData(&pMerger->pInputs[idx].head.record);
+		}
+	}
+
+	FreeVersionParseData(&pMerger->last.record);
+	free(pMerger->pLast);
+	free(pMerger->pInputs);
+	free(pMerger->pTree);
+	free(pMerger);
+}
+
+MergeStatus NextMergedVersion(VersionMerger *pMerger, const char **ppVersion, size_t *pLength, size_t *pSourceIdx)
+{
+	assert(NULL != pMerger);
+	assert(NULL != ppVersion);
+	assert(NULL != pLength);
+
+	while (eMergeVersion == pMerger->status)
+	{
+		if (pMerger->hasPending && !AdvanceInput(pMerger)) break;
+
+		size_t winner = pMerger->pTree[0];
+		const MergeInput *pInput = &pMerger->pInputs[winner];
+
+		if (pInput->exhausted)
+		{
+			pMerger->status = eMergeEnd;
+			break;
+		}
+
+		pMerger->pending = winner;
+		pMerger->hasPending = true;
+
+		if (pMerger->dropDuplicates && pMerger->hasLast
+			&& (eSemVer_2_0_0 == pInput->head.record.versionType)
+			&& (eSemVer_2_0_0 == pMerger->last.record.versionType)
+			&& (0 == CompareVersions(pMerger->last.pVersion, &pMerger->last.record, pInput->head.pVersion, &pInput->head.record)))
+		{
+			continue;
+		}
+
+		*ppVersion = pInput->head.pVersion;
+		*pLength = pInput->length;
+		if (NULL != pSourceIdx) *pSourceIdx = winner;
+
+		return eMergeVersion;
+	}
+
+	*ppVersion = NULL;
+	*pLength = 0;
+	if (NULL != pSourceIdx) *pSourceIdx = pMerger->failedIdx;
+
+	return pMerger->status;
+}
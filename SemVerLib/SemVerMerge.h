@@ -0,0 +1,78 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerMerge_h_Defined
+#define _SharperHacks_SemVerMerge_h_Defined
+
+#include "SemVer.h"
+
+// A VersionMerger k-way merges streams of versions that are each already in
+// CompareSortableVersions() order (SemVer by precedence, then everything else),
+// such as the output of SortVersions(), or of SemVerExe -sort.
+//
+// The streams sit at the leaves of a loser tree, so each version handed out 
+// costs one compare per level, about log2(count), replaying only the path from
+// the stream it came from.  Memory doesn't grow with the length of the streams:
+// the merger holds the current version of each stream, plus a copy of the last
+// version it handed out.  That copy is used to check each stream's order as it
+// advances, and to spot precedence-equal duplicates.
+
+typedef enum
+{
+	eMergeVersion = 0,		// Here's the next version.
+	eMergeEnd,				// Every stream is exhausted.
+	eMergeOutOfOrder,		// A stream went backwards.
+	eMergeOutOfMemory
+} MergeStatus;
+
+// Called by the merger for the next version of one stream.  The version must
+// stay put until the next call for the same stream.
+// Return false at the end of the stream.
+typedef bool (*VersionSourceProc)(void *pContext, const char **ppVersion, size_t *pLength);
+
+typedef struct _VersionSource
+{
+	VersionSourceProc pNext;
+	void *pContext;
+} VersionSource;
+
+// Opaque.
+typedef struct _VersionMerger VersionMerger;
+
+/// <summary>
+/// Create a merger, and read the first version of each source.
+/// </summary>
+/// <remarks>
+/// Versions that compare equal come out in source order, so the merge is 
+/// stable.  When dropDuplicates is set, only the first of a run of SemVer
+/// versions with equal precedence (those that differ only in build meta data,
+/// or not at all) is handed out.  Strings that aren't SemVer are never dropped.
+/// </remarks>
+/// <param name="pSources">Copied, so needn't outlive the call.</param>
+/// <returns>NULL if we're out of memory.</returns>
+extern VersionMerger* CreateVersionMerger(const VersionSource *pSources, size_t count, bool dropDuplicates);
+
+/// <summary>
+/// Get the next version in merged order.
+/// </summary>
+/// <param name="ppVersion">Valid until the next call.  Not null terminated.</param>
+/// <param name="pSourceIdx">
+/// Optional.  Receives the index of the source the version came from, or of 
+/// the source that went out of order.
+/// </param>
+/// <returns>
+/// eMergeVersion, until eMergeEnd.  eMergeOutOfOrder when a source's next 
+/// version is less than its last one, after which the merger is stuck.
+/// </returns>
+extern MergeStatus NextMergedVersion(VersionMerger *pMerger, const char **ppVersion, size_t *pLength, size_t *pSourceIdx);
+
+extern void FreeVersionMerger(VersionMerger *pMerger);
+
+#endif
@@ -0,0 +1,502 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerRange.h"
+
+#include <assert.h>
+#include <memory.h>
+#include <string.h>
+
+// Interval arrays start out this big, and double when they fill up.
+static const size_t _initialIntervalCapacity = 4;
+
+// Nothing sorts below this, so it's the same as no lower bound at all.
+static const char _leastVersion[] = "0.0.0-0";
+
+// Private functions in alphabetical order...
+
+static void FreeBound(VersionBound *pBound)
+{
+	if (NULL != pBound->pVersion)
+	{
+		FreeVersionParseData(&pBound->record);
+		free(pBound->pVersion);
+	}
+
+	memset(pBound, 0, sizeof(VersionBound));
+}
+
+// Copy the first length characters of a SemVer string into a new bound.
+static bool MakeBound(VersionBound *pBound, const char *pVersion, size_t length)
+{
+	memset(pBound, 0, sizeof(VersionBound));
+
+	pBound->pVersion = malloc(length + 1);
+
+	if (NULL == pBound->pVersion) return false;
+
+	memcpy(pBound->pVersion, pVersion, length);
+	pBound->pVersion[length] = '\0';
+	ClassifyVersionCandidate(pBound->pVersion, &pBound->record);
+
+	assert(eSemVer_2_0_0 == pBound->record.versionType);
+	return true;
+}
+
+static inline bool CopyBound(VersionBound *pDestination, const VersionBound *pSource)
+{
+	if (NULL == pSource->pVersion)
+	{
+		memset(pDestination, 0, sizeof(VersionBound));
+		return true;
+	}
+
+	return MakeBound(pDestination, pSource->pVersion, strlen(pSource->pVersion));
+}
+
+// Append a copy of [pLower, pUpper) to the end of the set.
+static bool AppendInterval(VersionRangeSet *pSet, const VersionBound *pLower, const VersionBound *pUpper)
+{
+	if (pSet->count == pSet->capacity)
+	{
+		size_t capacity = (0 == pSet->capacity) ? _initialIntervalCapacity : 2 * pSet->capacity;
+		VersionInterval *pIntervals = realloc(pSet->pIntervals, capacity * sizeof(VersionInterval));
+
+		if (NULL == pIntervals) return false;
+
+		pSet->pIntervals = pIntervals;
+		pSet->capacity = capacity;
+	}
+
+	VersionInterval *pInterval = &pSet->pIntervals[pSet->count];
+
+	if (!CopyBound(&pInterval->lower, pLower)) return false;
+
+	if (!CopyBound(&pInterval->upper, pUpper))
+	{
+		FreeBound(&pInterval->lower);
+		return false;
+	}
+
+	pSet->count++;
+	return true;
+}
+
+// Unbounded sorts below everything.
+static inline int CompareLowerBounds(const VersionBound *pBound1, const VersionBound *pBound2)
+{
+	if (NULL == pBound1->pVersion) return (NULL == pBound2->pVersion) ? 0 : -1;
+	if (NULL == pBound2->pVersion) return 1;
+
+	return CompareVersions(pBound1->pVersion, &pBound1->record, pBound2->pVersion, &pBound2->record);
+}
+
+// True if some version is both >= pLower and < pUpper.
+static inline bool IsLowerBelowUpper(const VersionBound *pLower, const VersionBound *pUpper)
+{
+	if ((NULL == pLower->pVersion) || (NULL == pUpper->pVersion)) return true;
+
+	return CompareVersions(pLower->pVersion, &pLower->record, pUpper->pVersion, &pUpper->record) < 0;
+}
+
+// Unbounded sorts above everything.
+static inline int CompareUpperBounds(const VersionBound *pBound1, const VersionBound *pBound2)
+{
+	if (NULL == pBound1->pVersion) return (NULL == pBound2->pVersion) ? 0 : 1;
+	if (NULL == pBound2->pVersion) return -1;
+
+	return CompareVersions(pBound1->pVersion, &pBound1->record, pBound2->pVersion, &pBound2->record);
+}
+
+// Add [pLower, pUpper) to a set whose intervals all start at or below pLower,
+// merging it into the last interval if they overlap or touch.
+static bool AddSortedInterval(VersionRangeSet *pSet, const VersionBound *pLower, const VersionBound *pUpper)
+{
+	if (0 != pSet->count)
+	{
+		VersionInterval *pLast = &pSet->pIntervals[pSet->count - 1];
+
+		assert(CompareLowerBounds(&pLast->lower, pLower) <= 0);
+
+		// Touching is enough, [a, b) and [b, c) hold the same versions as [a, c).
+		// An unbounded pLower can only follow another unbounded lower bound.
+		if ((NULL == pLower->pVersion) || (NULL == pLast->upper.pVersion) || !IsLowerBelowUpper(&pLast->upper, pLower))
+		{
+			if (CompareUpperBounds(pUpper, &pLast->upper) <= 0) return true;
+
+			VersionBound upper;
+
+			if (!CopyBound(&upper, pUpper)) return false;
+
+			FreeBound(&pLast->upper);
+			pLast->upper = upper;
+			return true;
+		}
+	}
+
+	return AppendInterval(pSet, pLower, pUpper);
+}
+
+static void AppendText(char *pBuffer, size_t bufferSize, size_t *pLength, const char *pText)
+{
+	for (; '\0' != *pText; pText++, (*pLength)++)
+	{
+		if (*pLength + 1 < bufferSize) pBuffer[*pLength] = *pText;
+	}
+}
+
+static inline bool IsLeastVersion(const VersionBound *pBound)
+{
+	return (NULL != pBound->pVersion) && (0 == strcmp(pBound->pVersion, _leastVersion));
+}
+
+// The length of the version, without its build meta data.
+static inline size_t PrecedenceLength(const char *pVersion, const VersionParseRecord *pParsed)
+{
+	if (pParsed->hasMetaTag) return pParsed->pMetaData[0].fieldIdx - 1;
+
+	return strlen(pVersion);
+}
+
+// Make a bound holding the least version that's greater than pVersion.
+static bool MakeSuccessor(VersionBound *pBound, const char *pVersion, const VersionParseRecord *pParsed)
+{
+	size_t length = PrecedenceLength(pVersion, pParsed);
+	char *pSuccessor = malloc(length + 4);
+
+	if (NULL == pSuccessor) return false;
+
+	memcpy(pSuccessor, pVersion, length);
+
+	if (pParsed->hasPrereleaseTag)
+	{
+		// "1.2.3-alpha.0" is the least of the prereleases with more fields.
+		memcpy(pSuccessor + length, ".0", 3);
+	}
+	else
+	{
+		// "1.2.4-0" is the least of the versions with the next patch.  Bump the
+		// patch, and if it was all nines, make room for the carry.
+		size_t idx = length;
+
+		while ((idx > pParsed->patchIdx) && ('9' == pSuccessor[idx - 1])) pSuccessor[--idx] = '0';
+
+		if (idx > pParsed->patchIdx)
+		{
+			pSuccessor[idx - 1]++;
+		}
+		else
+		{
+			pSuccessor[pParsed->patchIdx] = '1';
+			pSuccessor[length++] = '0';
+		}
+
+		memcpy(pSuccessor + length, "-0", 3);
+	}
+
+	bool made = MakeBound(pBound, pSuccessor, strlen(pSuccessor));
+
+	free(pSuccessor);
+	return made;
+}
+
+// Make a bound from a caller's version string, in canonical form.
+static bool MakeCanonicalBound(VersionBound *pBound, const char *pVersion, const VersionParseRecord *pParsed, bool successor)
+{
+	if (successor) return MakeSuccessor(pBound, pVersion, pParsed);
+
+	return MakeBound(pBound, pVersion, PrecedenceLength(pVersion, pParsed));
+}
+
+// Replace *pResult with *pSet, which pResult now owns.
+static inline void ReplaceVersionRangeSet(VersionRangeSet *pResult, VersionRangeSet *pSet)
+{
+	FreeVersionRangeSet(pResult);
+	*pResult = *pSet;
+}
+
+void InitVersionRangeSet(VersionRangeSet *pSet)
+{
+	assert(NULL != pSet);
+
+	memset(pSet, 0, sizeof(VersionRangeSet));
+}
+
+void FreeVersionRangeSet(VersionRangeSet *pSet)
+{
+	assert(NULL != pSet);
+
+	for (size_t idx = 0; idx < pSet->count; idx++)
+	{
+		FreeBound(&pSet->pIntervals[idx].lower);
+		FreeBound(&pSet->pIntervals[idx].upper);
+	}
+
+	free(pSet->pIntervals);
+	InitVersionRangeSet(pSet);
+}
+
+bool AddVersionInterval(VersionRangeSet *pSet, const char *pLower, bool lowerInclusive, const char *pUpper, bool upperInclusive)
+{
+	assert(NULL != pSet);
+
+	VersionParseRecord lowerParsed = { 0 };
+	VersionParseRecord upperParsed = { 0 };
+	VersionBound lower = { 0 };
+	VersionBound upper = { 0 };
+	bool added = true;
+
+	if (NULL != pLower) ClassifyVersionCandidate(pLower, &lowerParsed);
+	if (NULL != pUpper) ClassifyVersionCandidate(pUpper, &upperParsed);
+
+	if (((NULL != pLower) && (eSemVer_2_0_0 != lowerParsed.versionType))
+		|| ((NULL != pUpper) && (eSemVer_2_0_0 != upperParsed.versionType)))
+	{
+		added = false;
+	}
+	else if (((NULL != pLower) && !MakeCanonicalBound(&lower, pLower, &lowerParsed, !lowerInclusive))
+		|| ((NULL != pUpper) && !MakeCanonicalBound(&upper, pUpper, &upperParsed, upperInclusive)))
+	{
+		added = false;
+	}
+	else
+	{
+		if (IsLeastVersion(&lower)) FreeBound(&lower);
+
+		if (IsLowerBelowUpper(&lower, &upper) && !IsLeastVersion(&upper))
+		{
+			VersionRangeSet interval;
+
+			InitVersionRangeSet(&interval);
+			added = AppendInterval(&interval, &lower, &upper) && UnionVersionRanges(pSet, &interval, pSet);
+			FreeVersionRangeSet(&interval);
+		}
+	}
+
+	FreeBound(&lower);
+	FreeBound(&upper);
+	FreeVersionParseData(&lowerParsed);
+	FreeVersionParseData(&upperParsed);
+
+	return added;
+}
+
+bool UnionVersionRanges(const VersionRangeSet *pSet1, const VersionRangeSet *pSet2, VersionRangeSet *pResult)
+{
+	assert(NULL != pSet1);
+	assert(NULL != pSet2);
+	assert(NULL != pResult);
+
+	VersionRangeSet result;
+	size_t idx1 = 0;
+	size_t idx2 = 0;
+
+	InitVersionRangeSet(&result);
+
+	// Merge the two interval lists by lower bound, coalescing as we go.
+	while ((idx1 < pSet1->count) || (idx2 < pSet2->count))
+	{
+		const VersionInterval *pNext;
+
+		if ((idx2 == pSet2->count)
+			|| ((idx1 < pSet1->count) && (CompareLowerBounds(&pSet1->pIntervals[idx1].lower, &pSet2->pIntervals[idx2].lower) <= 0)))
+		{
+			pNext = &pSet1->pIntervals[idx1++];
+		}
+		else
+		{
+			pNext = &pSet2->pIntervals[idx2++];
+		}
+
+		if (!AddSortedInterval(&result, &pNext->lower, &pNext->upper))
+		{
+			FreeVersionRangeSet(&result);
+			return false;
+		}
+	}
+
+	ReplaceVersionRangeSet(pResult, &result);
+	return true;
+}
+
+bool IntersectVersionRanges(const VersionRangeSet *pSet1, const VersionRangeSet *pSet2, VersionRangeSet *pResult)
+{
+	assert(NULL != pSet1);
+	assert(NULL != pSet2);
+	assert(NULL != pResult);
+
+	VersionRangeSet result;
+	size_t idx1 = 0;
+	size_t idx2 = 0;
+
+	InitVersionRangeSet(&result);
+
+	while ((idx1 < pSet1->count) && (idx2 < pSet2->count))
+	{
+		const VersionInterval *pInterval1 = &pSet1->pIntervals[idx1];
+		const VersionInterval *pInterval2 = &pSet2->pIntervals[idx2];
+		int upperCompare = CompareUpperBounds(&pInterval1->upper, &pInterval2->upper);
+		const VersionBound *pLower = (CompareLowerBounds(&pInterval1->lower, &pInterval2->lower) >= 0) ? &pInterval1->lower : &pInterval2->lower;
+		const VersionBound *pUpper = (upperCompare <= 0) ? &pInterval1->upper : &pInterval2->upper;
+
+		// The overlaps come out in order, and never touch, since neither input's intervals do.
+		if (IsLowerBelowUpper(pLower, pUpper) && !AppendInterval(&result, pLower, pUpper))
+		{
+			FreeVersionRangeSet(&result);
+			return false;
+		}
+
+		// Whichever interval ends first can't overlap anything else.
+		if (upperCompare <= 0) idx1++;
+		if (upperCompare >= 0) idx2++;
+	}
+
+	ReplaceVersionRangeSet(pResult, &result);
+	return true;
+}
+
+bool ComplementVersionRange(const VersionRangeSet *pSet, VersionRangeSet *pResult)
+{
+	assert(NULL != pSet);
+	assert(NULL != pResult);
+
+	VersionRangeSet result;
+	VersionBound unbounded = { 0 };
+	const VersionBound *pLower = &unbounded;
+	bool complemented = true;
+
+	InitVersionRangeSet(&result);
+
+	// The gaps between the intervals, and before and after them.
+	for (size_t idx = 0; complemented && (idx < pSet->count); idx++)
+	{
+		const VersionInterval *pInterval = &pSet->pIntervals[idx];
+
+		if (NULL != pInterval->lower.pVersion)
+		{
+			complemented = AppendInterval(&result, pLower, &pInterval->lower);
+		}
+
+		pLower = &pInterval->upper;
+	}
+
+	if (complemented && ((0 == pSet->count) || (NULL != pLower->pVersion)))
+	{
+		complemented = AppendInterval(&result, pLower, &unbounded);
+	}
+
+	if (!complemented)
+	{
+		FreeVersionRangeSet(&result);
+		return false;
+	}
+
+	ReplaceVersionRangeSet(pResult, &result);
+	return true;
+}
+
+bool IsVersionRangeEmpty(const VersionRangeSet *pSet)
+{
+	assert(NULL != pSet);
+
+	return 0 == pSet->count;
+}
+
+bool VersionRangesEqual(const VersionRangeSet *pSet1, const VersionRangeSet *pSet2)
+{
+	assert(NULL != pSet1);
+	assert(NULL != pSet2);
+
+	if (pSet1->count != pSet2->count) return false;
+
+	for (size_t idx = 0; idx < pSet1->count; idx++)
+	{
+		if ((0 != CompareLowerBounds(&pSet1->pIntervals[idx].lower, &pSet2->pIntervals[idx].lower))
+			|| (0 != CompareUpperBounds(&pSet1->pIntervals[idx].upper, &pSet2->pIntervals[idx].upper)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool VersionRangeContains(const VersionRangeSet *pSet, const char *pVersion, const VersionParseRecord *pParsed)
+{
+	assert(NULL != pSet);
+	assert(NULL != pVersion);
+	assert(NULL != pParsed);
+
+	if (eSemVer_2_0_0 != pParsed->versionType) return false;
+
+	// Find the first interval that ends above the version.
+	size_t first = 0;
+	size_t last = pSet->count;
+
+	while (first < last)
+	{
+		size_t middle = first + (last - first) / 2;
+		const VersionBound *pUpper = &pSet->pIntervals[middle].upper;
+
+		if ((NULL == pUpper->pVersion) || (CompareVersions(pVersion, pParsed, pUpper->pVersion, &pUpper->record) < 0))
+		{
+			last = middle;
+		}
+		else
+		{
+			first = middle + 1;
+		}
+	}
+
+	if (first == pSet->count) return false;
+
+	const VersionBound *pLower = &pSet->pIntervals[first].lower;
+
+	return (NULL == pLower->pVersion) || (CompareVersions(pLower->pVersion, &pLower->record, pVersion, pParsed) <= 0);
+}
+
+size_t FormatVersionRange(const VersionRangeSet *pSet, char *pBuffer, size_t bufferSize)
+{
+	assert(NULL != pSet);
+	assert((NULL != pBuffer) || (0 == bufferSize));
+
+	size_t length = 0;
+
+	if (0 == pSet->count)
+	{
+		AppendText(pBuffer, bufferSize, &length, "<");
+		AppendText(pBuffer, bufferSize, &length, _leastVersion);
+	}
+
+	for (size_t idx = 0; idx < pSet->count; idx++)
+	{
+		const VersionInterval *pInterval = &pSet->pIntervals[idx];
+
+		if (0 != idx) AppendText(pBuffer, bufferSize, &length, " || ");
+
+		if (NULL != pInterval->lower.pVersion)
+		{
+			AppendText(pBuffer, bufferSize, &length, ">=");
+			AppendText(pBuffer, bufferSize, &length, pInterval->lower.pVersion);
+		}
+
+		if (NULL != pInterval->upper.pVersion)
+		{
+			AppendText(pBuffer, bufferSize, &length, (NULL != pInterval->lower.pVersion) ? " <" : "<");
+			AppendText(pBuffer, bufferSize, &length, pInterval->upper.pVersion);
+		}
+		else if (NULL == pInterval->lower.pVersion)
+		{
+			AppendText(pBuffer, bufferSize, &length, "*");
+		}
+	}
+
+	if (0 != bufferSize) pBuffer[(length < bufferSize) ? length : bufferSize - 1] = '\0';
+
+	return length;
+}
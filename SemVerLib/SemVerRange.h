@@ -0,0 +1,130 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerRange_h_Defined
+#define _SharperHacks_SemVerRange_h_Defined
+
+#include "SemVer.h"
+
+// One end of an interval.  Bounds only ever hold the precedence part of a
+// version, build meta data is dropped.
+typedef struct _VersionBound
+{
+	// Null terminated, and owned by the set.  NULL when unbounded.
+	char *pVersion;
+	VersionParseRecord record;
+} VersionBound;
+
+// Every version v such that lower <= v < upper, in CompareVersions() order.
+typedef struct _VersionInterval
+{
+	VersionBound lower;
+	VersionBound upper;
+} VersionInterval;
+
+// A set of SemVer versions, as a sorted list of disjoint intervals.
+//
+// Sets are always kept in one canonical form, so two sets hold the same 
+// versions exactly when their intervals match:
+//
+//   - Every interval is half-open, [lower, upper).  An exclusive lower bound, or 
+//     an inclusive upper bound, is replaced by the version's immediate 
+//     successor, which is "1.2.3-alpha.0" for "1.2.3-alpha" and "1.2.4-0" for
+//     "1.2.3".  Nothing sorts between a version and its successor.
+//   - "0.0.0-0" is the least version there is, so a lower bound of "0.0.0-0" is
+//     stored as unbounded.
+//   - There are no empty intervals, and there is always a version between 
+//     one interval and the next, so they're never merged.
+//
+// Remember that prereleases sort before their release: "< 2.0.0" contains
+// "2.0.0-alpha", and "< 2.0.0-0" does not.  Use "-0" upper bounds when 
+// prereleases of the bound shouldn't match.
+//
+// Every operation costs time proportional to the number of intervals, not the
+// number of versions they contain.
+typedef struct _VersionRangeSet
+{
+	VersionInterval *pIntervals;
+	size_t count;
+	size_t capacity;
+} VersionRangeSet;
+
+/// <summary>
+/// Initialize an empty set.
+/// </summary>
+extern void InitVersionRangeSet(VersionRangeSet *pSet);
+
+/// <summary>
+/// Free everything the set owns, leaving it empty.
+/// </summary>
+extern void FreeVersionRangeSet(VersionRangeSet *pSet);
+
+/// <summary>
+/// Add every version between pLower and pUpper to the set.
+/// </summary>
+/// <param name="pLower">NULL for no lower bound.</param>
+/// <param name="pUpper">NULL for no upper bound.</param>
+/// <returns>
+/// False if either bound isn't SemVer, or we ran out of memory, in which case 
+/// the set is untouched.  Adding an empty interval succeeds, and does nothing.
+/// </returns>
+extern bool AddVersionInterval(VersionRangeSet *pSet, const char *pLower, bool lowerInclusive, const char *pUpper, bool upperInclusive);
+
+/// <summary>
+/// Store every version that's in either set, in pResult.
+/// </summary>
+/// <remarks>
+/// pResult must be initialized, and its old contents are freed.  It may be 
+/// either input.  These are true of all the set operations.
+/// </remarks>
+/// <returns>False if we ran out of memory, in which case pResult is untouched.</returns>
+extern bool UnionVersionRanges(const VersionRangeSet *pSet1, const VersionRangeSet *pSet2, VersionRangeSet *pResult);
+
+/// <summary>
+/// Store every version that's in both sets, in pResult.
+/// </summary>
+/// <returns>False if we ran out of memory, in which case pResult is untouched.</returns>
+extern bool IntersectVersionRanges(const VersionRangeSet *pSet1, const VersionRangeSet *pSet2, VersionRangeSet *pResult);
+
+/// <summary>
+/// Store every version that isn't in pSet, in pResult.
+/// </summary>
+/// <returns>False if we ran out of memory, in which case pResult is untouched.</returns>
+extern bool ComplementVersionRange(const VersionRangeSet *pSet, VersionRangeSet *pResult);
+
+/// <summary>
+/// True if no version is in the set.
+/// </summary>
+extern bool IsVersionRangeEmpty(const VersionRangeSet *pSet);
+
+/// <summary>
+/// True if both sets hold exactly the same versions.
+/// </summary>
+extern bool VersionRangesEqual(const VersionRangeSet *pSet1, const VersionRangeSet *pSet2);
+
+/// <summary>
+/// True if the version is in the set.  A binary search of the intervals.
+/// </summary>
+/// <param name="pParsed">From ClassifyVersionCandidate(pVersion).</param>
+/// <returns>False if pVersion isn't SemVer.</returns>
+extern bool VersionRangeContains(const VersionRangeSet *pSet, const char *pVersion, const VersionParseRecord *pParsed);
+
+/// <summary>
+/// Write the set as text, for example ">=1.0.0 <2.0.0-0 || >=3.0.0".  The empty 
+/// set is "<0.0.0-0", and the set of all versions is "*".
+/// </summary>
+/// <param name="pBuffer">Receives the null terminated text. May be NULL if bufferSize is zero.</param>
+/// <returns>
+/// The length of the text, not including the terminating null.  If the return
+/// value is >= bufferSize, the output was truncated.
+/// </returns>
+extern size_t FormatVersionRange(const VersionRangeSet *pSet, char *pBuffer, size_t bufferSize);
+
+#endif
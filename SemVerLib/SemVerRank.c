@@ -0,0 +1,287 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerRank.h"
+
+#include <assert.h>
+#include <memory.h>
+#include <string.h>
+
+// Tables start out this big, and double when they fill up.
+static const size_t _initialRankCapacity = 16;
+
+// Private functions in alphabetical order...
+
+static int CompareVersionPointers(const void *p1, const void *p2)
+{
+	return CompareSortableVersions(*(const SortableVersion * const *)p1, *(const SortableVersion * const *)p2);
+}
+
+// The index of the first entry that isn't less than pVersion.  *pFound is set
+// if that entry is equal to it.
+static size_t FindRankedIndex(const VersionRankTable *pTable, const char *pVersion, const VersionParseRecord *pParsed, bool *pFound)
+{
+	size_t first = 0;
+	size_t last = pTable->count;
+
+	while (first < last)
+	{
+		size_t middle = first + (last - first) / 2;
+		const RankedVersion *pRanked = &pTable->pVersions[middle];
+
+		if (CompareVersions(pRanked->pVersion, &pRanked->record, pVersion, pParsed) < 0)
+		{
+			first = middle + 1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+
+	*pFound = (first < pTable->count) 
+		&& (0 == CompareVersions(pTable->pVersions[first].pVersion, &pTable->pVersions[first].record, pVersion, pParsed));
+
+	return first;
+}
+
+static void FreeRankedVersion(RankedVersion *pRanked)
+{
+	FreeVersionParseData(&pRanked->record);
+	free(pRanked->pVersion);
+	memset(pRanked, 0, sizeof(RankedVersion));
+}
+
+// Make room for at least one more entry.
+static bool GrowRankTable(VersionRankTable *pTable)
+{
+	if (pTable->count < pTable->capacity) return true;
+
+	size_t capacity = (0 == pTable->capacity) ? _initialRankCapacity : 2 * pTable->capacity;
+	RankedVersion *pVersions = realloc(pTable->pVersions, capacity * sizeof(RankedVersion));
+
+	if (NULL == pVersions) return false;
+
+	pTable->pVersions = pVersions;
+	pTable->capacity = capacity;
+	return true;
+}
+
+// The length of the version, without its build meta data.
+static inline size_t PrecedenceLength(const char *pVersion, const VersionParseRecord *pParsed)
+{
+	if (pParsed->hasMetaTag) return pParsed->pMetaData[0].fieldIdx - 1;
+
+	return strlen(pVersion);
+}
+
+// Copy the precedence part of a SemVer string into a new entry.
+static bool MakeRankedVersion(RankedVersion *pRanked, const char *pVersion, const VersionParseRecord *pParsed, uint64_t rank)
+{
+	size_t length = PrecedenceLength(pVersion, pParsed);
+
+	memset(pRanked, 0, sizeof(RankedVersion));
+
+	pRanked->pVersion = malloc(length + 1);
+
+	if (NULL == pRanked->pVersion) return false;
+
+	memcpy(pRanked->pVersion, pVersion, length);
+	pRanked->pVersion[length] = '\0';
+	ClassifyVersionCandidate(pRanked->pVersion, &pRanked->record);
+	pRanked->rank = rank;
+
+	assert(eSemVer_2_0_0 == pRanked->record.versionType);
+	return true;
+}
+
+// Space every rank VERSION_RANK_GAP apart again, leaving a gap for a new entry
+// at index idx.
+static void RenumberRanks(VersionRankTable *pTable, size_t idx)
+{
+	assert(pTable->count < (UINT64_MAX / VERSION_RANK_GAP) - 2);
+
+	for (size_t entry = 0; entry < pTable->count; entry++)
+	{
+		pTable->pVersions[entry].rank = (entry + ((entry < idx) ? 1 : 2)) * VERSION_RANK_GAP;
+	}
+
+	pTable->generation++;
+}
+
+// Pointers to the SemVer versions in pVersions, sorted.  The caller frees 
+// *pppSorted.
+static bool SortSemVerVersions(const SortableVersion *pVersions, size_t count, const SortableVersion ***pppSorted, size_t *pSortedCount)
+{
+	const SortableVersion **ppSorted = malloc(((0 == count) ? 1 : count) * sizeof(SortableVersion*));
+	size_t sortedCount = 0;
+
+	if (NULL == ppSorted) return false;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		if (eSemVer_2_0_0 == pVersions[idx].record.versionType) ppSorted[sortedCount++] = &pVersions[idx];
+	}
+
+	qsort(ppSorted, sortedCount, sizeof(SortableVersion*), CompareVersionPointers);
+
+	*pppSorted = ppSorted;
+	*pSortedCount = sortedCount;
+	return true;
+}
+
+bool RankVersions(const SortableVersion *pVersions, size_t count, uint32_t *pRanks, size_t *pRankCount)
+{
+	assert((NULL != pVersions) || (0 == count));
+	assert((NULL != pRanks) || (0 == count));
+
+	const SortableVersion **ppSorted;
+	size_t sortedCount;
+
+	if (!SortSemVerVersions(pVersions, count, &ppSorted, &sortedCount)) return false;
+
+	uint32_t rank = 0;
+
+	for (size_t idx = 0; idx < count; idx++) pRanks[idx] = VERSION_RANK_NONE;
+
+	for (size_t idx = 0; idx < sortedCount; idx++)
+	{
+		if ((idx > 0) && (0 != CompareSortableVersions(ppSorted[idx - 1], ppSorted[idx]))) rank++;
+
+		pRanks[ppSorted[idx] - pVersions] = rank;
+	}
+
+	if (NULL != pRankCount) *pRankCount = (0 == sortedCount) ? 0 : (size_t)rank + 1;
+
+	free((void*)ppSorted);
+	return true;
+}
+
+void InitVersionRankTable(VersionRankTable *pTable)
+{
+	assert(NULL != pTable);
+
+	memset(pTable, 0, sizeof(VersionRankTable));
+}
+
+void FreeVersionRankTable(VersionRankTable *pTable)
+{
+	assert(NULL != pTable);
+
+	for (size_t idx = 0; idx < pTable->count; idx++)
+	{
+		FreeRankedVersion(&pTable->pVersions[idx]);
+	}
+
+	free(pTable->pVersions);
+
+	// Cached ranks are stale, even if the table is refilled.
+	size_t generation = pTable->generation + 1;
+
+	InitVersionRankTable(pTable);
+	pTable->generation = generation;
+}
+
+bool BuildVersionRankTable(VersionRankTable *pTable, const SortableVersion *pVersions, size_t count)
+{
+	assert(NULL != pTable);
+	assert((NULL != pVersions) || (0 == count));
+
+	const SortableVersion **ppSorted;
+	size_t sortedCount;
+
+	if (!SortSemVerVersions(pVersions, count, &ppSorted, &sortedCount)) return false;
+
+	VersionRankTable table;
+
+	InitVersionRankTable(&table);
+
+	for (size_t idx = 0; idx < sortedCount; idx++)
+	{
+		if ((idx > 0) && (0 == CompareSortableVersions(ppSorted[idx - 1], ppSorted[idx]))) continue;
+
+		if (!GrowRankTable(&table) 
+			|| !MakeRankedVersion(&table.pVersions[table.count], ppSorted[idx]->pVersion, &ppSorted[idx]->record, (table.count + 1) * VERSION_RANK_GAP))
+		{
+			FreeVersionRankTable(&table);
+			free((void*)ppSorted);
+			return false;
+		}
+
+		table.count++;
+	}
+
+	free((void*)ppSorted);
+
+	FreeVersionRankTable(pTable);
+	table.generation = pTable->generation;
+	*pTable = table;
+	return true;
+}
+
+bool InsertRankedVersion(VersionRankTable *pTable, const char *pVersion, const VersionParseRecord *pParsed, uint64_t *pRank)
+{
+	assert(NULL != pTable);
+	assert(NULL != pVersion);
+	assert(NULL != pParsed);
+	assert(NULL != pRank);
+
+	if (eSemVer_2_0_0 != pParsed->versionType) return false;
+
+	bool found;
+	size_t idx = FindRankedIndex(pTable, pVersion, pParsed, &found);
+
+	if (found)
+	{
+		*pRank = pTable->pVersions[idx].rank;
+		return true;
+	}
+
+	RankedVersion ranked;
+
+	if (!GrowRankTable(pTable) || !MakeRankedVersion(&ranked, pVersion, pParsed, 0)) return false;
+
+	// After the last entry, leave a full gap, if there's room for one.
+	uint64_t lower = (idx > 0) ? pTable->pVersions[idx - 1].rank : 0;
+	uint64_t upper = (idx < pTable->count) ? pTable->pVersions[idx].rank 
+		: ((lower <= UINT64_MAX - (2 * VERSION_RANK_GAP)) ? lower + (2 * VERSION_RANK_GAP) : lower);
+
+	if (upper - lower < 2)
+	{
+		RenumberRanks(pTable, idx);
+		ranked.rank = (idx + 1) * VERSION_RANK_GAP;
+	}
+	else
+	{
+		ranked.rank = lower + ((upper - lower) / 2);
+	}
+
+	memmove(&pTable->pVersions[idx + 1], &pTable->pVersions[idx], (pTable->count - idx) * sizeof(RankedVersion));
+	pTable->pVersions[idx] = ranked;
+	pTable->count++;
+
+	*pRank = ranked.rank;
+	return true;
+}
+
+bool FindVersionRank(const VersionRankTable *pTable, const char *pVersion, const VersionParseRecord *pParsed, uint64_t *pRank)
+{
+	assert(NULL != pTable);
+	assert(NULL != pVersion);
+	assert(NULL != pParsed);
+	assert(NULL != pRank);
+
+	if (eSemVer_2_0_0 != pParsed->versionType) return false;
+
+	bool found;
+	size_t idx = FindRankedIndex(pTable, pVersion, pParsed, &found);
+
+	if (found) *pRank = pTable->pVersions[idx].rank;
+
+	return found;
+}
@@ -0,0 +1,107 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerRank_h_Defined
+#define _SharperHacks_SemVerRank_h_Defined
+
+#include <stdint.h>
+
+#include "SemVerSort.h"
+
+// The rank RankVersions() gives strings that aren't SemVer.
+#define VERSION_RANK_NONE UINT32_MAX
+
+// How far apart VersionRankTable ranks are, when they're (re)numbered.  Up to
+// 32 versions can be inserted between two neighbors before they run out.
+#define VERSION_RANK_GAP ((uint64_t)1 << 32)
+
+// One distinct version in a VersionRankTable.
+typedef struct _RankedVersion
+{
+	// Null terminated, and owned by the table.  Only the precedence part of the
+	// version, build meta data is dropped.
+	char *pVersion;
+	VersionParseRecord record;
+	uint64_t rank;
+} RankedVersion;
+
+// Ranks for a growing set of SemVer versions, where comparing two ranks gives
+// the same answer as CompareVersions() does for their versions.
+//
+// Versions are kept in CompareVersions() order, one entry per distinct 
+// precedence, so versions that differ only in build meta data share a rank.
+// Ranks are spaced VERSION_RANK_GAP apart, and a new version takes the rank 
+// halfway between its neighbors.  Only when there's no room left are all of
+// the ranks renumbered, and generation incremented, which makes any ranks 
+// the caller saved earlier stale.
+typedef struct _VersionRankTable
+{
+	RankedVersion *pVersions;
+	size_t count;
+	size_t capacity;
+	size_t generation;
+} VersionRankTable;
+
+/// <summary>
+/// Dense ranks, in CompareVersions() order.  Equal versions, including those
+/// that differ only in build meta data, get the same rank, and ranks run from
+/// zero to the number of distinct versions, less one, without gaps.
+/// </summary>
+/// <remarks>
+/// Sorts pointers to the versions, so it costs O(count log count) compares,
+/// once.  After that, comparing two versions is one integer compare.
+/// </remarks>
+/// <param name="pRanks">Receives count ranks, VERSION_RANK_NONE for strings that aren't SemVer.</param>
+/// <param name="pRankCount">Receives the number of distinct versions.  May be NULL.</param>
+/// <returns>False if we ran out of memory, in which case pRanks is untouched.</returns>
+extern bool RankVersions(const SortableVersion *pVersions, size_t count, uint32_t *pRanks, size_t *pRankCount);
+
+/// <summary>
+/// Initialize an empty table.
+/// </summary>
+extern void InitVersionRankTable(VersionRankTable *pTable);
+
+/// <summary>
+/// Free everything the table owns, leaving it empty.
+/// </summary>
+extern void FreeVersionRankTable(VersionRankTable *pTable);
+
+/// <summary>
+/// Replace the table's contents with the distinct SemVer versions in 
+/// pVersions, ranked VERSION_RANK_GAP apart.  Strings that aren't SemVer are
+/// skipped.
+/// </summary>
+/// <returns>False if we ran out of memory, in which case the table is untouched.</returns>
+extern bool BuildVersionRankTable(VersionRankTable *pTable, const SortableVersion *pVersions, size_t count);
+
+/// <summary>
+/// Add a version to the table, unless an equal one is already there.
+/// </summary>
+/// <remarks>
+/// A binary search, then moving the entries above the new one.  Check 
+/// generation afterwards, to see whether other ranks were renumbered.
+/// </remarks>
+/// <param name="pParsed">From ClassifyVersionCandidate(pVersion).</param>
+/// <param name="pRank">Receives the version's rank.</param>
+/// <returns>
+/// False if pVersion isn't SemVer, or we ran out of memory, in which case the
+/// table is untouched.
+/// </returns>
+extern bool InsertRankedVersion(VersionRankTable *pTable, const char *pVersion, const VersionParseRecord *pParsed, uint64_t *pRank);
+
+/// <summary>
+/// Look up the rank of a version that's already in the table.
+/// </summary>
+/// <param name="pParsed">From ClassifyVersionCandidate(pVersion).</param>
+/// <param name="pRank">Receives the version's rank.</param>
+/// <returns>False if no equal version is in the table.</returns>
+extern bool FindVersionRank(const VersionRankTable *pTable, const char *pVersion, const VersionParseRecord *pParsed, uint64_t *pRank);
+
+#endif
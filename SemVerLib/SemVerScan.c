@@ -0,0 +1,233 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerScan.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+// Use SSE2 to look for digits, wherever we can count on having it.
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+ #define SEMVER_SCAN_SSE2
+ #include <emmintrin.h>
+ #ifdef _MSC_VER
+  #include <intrin.h>
+ #endif
+#endif
+
+static const char _newline = '\n';
+
+// The shortest possible SemVer string is "0.0.0".
+static const size_t _minimumVersionLength = 5;
+
+// These deliberately ignore the locale, and accept any char value.  The
+// buffers we scan can contain anything.
+static inline bool IsAsciiDigit(char c)
+{
+	return ('0' <= c) && (c <= '9');
+}
+
+static inline bool IsAsciiAlphaNumeric(char c)
+{
+	return IsAsciiDigit(c) || (('a' <= c) && (c <= 'z')) || (('A' <= c) && (c <= 'Z'));
+}
+
+// Blanks that can surround a line, including the '\r' of a "\r\n" line end.
+static inline bool IsLineBlank(char c)
+{
+	return (' ' == c) || ('\t' == c) || ('\r' == c);
+}
+
+#ifdef SEMVER_SCAN_SSE2
+static inline unsigned CountTrailingZeros(unsigned mask)
+{
+#ifdef _MSC_VER
+	unsigned long idx;
+	_BitScanForward(&idx, mask);
+	return (unsigned)idx;
+#else
+	return (unsigned)__builtin_ctz(mask);
+#endif
+}
+#endif
+
+// Returns the index of the first digit in pBuffer[idx..length), or length if
+// there isn't one.  This is where the scanner spends most of its time on 
+// typical input, so we look at 16 bytes at a time when we can.
+static size_t FindDigit(const char *pBuffer, size_t idx, size_t length)
+{
+#ifdef SEMVER_SCAN_SSE2
+	const __m128i zeros = _mm_set1_epi8('0');
+	const __m128i nines = _mm_set1_epi8(9);
+
+	while (idx + sizeof(__m128i) <= length)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i*)(pBuffer + idx));
+
+		// Digits are the bytes whose unsigned distance from '0' is at most 9.
+		__m128i distances = _mm_sub_epi8(chunk, zeros);
+		__m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(distances, nines), distances);
+		unsigned mask = (unsigned)_mm_movemask_epi8(isDigit);
+
+		if (0 != mask) return idx + CountTrailingZeros(mask);
+
+		idx += sizeof(__m128i);
+	}
+#endif
+
+	for (; idx < length; idx++)
+	{
+		if (IsAsciiDigit(pBuffer[idx])) return idx;
+	}
+
+	return length;
+}
+
+// Looks for the longest prefix of pToken[0..tokenLength) that is SemVer and is
+// not followed by a letter or digit.  On success, pRecord holds the parse 
+// results for that prefix.
+static bool MatchToken(const char *pToken, size_t tokenLength, VersionParseRecord *pRecord, size_t *pMatchLength)
+{
+	size_t candidateLength = tokenLength;
+
+	while (candidateLength >= _minimumVersionLength)
+	{
+		ClassifyVersionCandidateN(pToken, candidateLength, pRecord);
+
+		if (eSemVer_2_0_0 == pRecord->versionType)
+		{
+			*pMatchLength = candidateLength;
+			return true;
+		}
+
+		// The state machine has no look-aheads, so no prefix that includes the
+		// character it stopped on can be valid either.  Back up to the last 
+		// delimiter at or before that character, and try again from there.
+		size_t limit = pRecord->parsedIdx;
+
+		FreeVersionParseData(pRecord);
+
+		if (limit >= candidateLength) limit = candidateLength - 1;
+
+		while ((limit >= _minimumVersionLength) && IsAsciiAlphaNumeric(pToken[limit])) limit--;
+
+		candidateLength = limit;
+	}
+
+	return false;
+}
+
+size_t ScanForVersions(const char *pBuffer, size_t length, size_t *pOffset, SemVerMatch *pMatches, size_t maxMatches)
+{
+	assert(NULL != pBuffer);
+	assert(NULL != pOffset);
+	assert((NULL != pMatches) || (0 == maxMatches));
+
+	size_t matchCount = 0;
+	size_t idx = *pOffset;
+
+	// End of the run of SemVer characters that the current candidate is in.
+	// Several candidates can share a run, so we only measure each run once.
+	size_t tokenEnd = idx;
+
+	while (matchCount < maxMatches)
+	{
+		idx = FindDigit(pBuffer, idx, length);
+
+		if (idx >= length) break;
+
+		// Don't start in the middle of a number.
+		if ((0 != idx) && IsAsciiDigit(pBuffer[idx - 1]))
+		{
+			while ((idx < length) && IsAsciiDigit(pBuffer[idx])) idx++;
+			continue;
+		}
+
+		if (idx >= tokenEnd)
+		{
+			tokenEnd = idx;
+			while ((tokenEnd < length) && IsSemVerChar(pBuffer[tokenEnd])) tokenEnd++;
+		}
+
+		SemVerMatch *pMatch = &pMatches[matchCount];
+
+		if (MatchToken(pBuffer + idx, tokenEnd - idx, &pMatch->record, &pMatch->length))
+		{
+			pMatch->offset = idx;
+			idx += pMatch->length;
+			matchCount++;
+		}
+		else
+		{
+			// The next candidate can't start inside this number.
+			do { idx++; } while ((idx < length) && IsAsciiDigit(pBuffer[idx]));
+		}
+	}
+
+	*pOffset = idx;
+
+	return matchCount;
+}
+
+void InitVersionLineReader(VersionLineReader *pReader, const char *pBuffer, size_t length, const VersionRangeSet *pFilter)
+{
+	assert(NULL != pReader);
+	assert((NULL != pBuffer) || (0 == length));
+
+	memset(pReader, 0, sizeof(VersionLineReader));
+	pReader->pBuffer = pBuffer;
+	pReader->length = length;
+	pReader->pFilter = pFilter;
+}
+
+bool ReadVersionLine(VersionLineReader *pReader)
+{
+	assert(NULL != pReader);
+
+	FreeVersionParseData(&pReader->record);
+
+	while (pReader->offset < pReader->length)
+	{
+		const char *pBuffer = pReader->pBuffer;
+		size_t start = pReader->offset;
+		const char *pNewline = memchr(pBuffer + start, _newline, pReader->length - start);
+		size_t end = (NULL == pNewline) ? pReader->length : (size_t)(pNewline - pBuffer);
+
+		pReader->offset = (NULL == pNewline) ? end : end + 1;
+
+		while ((start < end) && IsLineBlank(pBuffer[start])) start++;
+		while ((end > start) && IsLineBlank(pBuffer[end - 1])) end--;
+
+		if (!IsSemVer(pBuffer + start, end - start)) continue;
+
+		ClassifyVersionCandidateN(pBuffer + start, end - start, &pReader->record);
+
+		if ((NULL != pReader->pFilter) && !VersionRangeContains(pReader->pFilter, pBuffer + start, &pReader->record))
+		{
+			FreeVersionParseData(&pReader->record);
+			continue;
+		}
+
+		pReader->lineOffset = start;
+		pReader->lineLength = end - start;
+		return true;
+	}
+
+	pReader->lineOffset = pReader->length;
+	pReader->lineLength = 0;
+	return false;
+}
+
+void FreeVersionLineReader(VersionLineReader *pReader)
+{
+	assert(NULL != pReader);
+
+	FreeVersionParseData(&pReader->record);
+	pReader->offset = pReader->length;
+}
@@ -0,0 +1,110 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerScan_h_Defined
+#define _SharperHacks_SemVerScan_h_Defined
+
+#include "SemVer.h"
+#include "SemVerRange.h"
+
+// A SemVer 2.0.0 string found embedded in some larger buffer, such as a build
+// log, a changelog or a binary's string table.
+typedef struct _SemVerMatch
+{
+	// Offset of the first character of the version, from the start of the buffer.
+	size_t offset;
+
+	// Count of characters in the version.
+	size_t length;
+
+	// Parse results for the version.  All of the indexes in here are relative
+	// to offset, not to the start of the buffer.  Use FreeVersionParseData()
+	// to release the tag arrays when you're done with it.
+	VersionParseRecord record;
+
+} SemVerMatch;
+
+/// <summary>
+/// Find every maximal SemVer 2.0.0 substring in pBuffer[*pOffset..length).
+/// </summary>
+/// <param name="pBuffer">Buffer to search. Need not be null terminated.</param>
+/// <param name="length">Count of characters in pBuffer.</param>
+/// <param name="pOffset">
+/// In: Where to start searching.
+/// Out: Where to resume searching, if the function returned maxMatches.
+/// </param>
+/// <param name="pMatches">Receives up to maxMatches results, in buffer order.</param>
+/// <returns>
+/// The number of matches written to pMatches.  Anything less than maxMatches
+/// means that the end of the buffer has been reached.
+/// </returns>
+/// <remarks>
+/// A candidate starts on a digit that doesn't follow another digit, and the
+/// match is the longest prefix of the surrounding run of SemVer characters
+/// ([0-9A-Za-z.+-]) that is valid SemVer, and is not followed by a letter or
+/// digit.  So "see v1.2.3-rc.1." yields "1.2.3-rc.1" and "1.2.3.4" yields
+/// "1.2.3".  Matches never overlap.
+///
+/// Everything between candidates is skipped with a vectorized digit search,
+/// where the platform supports it, and the classification state machine only
+/// runs from candidate starts.
+/// </remarks>
+extern size_t ScanForVersions(const char *pBuffer, size_t length, size_t *pOffset, SemVerMatch *pMatches, size_t maxMatches);
+
+// Pulls SemVer lines out of a buffer one at a time, such as a list of tags or
+// the output of some other tool, without copying them or keeping more than 
+// the current line's parse results around.
+typedef struct _VersionLineReader
+{
+	const char *pBuffer;
+	size_t length;
+
+	// Where the next line starts.
+	size_t offset;
+
+	// When not NULL, lines that aren't in this set are skipped too.
+	const VersionRangeSet *pFilter;
+
+	// The current line, without its line end or surrounding blanks.  Only 
+	// meaningful after ReadVersionLine() returns true.
+	size_t lineOffset;
+	size_t lineLength;
+
+	// Parse results for the current line, relative to lineOffset.  The same
+	// record is reused for every line, so copy anything you want to keep.
+	VersionParseRecord record;
+
+} VersionLineReader;
+
+/// <summary>
+/// Get ready to read pBuffer[0..length).
+/// </summary>
+/// <param name="pBuffer">Lines ending in "\n" or "\r\n". Need not be null terminated.</param>
+/// <param name="pFilter">Optional. Must outlive the reader.</param>
+extern void InitVersionLineReader(VersionLineReader *pReader, const char *pBuffer, size_t length, const VersionRangeSet *pFilter);
+
+/// <summary>
+/// Move to the next line that is SemVer 2.0.0, and in pReader->pFilter if 
+/// there is one.
+/// </summary>
+/// <returns>False at the end of the buffer.</returns>
+/// <remarks>
+/// Lines that aren't SemVer are rejected by IsSemVer(), so skipping them 
+/// allocates nothing.  Only a version with tags allocates, for its tag arrays,
+/// and those are freed by the next call.
+/// </remarks>
+extern bool ReadVersionLine(VersionLineReader *pReader);
+
+/// <summary>
+/// Release what the current line holds.  The reader can be re-initialized.
+/// </summary>
+extern void FreeVersionLineReader(VersionLineReader *pReader);
+
+#endif
@@ -0,0 +1,563 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerSet.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Arrays start out this big, and double when they fill up.
+static const size_t _initialCapacity = 256;
+
+// SortVersionSet() insertion sorts runs this long, before merging them.
+static const size_t _insertionRunLength = 16;
+
+static const char _alphanumT = 'a';
+static const char _numericT = 'N';
+
+// Where an entry's triple and prerelease tags are, whether it's compact or
+// has a detail record.
+typedef struct
+{
+	size_t majorDigits;
+	size_t minorDigits;
+	size_t patchDigits;
+	size_t prereleaseFieldCount;
+	const VersionSetTag *pTags;
+} EntryShape;
+
+// Private functions in alphabetical order...
+
+// Numbers in SemVer strings have no leading zeros, so the longer one is bigger.
+static inline int CompareNumbers(const char *pV1, size_t length1, const char *pV2, size_t length2)
+{
+	if (length1 != length2) return (length1 > length2) ? 1 : -1;
+
+	int result = memcmp(pV1, pV2, length1);
+
+	return (result > 0) - (result < 0);
+}
+
+// Same rules as ComparePrereleaseFields() in SemVer.c, for the fields at pV1
+// and pV2.
+static inline int CompareTags(const char *pV1, VersionSetTag tag1, const char *pV2, VersionSetTag tag2)
+{
+	bool isNumeric1 = (0 != (tag1 & VERSION_SET_TAG_NUMERIC));
+	bool isNumeric2 = (0 != (tag2 & VERSION_SET_TAG_NUMERIC));
+	size_t length1 = tag1 & VERSION_SET_TAG_LENGTH_MASK;
+	size_t length2 = tag2 & VERSION_SET_TAG_LENGTH_MASK;
+
+	// Numeric fields always have lower precedence than alphanumeric fields.
+	if (isNumeric1 != isNumeric2) return isNumeric1 ? -1 : 1;
+	if (isNumeric1) return CompareNumbers(pV1, length1, pV2, length2);
+
+	size_t commonLength = (length1 < length2) ? length1 : length2;
+	int result = memcmp(pV1, pV2, commonLength);
+
+	if (0 != result) return (result > 0) ? 1 : -1;
+	if (length1 != length2) return (length1 > length2) ? 1 : -1;
+
+	return 0;
+}
+
+// NULL for a compact entry.
+static inline const VersionSetDetail* GetDetail(const VersionSet *pSet, const VersionSetEntry *pEntry)
+{
+	return (0 == pEntry->majorDigits) ? &pSet->pDetails[pEntry->dataIdx] : NULL;
+}
+
+static inline void GetEntryShape(const VersionSet *pSet, const VersionSetEntry *pEntry, EntryShape *pShape)
+{
+	const VersionSetDetail *pDetail = GetDetail(pSet, pEntry);
+
+	if (NULL == pDetail)
+	{
+		pShape->majorDigits = pEntry->majorDigits;
+		pShape->minorDigits = pEntry->minorDigits;
+		pShape->patchDigits = pEntry->patchDigits;
+		pShape->prereleaseFieldCount = pEntry->prereleaseFieldCount;
+		pShape->pTags = pSet->pTags + pEntry->dataIdx;
+	}
+	else
+	{
+		pShape->majorDigits = pDetail->majorDigits;
+		pShape->minorDigits = pDetail->minorDigits;
+		pShape->patchDigits = pDetail->patchDigits;
+		pShape->prereleaseFieldCount = pDetail->prereleaseFieldCount;
+		pShape->pTags = pSet->pTags + pDetail->firstTagIdx;
+	}
+}
+
+static inline bool IsSemVerEntry(const VersionSet *pSet, const VersionSetEntry *pEntry)
+{
+	const VersionSetDetail *pDetail = GetDetail(pSet, pEntry);
+
+	return (NULL == pDetail) || (eSemVer_2_0_0 == pDetail->versionType);
+}
+
+// CompareVersions(), for two entries that are both SemVer.
+static int CompareEntries(const VersionSet *pSet, const VersionSetEntry *pEntry1, const VersionSetEntry *pEntry2)
+{
+	EntryShape shape1;
+	EntryShape shape2;
+
+	GetEntryShape(pSet, pEntry1, &shape1);
+	GetEntryShape(pSet, pEntry2, &shape2);
+
+	const char *pV1 = pSet->pStrings + pEntry1->stringOffset;
+	const char *pV2 = pSet->pStrings + pEntry2->stringOffset;
+
+	int result = CompareNumbers(pV1, shape1.majorDigits, pV2, shape2.majorDigits);
+
+	if (0 != result) return result;
+
+	pV1 += shape1.majorDigits + 1;
+	pV2 += shape2.majorDigits + 1;
+	result = CompareNumbers(pV1, shape1.minorDigits, pV2, shape2.minorDigits);
+
+	if (0 != result) return result;
+
+	pV1 += shape1.minorDigits + 1;
+	pV2 += shape2.minorDigits + 1;
+	result = CompareNumbers(pV1, shape1.patchDigits, pV2, shape2.patchDigits);
+
+	if (0 != result) return result;
+
+	// With equal triples, the one without a prerelease tag is "bigger".
+	size_t fieldCount1 = shape1.prereleaseFieldCount;
+	size_t fieldCount2 = shape2.prereleaseFieldCount;
+
+	if ((0 == fieldCount1) != (0 == fieldCount2)) return (0 == fieldCount1) ? 1 : -1;
+	if (0 == fieldCount1) return 0;
+
+	size_t commonCount = (fieldCount1 < fieldCount2) ? fieldCount1 : fieldCount2;
+
+	// Step over the patch and the '-'.
+	pV1 += shape1.patchDigits + 1;
+	pV2 += shape2.patchDigits + 1;
+
+	for (size_t idx = 0; idx < commonCount; idx++)
+	{
+		result = CompareTags(pV1, shape1.pTags[idx], pV2, shape2.pTags[idx]);
+
+		if (0 != result) return result;
+
+		pV1 += (shape1.pTags[idx] & VERSION_SET_TAG_LENGTH_MASK) + 1;
+		pV2 += (shape2.pTags[idx] & VERSION_SET_TAG_LENGTH_MASK) + 1;
+	}
+
+	if (fieldCount1 != fieldCount2) return (fieldCount1 > fieldCount2) ? 1 : -1;
+
+	return 0;
+}
+
+// Make room for count more elements in a dynamic array.
+static bool Reserve(void **ppArray, size_t *pCapacity, size_t used, size_t count, size_t elementSize)
+{
+	if (used + count <= *pCapacity) return true;
+
+	size_t capacity = (0 == *pCapacity) ? _initialCapacity : *pCapacity;
+
+	while (capacity < used + count)
+	{
+		capacity *= 2;
+	}
+
+	if (capacity > (SIZE_MAX / elementSize)) return false;
+
+	void *pGrown = realloc(*ppArray, capacity * elementSize);
+
+	if (NULL == pGrown) return false;
+
+	*ppArray = pGrown;
+	*pCapacity = capacity;
+
+	return true;
+}
+
+// SortVersionSet() order.  SemVer first, and everything else is equal.
+static inline int SortOrder(const VersionSet *pSet, const VersionSetEntry *pEntry1, const VersionSetEntry *pEntry2)
+{
+	bool isSemVer1 = IsSemVerEntry(pSet, pEntry1);
+	bool isSemVer2 = IsSemVerEntry(pSet, pEntry2);
+
+	if (isSemVer1 && isSemVer2) return CompareEntries(pSet, pEntry1, pEntry2);
+	if (isSemVer1 == isSemVer2) return 0;
+
+	return isSemVer1 ? -1 : 1;
+}
+
+static void InsertionSort(const VersionSet *pSet, VersionSetEntry *pEntries, size_t count)
+{
+	for (size_t idx = 1; idx < count; idx++)
+	{
+		VersionSetEntry entry = pEntries[idx];
+		size_t hole = idx;
+
+		while ((0 != hole) && (SortOrder(pSet, &pEntries[hole - 1], &entry) > 0))
+		{
+			pEntries[hole] = pEntries[hole - 1];
+			hole--;
+		}
+
+		pEntries[hole] = entry;
+	}
+}
+
+// Stable merge of two sorted runs into pOut.
+static void MergeRuns(const VersionSet *pSet, const VersionSetEntry *pA, size_t countA, const VersionSetEntry *pB, size_t countB, VersionSetEntry *pOut)
+{
+	size_t idxA = 0;
+	size_t idxB = 0;
+
+	while ((idxA < countA) && (idxB < countB))
+	{
+		*pOut++ = (SortOrder(pSet, &pB[idxB], &pA[idxA]) < 0) ? pB[idxB++] : pA[idxA++];
+	}
+
+	memcpy(pOut, pA + idxA, (countA - idxA) * sizeof(VersionSetEntry));
+	memcpy(pOut + (countA - idxA), pB + idxB, (countB - idxB) * sizeof(VersionSetEntry));
+}
+
+void InitVersionSet(VersionSet *pSet)
+{
+	assert(NULL != pSet);
+
+	memset(pSet, 0, sizeof(VersionSet));
+}
+
+void FreeVersionSet(VersionSet *pSet)
+{
+	assert(NULL != pSet);
+
+	free(pSet->pEntries);
+	free(pSet->pTags);
+	free(pSet->pDetails);
+	free(pSet->pStrings);
+	InitVersionSet(pSet);
+}
+
+bool AddVersion(VersionSet *pSet, const char *pVersion, size_t length)
+{
+	assert(NULL != pSet);
+	assert((NULL != pVersion) || (0 == length));
+
+	if (length > VERSION_SET_MAX_LENGTH) return false;
+	if (pSet->stringBytes + length + 1 > UINT32_MAX) return false;
+
+	VersionParseRecord record;
+
+	ClassifyVersionCandidateN((NULL != pVersion) ? pVersion : "", length, &record);
+
+	bool isSemVer = (eSemVer_2_0_0 == record.versionType);
+	bool isCompact = isSemVer
+		&& (record.majorDigits <= UINT8_MAX)
+		&& (record.minorDigits <= UINT8_MAX)
+		&& (record.patchDigits <= UINT8_MAX)
+		&& (record.prereleaseFieldCount <= UINT8_MAX);
+	size_t tagCount = isSemVer ? record.prereleaseFieldCount : 0;
+	size_t detailCount = isCompact ? 0 : 1;
+
+	if (   (pSet->tagCount + tagCount > UINT32_MAX)
+		|| (pSet->detailCount + detailCount > UINT32_MAX)
+		|| !Reserve((void**)&pSet->pEntries, &pSet->entryCapacity, pSet->count, 1, sizeof(VersionSetEntry))
+		|| !Reserve((void**)&pSet->pTags, &pSet->tagCapacity, pSet->tagCount, tagCount, sizeof(VersionSetTag))
+		|| !Reserve((void**)&pSet->pDetails, &pSet->detailCapacity, pSet->detailCount, detailCount, sizeof(VersionSetDetail))
+		|| !Reserve((void**)&pSet->pStrings, &pSet->stringCapacity, pSet->stringBytes, length + 1, sizeof(char)))
+	{
+		FreeVersionParseData(&record);
+		return false;
+	}
+
+	VersionSetEntry *pEntry = &pSet->pEntries[pSet->count];
+	memset(pEntry, 0, sizeof(*pEntry));
+
+	pEntry->stringOffset = (uint32_t)pSet->stringBytes;
+
+	if (isCompact)
+	{
+		pEntry->dataIdx = (uint32_t)pSet->tagCount;
+		pEntry->majorDigits = (uint8_t)record.majorDigits;
+		pEntry->minorDigits = (uint8_t)record.minorDigits;
+		pEntry->patchDigits = (uint8_t)record.patchDigits;
+		pEntry->prereleaseFieldCount = (uint8_t)record.prereleaseFieldCount;
+	}
+	else
+	{
+		VersionSetDetail *pDetail = &pSet->pDetails[pSet->detailCount];
+		memset(pDetail, 0, sizeof(*pDetail));
+
+		// Digit counts can't be longer than the string.
+		pDetail->firstTagIdx = (uint32_t)pSet->tagCount;
+		pDetail->majorDigits = (uint16_t)record.majorDigits;
+		pDetail->minorDigits = (uint16_t)record.minorDigits;
+		pDetail->patchDigits = (uint16_t)record.patchDigits;
+		pDetail->prereleaseFieldCount = (uint16_t)tagCount;
+		pDetail->versionType = (uint8_t)record.versionType;
+		pDetail->state = (uint8_t)record.state;
+
+		if (record.isPrereleaseVersion) pDetail->flags |= eVersionSetIsPrereleaseVersion;
+		if (record.majorHasLeadingZero) pDetail->flags |= eVersionSetMajorHasLeadingZero;
+		if (record.minorHasLeadingZero) pDetail->flags |= eVersionSetMinorHasLeadingZero;
+		if (record.patchHasLeadingZero) pDetail->flags |= eVersionSetPatchHasLeadingZero;
+
+		pEntry->dataIdx = (uint32_t)pSet->detailCount++;
+	}
+
+	for (size_t idx = 0; idx < tagCount; idx++)
+	{
+		const ParsedTagRecord *pField = &record.pPrereleaseData[idx];
+		VersionSetTag tag = (VersionSetTag)pField->fieldLength;
+
+		if (_numericT == pField->fieldType) tag |= VERSION_SET_TAG_NUMERIC;
+
+		pSet->pTags[pSet->tagCount++] = tag;
+	}
+
+	if (0 != length)
+	{
+		memcpy(&pSet->pStrings[pSet->stringBytes], pVersion, length);
+	}
+
+	pSet->pStrings[pSet->stringBytes + length] = '\0';
+	pSet->stringBytes += length + 1;
+	pSet->count++;
+
+	FreeVersionParseData(&record);
+
+	return true;
+}
+
+bool AddVersions(VersionSet *pSet, const char * const *ppVersions, const size_t *pLengths, size_t count)
+{
+	assert(NULL != pSet);
+	assert((NULL != ppVersions) || (0 == count));
+
+	size_t stringBytes = 0;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		stringBytes += ((NULL != pLengths) ? pLengths[idx] : strlen(ppVersions[idx])) + 1;
+	}
+
+	// Tags are the only thing we can't size without classifying.
+	if (   !Reserve((void**)&pSet->pEntries, &pSet->entryCapacity, pSet->count, count, sizeof(VersionSetEntry))
+		|| !Reserve((void**)&pSet->pStrings, &pSet->stringCapacity, pSet->stringBytes, stringBytes, sizeof(char)))
+	{
+		return false;
+	}
+
+	size_t oldCount = pSet->count;
+	size_t oldTagCount = pSet->tagCount;
+	size_t oldDetailCount = pSet->detailCount;
+	size_t oldStringBytes = pSet->stringBytes;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		size_t length = (NULL != pLengths) ? pLengths[idx] : strlen(ppVersions[idx]);
+
+		if (!AddVersion(pSet, ppVersions[idx], length))
+		{
+			pSet->count = oldCount;
+			pSet->tagCount = oldTagCount;
+			pSet->detailCount = oldDetailCount;
+			pSet->stringBytes = oldStringBytes;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const char* GetVersionSetString(const VersionSet *pSet, size_t idx)
+{
+	assert(NULL != pSet);
+	assert(idx < pSet->count);
+
+	return pSet->pStrings + pSet->pEntries[idx].stringOffset;
+}
+
+const char* GetVersionSetVersion(const VersionSet *pSet, size_t idx, VersionParseRecord *pParsed)
+{
+	assert(NULL != pSet);
+	assert(idx < pSet->count);
+	assert(NULL != pParsed);
+
+	const VersionSetEntry *pEntry = &pSet->pEntries[idx];
+	const VersionSetDetail *pDetail = GetDetail(pSet, pEntry);
+	const char *pVersion = pSet->pStrings + pEntry->stringOffset;
+	EntryShape shape;
+
+	GetEntryShape(pSet, pEntry, &shape);
+	memset(pParsed, 0, sizeof(*pParsed));
+
+	pParsed->versionType = eSemVer_2_0_0;
+	pParsed->majorDigits = shape.majorDigits;
+	pParsed->minorDigits = shape.minorDigits;
+	pParsed->patchDigits = shape.patchDigits;
+
+	if ((NULL != pDetail) && (eSemVer_2_0_0 != pDetail->versionType))
+	{
+		pParsed->versionType = (VersionType)pDetail->versionType;
+		pParsed->state = (ParseState)pDetail->state;
+		pParsed->isPrereleaseVersion = (0 != (pDetail->flags & eVersionSetIsPrereleaseVersion));
+		pParsed->majorHasLeadingZero = (0 != (pDetail->flags & eVersionSetMajorHasLeadingZero));
+		pParsed->minorHasLeadingZero = (0 != (pDetail->flags & eVersionSetMinorHasLeadingZero));
+		pParsed->patchHasLeadingZero = (0 != (pDetail->flags & eVersionSetPatchHasLeadingZero));
+
+		return pVersion;
+	}
+
+	// Everything else about a SemVer string can be read off the string.  A
+	// field only has a leading zero if it's "0".
+	pParsed->minorIdx = shape.majorDigits + 1;
+	pParsed->patchIdx = pParsed->minorIdx + shape.minorDigits + 1;
+	pParsed->parsedIdx = strlen(pVersion);
+	pParsed->majorHasLeadingZero = ('0' == pVersion[0]);
+	pParsed->minorHasLeadingZero = ('0' == pVersion[pParsed->minorIdx]);
+	pParsed->patchHasLeadingZero = ('0' == pVersion[pParsed->patchIdx]);
+
+	size_t tagIdx = pParsed->patchIdx + shape.patchDigits;
+	const char *pMeta = strchr(pVersion + tagIdx, '+');
+
+	pParsed->prereleaseFieldCount = shape.prereleaseFieldCount;
+	pParsed->hasPrereleaseTag = (0 != shape.prereleaseFieldCount);
+	pParsed->hasMetaTag = (NULL != pMeta);
+	pParsed->isPrereleaseVersion = pParsed->hasPrereleaseTag || pParsed->majorHasLeadingZero;
+
+	if (pParsed->hasMetaTag)
+	{
+		pParsed->metaFieldCount = 1;
+
+		for (const char *pChar = pMeta + 1; '\0' != *pChar; pChar++)
+		{
+			if ('.' == *pChar) pParsed->metaFieldCount++;
+		}
+	}
+
+	if (pParsed->hasPrereleaseTag) pParsed->pPrereleaseData = calloc(pParsed->prereleaseFieldCount, sizeof(ParsedTagRecord));
+	if (pParsed->hasMetaTag) pParsed->pMetaData = calloc(pParsed->metaFieldCount, sizeof(ParsedTagRecord));
+
+	if ((pParsed->hasPrereleaseTag && (NULL == pParsed->pPrereleaseData)) || (pParsed->hasMetaTag && (NULL == pParsed->pMetaData)))
+	{
+		FreeVersionParseData(pParsed);
+		return NULL;
+	}
+
+	// Tag character counts are the field characters, without any delims.
+	for (size_t idx = 0; idx < pParsed->prereleaseFieldCount; idx++)
+	{
+		ParsedTagRecord *pField = &pParsed->pPrereleaseData[idx];
+		bool isNumeric = (0 != (shape.pTags[idx] & VERSION_SET_TAG_NUMERIC));
+
+		pField->fieldIdx = tagIdx + 1;
+		pField->fieldLength = shape.pTags[idx] & VERSION_SET_TAG_LENGTH_MASK;
+		pField->fieldType = isNumeric ? _numericT : _alphanumT;
+		pField->fieldHasLeadingZero = isNumeric && ('0' == pVersion[pField->fieldIdx]);
+		pParsed->prereleaseChars += pField->fieldLength;
+		tagIdx = pField->fieldIdx + pField->fieldLength;
+	}
+
+	if (pParsed->hasMetaTag)
+	{
+		size_t fieldIdx = (size_t)(pMeta - pVersion) + 1;
+
+		for (size_t idx = 0; idx < pParsed->metaFieldCount; idx++)
+		{
+			ParsedTagRecord *pField = &pParsed->pMetaData[idx];
+			const char *pEnd = strchr(pVersion + fieldIdx, '.');
+
+			pField->fieldIdx = fieldIdx;
+			pField->fieldLength = (NULL != pEnd) ? (size_t)(pEnd - pVersion) - fieldIdx : pParsed->parsedIdx - fieldIdx;
+			pParsed->metaChars += pField->fieldLength;
+			fieldIdx += pField->fieldLength + 1;
+		}
+	}
+
+	// Where the classifier stopped: in the last field it saw.
+	if (pParsed->hasMetaTag)
+	{
+		pParsed->state = eInMetaField;
+	}
+	else if (pParsed->hasPrereleaseTag)
+	{
+		bool isNumeric = (_numericT == pParsed->pPrereleaseData[pParsed->prereleaseFieldCount - 1].fieldType);
+
+		pParsed->state = isNumeric ? eInPreNumericField : eInPreAlphaNumericField;
+	}
+	else
+	{
+		pParsed->state = eInPatch;
+	}
+
+	return pVersion;
+}
+
+int CompareVersionSetVersions(const VersionSet *pSet, size_t idx1, size_t idx2)
+{
+	assert(NULL != pSet);
+	assert((idx1 < pSet->count) && (idx2 < pSet->count));
+
+	const VersionSetEntry *pEntry1 = &pSet->pEntries[idx1];
+	const VersionSetEntry *pEntry2 = &pSet->pEntries[idx2];
+
+	// We don't know how to compare non-SemVer strings.
+	if (!IsSemVerEntry(pSet, pEntry1) || !IsSemVerEntry(pSet, pEntry2)) return -2;
+
+	return CompareEntries(pSet, pEntry1, pEntry2);
+}
+
+bool SortVersionSet(VersionSet *pSet)
+{
+	assert(NULL != pSet);
+
+	size_t count = pSet->count;
+
+	if (count <= _insertionRunLength)
+	{
+		InsertionSort(pSet, pSet->pEntries, count);
+		return true;
+	}
+
+	VersionSetEntry *pScratch = malloc(count * sizeof(VersionSetEntry));
+
+	if (NULL == pScratch) return false;
+
+	VersionSetEntry *pFrom = pSet->pEntries;
+	VersionSetEntry *pTo = pScratch;
+
+	for (size_t start = 0; start < count; start += _insertionRunLength)
+	{
+		InsertionSort(pSet, pFrom + start, (count - start < _insertionRunLength) ? count - start : _insertionRunLength);
+	}
+
+	for (size_t width = _insertionRunLength; width < count; width *= 2)
+	{
+		for (size_t start = 0; start < count; start += 2 * width)
+		{
+			size_t countA = (count - start < width) ? count - start : width;
+			size_t countB = (count - start - countA < width) ? count - start - countA : width;
+
+			MergeRuns(pSet, pFrom + start, countA, pFrom + start + countA, countB, pTo + start);
+		}
+
+		VersionSetEntry *pSwap = pFrom;
+		pFrom = pTo;
+		pTo = pSwap;
+	}
+
+	if (pFrom != pSet->pEntries)
+	{
+		memcpy(pSet->pEntries, pFrom, count * sizeof(VersionSetEntry));
+	}
+
+	free(pScratch);
+
+	return true;
+}
@@ -0,0 +1,164 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerSet_h_Defined
+#define _SharperHacks_SemVerSet_h_Defined
+
+#include <stdint.h>
+
+#include "SemVer.h"
+
+// A VersionSet keeps many versions in four flat arrays, instead of a string 
+// and a VersionParseRecord with its own tag arrays per version:
+//
+//   VersionSetEntry[count]			Compact parse results, one per version.
+//   VersionSetTag[tagCount]		Prerelease fields, per SemVer entry.
+//   VersionSetDetail[detailCount]	What doesn't fit in an entry.
+//   char[stringBytes]				Null terminated version strings.
+//
+// Entries refer to their string, tags and details by offset, so sorting only
+// moves entries, and the whole set is freed with four calls to free().  It's
+// the in-memory cousin of a version catalog, sized for a lot of short strings.
+//
+// A typical SemVer string fits in an entry, and one tag per prerelease field.
+// Everything else the classifier reports about it, meta fields included, can
+// be read off the string again.  Strings that aren't SemVer, and SemVer 
+// strings with more than 255 of anything, get a detail record.
+
+// Longest string a VersionSet will hold.
+#define VERSION_SET_MAX_LENGTH INT16_MAX
+
+// Detail flags, for strings that aren't SemVer.  For SemVer strings, these 
+// follow from the string.
+typedef enum
+{
+	eVersionSetIsPrereleaseVersion = 0x01,
+	eVersionSetMajorHasLeadingZero = 0x02,
+	eVersionSetMinorHasLeadingZero = 0x04,
+	eVersionSetPatchHasLeadingZero = 0x08
+} VersionSetFlag;
+
+// The compact form of a prerelease ParsedTagRecord: the field's length, with
+// VERSION_SET_TAG_NUMERIC set for a numeric field.  Each field starts one 
+// delimiter after the last, and a numeric field only has a leading zero if 
+// it's "0", so nothing else needs keeping.
+typedef uint16_t VersionSetTag;
+
+#define VERSION_SET_TAG_NUMERIC 0x8000
+#define VERSION_SET_TAG_LENGTH_MASK 0x7FFF
+
+// The compact form of a VersionParseRecord, for a SemVer string whose digit 
+// and prerelease field counts all fit in a byte.  Any other string has a 
+// majorDigits of 0, and its parse results are in pDetails[dataIdx].
+typedef struct _VersionSetEntry
+{
+	uint32_t stringOffset;		// From the start of pStrings.
+	uint32_t dataIdx;			// Into pTags for the first prerelease field, or into pDetails.
+	uint8_t majorDigits;
+	uint8_t minorDigits;
+	uint8_t patchDigits;
+	uint8_t prereleaseFieldCount;
+} VersionSetEntry;
+
+// The parse results of a string that doesn't fit in an entry.  Only SemVer
+// strings have tags.
+typedef struct _VersionSetDetail
+{
+	uint32_t firstTagIdx;		// Into pTags.
+	uint16_t majorDigits;
+	uint16_t minorDigits;
+	uint16_t patchDigits;
+	uint16_t prereleaseFieldCount;
+	uint8_t versionType;
+	uint8_t state;				// The ParseState classification stopped in.
+	uint8_t flags;				// VersionSetFlag bits.
+} VersionSetDetail;
+
+typedef struct _VersionSet
+{
+	VersionSetEntry *pEntries;
+	size_t count;
+	size_t entryCapacity;
+
+	VersionSetTag *pTags;
+	size_t tagCount;
+	size_t tagCapacity;
+
+	VersionSetDetail *pDetails;
+	size_t detailCount;
+	size_t detailCapacity;
+
+	char *pStrings;
+	size_t stringBytes;
+	size_t stringCapacity;
+} VersionSet;
+
+/// <summary>
+/// Initialize an empty set.
+/// </summary>
+extern void InitVersionSet(VersionSet *pSet);
+
+/// <summary>
+/// Free everything the set owns, leaving it empty.
+/// </summary>
+extern void FreeVersionSet(VersionSet *pSet);
+
+/// <summary>
+/// Classify a version string and add it, and its parse results, to the set.
+/// </summary>
+/// <param name="pVersion">Need not be null terminated.</param>
+/// <param name="length">Count of characters in pVersion.</param>
+/// <returns>
+/// False if we're out of memory, the string is longer than 
+/// VERSION_SET_MAX_LENGTH, or the set would pass 4 GB of strings, in which
+/// case the set is untouched.  Strings that aren't SemVer are added too, so
+/// entry indexes always match the order of the calls.
+/// </returns>
+extern bool AddVersion(VersionSet *pSet, const char *pVersion, size_t length);
+
+/// <summary>
+/// AddVersion() for count strings, with the set grown once, to fit, up front.
+/// </summary>
+/// <param name="pLengths">NULL if the strings are null terminated.</param>
+/// <returns>False if any of them couldn't be added, in which case the set is untouched.</returns>
+extern bool AddVersions(VersionSet *pSet, const char * const *ppVersions, const size_t *pLengths, size_t count);
+
+/// <summary>
+/// The null terminated string for entry idx.
+/// </summary>
+extern const char* GetVersionSetString(const VersionSet *pSet, size_t idx);
+
+/// <summary>
+/// Expand entry idx back into a VersionParseRecord.
+/// </summary>
+/// <param name="pParsed">
+/// Receives a record with its own tag arrays, release them with
+/// FreeVersionParseData().
+/// </param>
+/// <returns>The null terminated version string, or NULL if we ran out of memory.</returns>
+extern const char* GetVersionSetVersion(const VersionSet *pSet, size_t idx, VersionParseRecord *pParsed);
+
+/// <summary>
+/// Same as CompareVersions(), for two entries, without expanding either one.
+/// </summary>
+extern int CompareVersionSetVersions(const VersionSet *pSet, size_t idx1, size_t idx2);
+
+/// <summary>
+/// Stable sort of the entries, in the same order as SortVersions(): SemVer 
+/// strings by precedence, then everything else in the order it was added.
+/// </summary>
+/// <remarks>
+/// Strings, tags and details stay where they are, only the entries move.
+/// Needs one entry of scratch space per version.
+/// </remarks>
+/// <returns>False if we ran out of memory, in which case the set is untouched.</returns>
+extern bool SortVersionSet(VersionSet *pSet);
+
+#endif
@@ -0,0 +1,607 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerSort.h"
+#include "SemVerThreads.h"
+
+#include <assert.h>
+#include <memory.h>
+#include <stdint.h>
+
+// Runs shorter than this are insertion sorted.
+#define INSERTION_SORT_LENGTH 16
+
+// Don't bother with another thread for less than this many versions.
+#define MIN_VERSIONS_PER_THREAD 1024
+
+// Precedence keys pack each field of the triple into this many bits.  A field
+// that doesn't fit saturates, along with everything below it, so that keys
+// only ever tie, and never lie.
+#define KEY_FIELD_BITS 20
+#define KEY_FIELD_MAX ((1u << KEY_FIELD_BITS) - 1)
+
+typedef const SortableVersion* SortItem;
+
+// A version, and its precedence key.
+typedef struct
+{
+	uint64_t key;
+	SortItem pItem;
+} KeyedItem;
+
+// One thread's slice, for the first phase.
+typedef struct
+{
+	SortItem *ppItems;
+	SortItem *ppScratch;
+	size_t count;
+} SliceTask;
+
+// One piece of the output of merging runs A and B, for the second phase.
+typedef struct
+{
+	const SortItem *ppA;
+	size_t countA;
+	const SortItem *ppB;
+	size_t countB;
+	size_t first;
+	size_t last;
+	SortItem *ppOut;
+} MergeTask;
+
+// Each merge thread works through every threadCount'th task.
+typedef struct
+{
+	MergeTask *pTasks;
+	size_t taskCount;
+	size_t firstTask;
+	size_t step;
+} MergeWorker;
+
+// Private functions in alphabetical order...
+
+static inline bool ItemLess(SortItem pItem1, SortItem pItem2)
+{
+	return CompareSortableVersions(pItem1, pItem2) < 0;
+}
+
+static inline int CompareKeyed(const KeyedItem *pItem1, const KeyedItem *pItem2)
+{
+	if (pItem1->key != pItem2->key) return (pItem1->key < pItem2->key) ? -1 : 1;
+
+	return CompareSortableVersions(pItem1->pItem, pItem2->pItem);
+}
+
+static int CompareKeyedEntries(const void *p1, const void *p2)
+{
+	return CompareKeyed((const KeyedItem*)p1, (const KeyedItem*)p2);
+}
+
+// The number of items from A in the first k items of the stable merge of A
+// and B.  Merge path partitioning, by binary search along the diagonal.
+static size_t CoRank(size_t k, const SortItem *ppA, size_t countA, const SortItem *ppB, size_t countB)
+{
+	size_t low = (k > countB) ? k - countB : 0;
+	size_t high = (k < countA) ? k : countA;
+
+	while (low < high)
+	{
+		size_t i = low + ((high - low) / 2);
+		size_t j = k - i;
+
+		// Items from A win ties, so if B[j - 1] isn't less than A[i], then 
+		// A[i] came first, and so we need more of A.
+		if ((0 != j) && (i < countA) && !ItemLess(ppB[j - 1], ppA[i]))
+		{
+			low = i + 1;
+		}
+		else
+		{
+			high = i;
+		}
+	}
+
+	return low;
+}
+
+// The value of a field of the triple, or KEY_FIELD_MAX if it won't fit.
+static uint64_t FieldKey(const char *pVersion, size_t idx, size_t digits)
+{
+	// Seven digits is always too many, and six never overflows the math.
+	if (digits > 6) return KEY_FIELD_MAX;
+
+	uint64_t value = 0;
+
+	for (size_t count = 0; count < digits; count++)
+	{
+		value = (value * 10) + (uint64_t)(pVersion[idx + count] - '0');
+	}
+
+	return (value < KEY_FIELD_MAX) ? value : KEY_FIELD_MAX;
+}
+
+// Stable insertion sort, for short runs.
+static void InsertionSort(SortItem *ppItems, size_t count)
+{
+	for (size_t idx = 1; idx < count; idx++)
+	{
+		SortItem pItem = ppItems[idx];
+		size_t hole = idx;
+
+		while ((0 != hole) && ItemLess(pItem, ppItems[hole - 1]))
+		{
+			ppItems[hole] = ppItems[hole - 1];
+			hole--;
+		}
+
+		ppItems[hole] = pItem;
+	}
+}
+
+// Keyed insertion sort, for what's left when quickselect gets close.
+static void KeyedInsertionSort(KeyedItem *pItems, size_t count)
+{
+	for (size_t idx = 1; idx < count; idx++)
+	{
+		KeyedItem item = pItems[idx];
+		size_t hole = idx;
+
+		while ((0 != hole) && (CompareKeyed(&item, &pItems[hole - 1]) < 0))
+		{
+			pItems[hole] = pItems[hole - 1];
+			hole--;
+		}
+
+		pItems[hole] = item;
+	}
+}
+
+// Stable merge, items from A win ties.
+static void MergeItems(const SortItem *ppA, size_t countA, const SortItem *ppB, size_t countB, SortItem *ppOut)
+{
+	size_t i = 0;
+	size_t j = 0;
+
+	while ((i < countA) && (j < countB))
+	{
+		*ppOut++ = ItemLess(ppB[j], ppA[i]) ? ppB[j++] : ppA[i++];
+	}
+
+	memcpy(ppOut, ppA + i, (countA - i) * sizeof(SortItem));
+	memcpy(ppOut + (countA - i), ppB + j, (countB - j) * sizeof(SortItem));
+}
+
+static void MergeSegment(MergeTask *pTask)
+{
+	size_t firstA = CoRank(pTask->first, pTask->ppA, pTask->countA, pTask->ppB, pTask->countB);
+	size_t lastA = CoRank(pTask->last, pTask->ppA, pTask->countA, pTask->ppB, pTask->countB);
+	size_t firstB = pTask->first - firstA;
+	size_t lastB = pTask->last - lastA;
+
+	MergeItems(pTask->ppA + firstA, lastA - firstA, pTask->ppB + firstB, lastB - firstB, pTask->ppOut + pTask->first);
+}
+
+static void MergeWorkerProc(void *pArg)
+{
+	MergeWorker *pWorker = (MergeWorker*)pArg;
+
+	for (size_t idx = pWorker->firstTask; idx < pWorker->taskCount; idx += pWorker->step)
+	{
+		MergeSegment(&pWorker->pTasks[idx]);
+	}
+}
+
+// Put each version where the sorted item array says it goes, by following the
+// cycles of the permutation.  Items are reset to point at their own slot as
+// we go, which marks them done.
+static void Permute(SortableVersion *pVersions, SortItem *ppItems, size_t count)
+{
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		if (ppItems[idx] == &pVersions[idx]) continue;
+
+		SortableVersion saved = pVersions[idx];
+		size_t hole = idx;
+
+		for (;;)
+		{
+			size_t source = (size_t)(ppItems[hole] - pVersions);
+			ppItems[hole] = &pVersions[hole];
+
+			if (source == idx)
+			{
+				pVersions[hole] = saved;
+				break;
+			}
+
+			pVersions[hole] = pVersions[source];
+			hole = source;
+		}
+	}
+}
+
+// Quickselect, with a three way partition, because real version lists are
+// full of duplicates.  When it takes too many rounds, sort what's left.
+static void SelectKeyed(KeyedItem *pItems, size_t count, size_t nth)
+{
+	size_t left = 0;
+	size_t right = count;
+	size_t roundsLeft = 2;
+
+	for (size_t remaining = count; remaining > 1; remaining >>= 1) roundsLeft += 2;
+
+	while (right - left > INSERTION_SORT_LENGTH)
+	{
+		if (0 == roundsLeft--)
+		{
+			qsort(pItems + left, right - left, sizeof(KeyedItem), CompareKeyedEntries);
+			return;
+		}
+
+		// Median of three.
+		KeyedItem *pFirst = &pItems[left];
+		KeyedItem *pMiddle = &pItems[left + ((right - left) / 2)];
+		KeyedItem *pLast = &pItems[right - 1];
+		KeyedItem pivot;
+
+		if (CompareKeyed(pFirst, pMiddle) < 0)
+		{
+			pivot = (CompareKeyed(pMiddle, pLast) < 0) ? *pMiddle : ((CompareKeyed(pFirst, pLast) < 0) ? *pLast : *pFirst);
+		}
+		else
+		{
+			pivot = (CompareKeyed(pFirst, pLast) < 0) ? *pFirst : ((CompareKeyed(pMiddle, pLast) < 0) ? *pLast : *pMiddle);
+		}
+
+		// [left, less) < pivot, [less, idx) == pivot, [greater, right) > pivot.
+		size_t less = left;
+		size_t idx = left;
+		size_t greater = right;
+
+		while (idx < greater)
+		{
+			int result = CompareKeyed(&pItems[idx], &pivot);
+			KeyedItem swap = pItems[idx];
+
+			if (result < 0)
+			{
+				pItems[idx++] = pItems[less];
+				pItems[less++] = swap;
+			}
+			else if (result > 0)
+			{
+				pItems[idx] = pItems[--greater];
+				pItems[greater] = swap;
+			}
+			else
+			{
+				idx++;
+			}
+		}
+
+		if (nth < less)
+		{
+			right = less;
+		}
+		else if (nth >= greater)
+		{
+			left = greater;
+		}
+		else
+		{
+			// nth landed among the pivots, we're done.
+			return;
+		}
+	}
+
+	KeyedInsertionSort(pItems + left, right - left);
+}
+
+// Restore the min-heap property below idx, for TopVersions().
+static void SiftDownKeyed(KeyedItem *pHeap, size_t count, size_t idx)
+{
+	for (;;)
+	{
+		size_t smallest = idx;
+		size_t left = (2 * idx) + 1;
+		size_t right = left + 1;
+
+		if ((left < count) && (CompareKeyed(&pHeap[left], &pHeap[smallest]) < 0)) smallest = left;
+		if ((right < count) && (CompareKeyed(&pHeap[right], &pHeap[smallest]) < 0)) smallest = right;
+
+		if (smallest == idx) return;
+
+		KeyedItem swap = pHeap[idx];
+		pHeap[idx] = pHeap[smallest];
+		pHeap[smallest] = swap;
+		idx = smallest;
+	}
+}
+
+// Stable merge sort.  The result ends up in ppItems, ppScratch is trashed.
+static void StableSort(SortItem *ppItems, SortItem *ppScratch, size_t count)
+{
+	if (count <= INSERTION_SORT_LENGTH)
+	{
+		InsertionSort(ppItems, count);
+		return;
+	}
+
+	size_t half = count / 2;
+
+	StableSort(ppItems, ppScratch, half);
+	StableSort(ppItems + half, ppScratch + half, count - half);
+
+	// Nothing to do if the halves are already in order.
+	if (!ItemLess(ppItems[half], ppItems[half - 1])) return;
+
+	memcpy(ppScratch, ppItems, count * sizeof(SortItem));
+	MergeItems(ppScratch, half, ppScratch + half, count - half, ppItems);
+}
+
+static void SliceTaskProc(void *pArg)
+{
+	SliceTask *pTask = (SliceTask*)pArg;
+
+	StableSort(pTask->ppItems, pTask->ppScratch, pTask->count);
+}
+
+int CompareSortableVersions(const SortableVersion *pVersion1, const SortableVersion *pVersion2)
+{
+	assert(NULL != pVersion1);
+	assert(NULL != pVersion2);
+
+	bool isSemVer1 = (eSemVer_2_0_0 == pVersion1->record.versionType);
+	bool isSemVer2 = (eSemVer_2_0_0 == pVersion2->record.versionType);
+
+	if (isSemVer1 && isSemVer2) return CompareVersions(pVersion1->pVersion, &pVersion1->record, pVersion2->pVersion, &pVersion2->record);
+	if (isSemVer1 != isSemVer2) return isSemVer1 ? -1 : 1;
+
+	return 0;
+}
+
+uint64_t GetPrecedenceKey(const char *pVersion, const VersionParseRecord *pParsed)
+{
+	assert(NULL != pVersion);
+	assert(NULL != pParsed);
+
+	if (eSemVer_2_0_0 != pParsed->versionType) return PRECEDENCE_KEY_NOT_SEMVER;
+
+	uint64_t fields[4] =
+	{
+		FieldKey(pVersion, 0, pParsed->majorDigits),
+		FieldKey(pVersion, pParsed->minorIdx, pParsed->minorDigits),
+		FieldKey(pVersion, pParsed->patchIdx, pParsed->patchDigits),
+		pParsed->hasPrereleaseTag ? 0 : 1
+	};
+
+	// Once a field saturates, everything below it must too, or two versions
+	// with huge majors could be ordered by their minors.
+	for (size_t idx = 0; idx < 3; idx++)
+	{
+		if (KEY_FIELD_MAX == fields[idx])
+		{
+			for (size_t below = idx + 1; below < 3; below++) fields[below] = KEY_FIELD_MAX;
+
+			fields[3] = 1;
+			break;
+		}
+	}
+
+	return (fields[0] << ((2 * KEY_FIELD_BITS) + 1)) | (fields[1] << (KEY_FIELD_BITS + 1)) | (fields[2] << 1) | fields[3];
+}
+
+bool SortVersions(SortableVersion *pVersions, size_t count, size_t threadCount)
+{
+	assert((NULL != pVersions) || (0 == count));
+
+	if (count < 2) return true;
+
+	if (0 == threadCount) threadCount = GetSemVerProcessorCount();
+	if (threadCount > count / MIN_VERSIONS_PER_THREAD) threadCount = count / MIN_VERSIONS_PER_THREAD;
+	if (0 == threadCount) threadCount = 1;
+
+	SortItem *ppItems = malloc(count * sizeof(SortItem));
+	SortItem *ppScratch = malloc(count * sizeof(SortItem));
+
+	// Each slice boundary, then a task per slice, then up to two merge tasks
+	// per thread for each merge round, and a worker per thread.
+	size_t *pBounds = malloc((threadCount + 1) * sizeof(size_t));
+	SliceTask *pSlices = malloc(threadCount * sizeof(SliceTask));
+	MergeTask *pMerges = malloc(2 * threadCount * sizeof(MergeTask));
+	MergeWorker *pWorkers = malloc(threadCount * sizeof(MergeWorker));
+
+	bool succeeded = (NULL != ppItems) && (NULL != ppScratch) && (NULL != pBounds) && (NULL != pSlices) && (NULL != pMerges) && (NULL != pWorkers);
+
+	if (succeeded)
+	{
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			ppItems[idx] = &pVersions[idx];
+		}
+
+		// Phase one, every thread sorts a slice of its own.
+		for (size_t idx = 0; idx <= threadCount; idx++)
+		{
+			pBounds[idx] = (count * idx) / threadCount;
+		}
+
+		for (size_t idx = 0; idx < threadCount; idx++)
+		{
+			pSlices[idx].ppItems = ppItems + pBounds[idx];
+			pSlices[idx].ppScratch = ppScratch + pBounds[idx];
+			pSlices[idx].count = pBounds[idx + 1] - pBounds[idx];
+		}
+
+		RunSemVerThreads(SliceTaskProc, pSlices, sizeof(SliceTask), threadCount);
+
+		// Phase two, merge neighbouring runs until there's only one.  Each 
+		// round halves the number of runs, and bounces the items between the
+		// two arrays.  Every merge is cut into pieces, in proportion to its
+		// size, so all the threads stay busy right up to the last merge.
+		SortItem *ppFrom = ppItems;
+		SortItem *ppTo = ppScratch;
+		size_t runCount = threadCount;
+
+		while (runCount > 1)
+		{
+			size_t taskCount = 0;
+
+			for (size_t run = 0; run < runCount; run += 2)
+			{
+				size_t start = pBounds[run];
+				size_t middle = pBounds[run + 1];
+				size_t end = (run + 2 <= runCount) ? pBounds[run + 2] : middle;
+				size_t length = end - start;
+				size_t pieces = ((length * threadCount) + count - 1) / count;
+
+				if (0 == pieces) pieces = 1;
+
+				for (size_t piece = 0; piece < pieces; piece++)
+				{
+					MergeTask *pTask = &pMerges[taskCount++];
+
+					pTask->ppA = ppFrom + start;
+					pTask->countA = middle - start;
+					pTask->ppB = ppFrom + middle;
+					pTask->countB = end - middle;
+					pTask->first = (length * piece) / pieces;
+					pTask->last = (length * (piece + 1)) / pieces;
+					pTask->ppOut = ppTo + start;
+				}
+
+				// The merged run replaces the pair.
+				pBounds[run / 2] = start;
+			}
+
+			pBounds[(runCount + 1) / 2] = count;
+			runCount = (runCount + 1) / 2;
+
+			for (size_t idx = 0; idx < threadCount; idx++)
+			{
+				pWorkers[idx].pTasks = pMerges;
+				pWorkers[idx].taskCount = taskCount;
+				pWorkers[idx].firstTask = idx;
+				pWorkers[idx].step = threadCount;
+			}
+
+			RunSemVerThreads(MergeWorkerProc, pWorkers, sizeof(MergeWorker), (taskCount < threadCount) ? taskCount : threadCount);
+
+			SortItem *ppSwap = ppFrom;
+			ppFrom = ppTo;
+			ppTo = ppSwap;
+		}
+
+		Permute(pVersions, ppFrom, count);
+	}
+
+	free(ppItems);
+	free(ppScratch);
+	free(pBounds);
+	free(pSlices);
+	free(pMerges);
+	free(pWorkers);
+
+	return succeeded;
+}
+
+bool TopVersions(const SortableVersion *pVersions, size_t count, size_t k, const SortableVersion **ppTop, size_t *pFound)
+{
+	assert((NULL != pVersions) || (0 == count));
+	assert((NULL != ppTop) || (0 == k));
+	assert(NULL != pFound);
+
+	*pFound = 0;
+
+	if (0 == k) return true;
+
+	KeyedItem *pHeap = malloc(((k < count) ? k : count) * sizeof(KeyedItem));
+
+	if ((NULL == pHeap) && (0 != count)) return false;
+
+	// A min-heap of the best so far, so the one to beat is always on top.
+	size_t heapCount = 0;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		if (eSemVer_2_0_0 != pVersions[idx].record.versionType) continue;
+
+		KeyedItem candidate = { GetPrecedenceKey(pVersions[idx].pVersion, &pVersions[idx].record), &pVersions[idx] };
+
+		if (heapCount < k)
+		{
+			// Sift up.
+			size_t hole = heapCount++;
+
+			while ((0 != hole) && (CompareKeyed(&candidate, &pHeap[(hole - 1) / 2]) < 0))
+			{
+				pHeap[hole] = pHeap[(hole - 1) / 2];
+				hole = (hole - 1) / 2;
+			}
+
+			pHeap[hole] = candidate;
+		}
+		else if (CompareKeyed(&candidate, &pHeap[0]) > 0)
+		{
+			pHeap[0] = candidate;
+			SiftDownKeyed(pHeap, heapCount, 0);
+		}
+	}
+
+	*pFound = heapCount;
+
+	// Popping the heap gives us the smallest first.
+	while (0 != heapCount)
+	{
+		ppTop[--heapCount] = pHeap[0].pItem;
+		pHeap[0] = pHeap[heapCount];
+		SiftDownKeyed(pHeap, heapCount, 0);
+	}
+
+	free(pHeap);
+
+	return true;
+}
+
+bool NthVersion(SortableVersion *pVersions, size_t count, size_t nth)
+{
+	assert((NULL != pVersions) || (0 == count));
+	assert((nth < count) || (0 == count));
+
+	if (count < 2) return true;
+
+	KeyedItem *pKeyed = malloc(count * sizeof(KeyedItem));
+	SortItem *ppItems = malloc(count * sizeof(SortItem));
+
+	if ((NULL == pKeyed) || (NULL == ppItems))
+	{
+		free(pKeyed);
+		free(ppItems);
+		return false;
+	}
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		pKeyed[idx].key = GetPrecedenceKey(pVersions[idx].pVersion, &pVersions[idx].record);
+		pKeyed[idx].pItem = &pVersions[idx];
+	}
+
+	SelectKeyed(pKeyed, count, nth);
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		ppItems[idx] = pKeyed[idx].pItem;
+	}
+
+	Permute(pVersions, ppItems, count);
+
+	free(pKeyed);
+	free(ppItems);
+
+	return true;
+}
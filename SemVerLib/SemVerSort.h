@@ -0,0 +1,90 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerSort_h_Defined
+#define _SharperHacks_SemVerSort_h_Defined
+
+#include <stdint.h>
+
+#include "SemVer.h"
+
+// The precedence key of every string that isn't SemVer.  It's above every
+// SemVer key.
+#define PRECEDENCE_KEY_NOT_SEMVER UINT64_MAX
+
+// A version string and its parse results, as sorted by SortVersions().
+typedef struct _SortableVersion
+{
+	const char *pVersion;
+	VersionParseRecord record;
+} SortableVersion;
+
+/// <summary>
+/// The order SortVersions() sorts into.  SemVer strings come first, ordered by
+/// CompareVersions(), and everything else compares equal, after them.
+/// </summary>
+/// <returns>-1, 0 or 1.</returns>
+extern int CompareSortableVersions(const SortableVersion *pVersion1, const SortableVersion *pVersion2);
+
+/// <summary>
+/// Packs major, minor, patch and whether it's a release into an integer, such
+/// that when two keys differ, they're in CompareVersions() order.  Ties need a
+/// CompareVersions() to break them.
+/// </summary>
+/// <remarks>
+/// Each field gets 20 bits.  A field that doesn't fit saturates, along with 
+/// everything below it, so keys only ever tie, and never lie.
+/// </remarks>
+/// <returns>PRECEDENCE_KEY_NOT_SEMVER, if pParsed isn't SemVer.</returns>
+extern uint64_t GetPrecedenceKey(const char *pVersion, const VersionParseRecord *pParsed);
+
+/// <summary>
+/// Stable sort, in CompareSortableVersions() order, on up to threadCount threads.
+/// </summary>
+/// <remarks>
+/// The result is exactly what a sequential stable sort would produce, whatever
+/// the thread count.  Each thread merge sorts its own slice, then the slices
+/// are merged pairwise, with every merge split across all of the threads.
+/// Only pointers are moved while sorting, each record is moved once at the end.
+/// Needs two pointers of scratch space per version.
+/// </remarks>
+/// <param name="threadCount">Zero to use every processor.</param>
+/// <returns>False if we ran out of memory, in which case pVersions is untouched.</returns>
+extern bool SortVersions(SortableVersion *pVersions, size_t count, size_t threadCount);
+
+/// <summary>
+/// Find the k greatest SemVer versions, without sorting.
+/// </summary>
+/// <remarks>
+/// Strings that aren't SemVer are skipped.  Of several equal versions, the
+/// first ones in pVersions win.  Most versions are turned away by a single 
+/// integer compare, see NthVersion().
+/// </remarks>
+/// <param name="ppTop">Receives pointers to k versions, greatest first.</param>
+/// <param name="pFound">Receives how many were found, less than k if there weren't k SemVer versions.</param>
+/// <returns>False if we ran out of memory.</returns>
+extern bool TopVersions(const SortableVersion *pVersions, size_t count, size_t k, const SortableVersion **ppTop, size_t *pFound);
+
+/// <summary>
+/// Partially sort pVersions, so that pVersions[nth] is the version a full 
+/// SortVersions() would put there, nothing before it is greater, and nothing
+/// after it is less.  Expected O(count).
+/// </summary>
+/// <remarks>
+/// Each version's triple is packed into an integer key once, up front, so 
+/// versions whose triples differ (the vast majority) are ordered by one 
+/// integer compare, and CompareVersions() is only called when the keys tie.
+/// Quickselect falls back to sorting what's left, if it isn't converging.
+/// Equal versions are not kept in order.
+/// </remarks>
+/// <returns>False if we ran out of memory, in which case pVersions is untouched.</returns>
+extern bool NthVersion(SortableVersion *pVersions, size_t count, size_t nth);
+
+#endif
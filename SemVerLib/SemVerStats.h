@@ -0,0 +1,97 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerStats_h_Defined
+#define _SharperHacks_SemVerStats_h_Defined
+
+#include <stdint.h>
+
+#include "SemVer.h"
+
+// Hot path counters for the classifier and comparator.  They're compiled in
+// only when SEMVER_STATS is defined for SemVer.c, otherwise every counter
+// expands to nothing and the functions below just report that.  The Debug
+// configurations of SemVerLib define it, so the unit tests check the counters
+// in Debug, and check that Release counts nothing.
+//
+// Counters are kept per thread, in thread local storage, so counting never
+// needs a lock or an atomic.  Each thread snapshots and resets its own, and
+// AddSemVerStats() can roll the snapshots up.
+
+// One counter for each ParseState.
+#define SEMVER_STATS_STATE_COUNT (eInLenientExtra + 1)
+
+// CompareFields() calls are counted by field length, with everything longer
+// than eight characters in the last bucket.
+#define SEMVER_STATS_FIELD_LENGTH_COUNT 10
+
+// How far CompareVersions() got before it could decide.
+typedef enum
+{
+	eDecidedNotSemVer = 0,		// Either string wasn't SemVer, so we returned -2.
+	eDecidedAtMajor,
+	eDecidedAtMinor,
+	eDecidedAtPatch,
+	eDecidedAtPrereleasePresence,	// Same triple, only one has a prerelease tag.
+	eDecidedAtPrereleaseFields,		// Includes versions that compared equal.
+	eCompareDecisionCount
+} CompareDecision;
+
+// Every member is a uint64_t, AddSemVerStats() depends on that.
+typedef struct _SemVerStats
+{
+	uint64_t classifications;
+
+	// The state we were in when we ran out of characters.
+	uint64_t completedInState[SEMVER_STATS_STATE_COUNT];
+
+	// The state we were in when we gave up early.  The eStart count includes
+	// empty and NULL candidates.
+	uint64_t rejectedInState[SEMVER_STATS_STATE_COUNT];
+
+	// Early rejections caused by a leading zero in the version triple.
+	// These are also counted in rejectedInState.
+	uint64_t leadingZeroRejections;
+
+	// Prerelease fields that reached the 0#... form, and so needed an alpha 
+	// character to pass, and how many of those never got one.
+	uint64_t needsAlphaToPass;
+	uint64_t needsAlphaRejections;
+
+	// Heap traffic.  Reallocations are tag arrays that outgrew their block.
+	uint64_t recordAllocations;
+	uint64_t tagAllocations;
+	uint64_t tagReallocations;
+	uint64_t bytesAllocated;
+
+	uint64_t compares;
+	uint64_t compareDecisions[eCompareDecisionCount];
+	uint64_t compareFieldLengths[SEMVER_STATS_FIELD_LENGTH_COUNT];
+} SemVerStats;
+
+/// <summary>
+/// Copy the calling thread's counters into pStats.
+/// </summary>
+/// <returns>
+/// False, and a zeroed pStats, if the library was built without SEMVER_STATS.
+/// </returns>
+extern bool GetSemVerStats(SemVerStats *pStats);
+
+/// <summary>
+/// Zero the calling thread's counters.
+/// </summary>
+extern void ResetSemVerStats(void);
+
+/// <summary>
+/// Add every counter in pStats to pTotal.
+/// </summary>
+extern void AddSemVerStats(SemVerStats *pTotal, const SemVerStats *pStats);
+
+#endif
@@ -0,0 +1,149 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include "SemVerThreads.h"
+
+#include <assert.h>
+
+#ifdef _WIN32
+ #include <process.h>
+#else
+ #include <unistd.h>
+#endif
+
+// Most runs need no more than this, so we don't need to allocate.
+#define INLINE_THREAD_COUNT 32
+
+#ifdef _WIN32
+
+static unsigned __stdcall ThreadStart(void *pArg)
+{
+	SemVerThread *pThread = (SemVerThread*)pArg;
+	pThread->proc(pThread->pArg);
+	return 0;
+}
+
+bool StartSemVerThread(SemVerThread *pThread, SemVerThreadProc proc, void *pArg)
+{
+	assert(NULL != pThread);
+	assert(NULL != proc);
+
+	pThread->proc = proc;
+	pThread->pArg = pArg;
+	pThread->handle = (HANDLE)_beginthreadex(NULL, 0, ThreadStart, pThread, 0, NULL);
+
+	return (NULL != pThread->handle);
+}
+
+void JoinSemVerThread(SemVerThread *pThread)
+{
+	assert(NULL != pThread);
+
+	WaitForSingleObject(pThread->handle, INFINITE);
+	CloseHandle(pThread->handle);
+}
+
+size_t GetSemVerProcessorCount(void)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+
+	return (0 != info.dwNumberOfProcessors) ? info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+static void* ThreadStart(void *pArg)
+{
+	SemVerThread *pThread = (SemVerThread*)pArg;
+	pThread->proc(pThread->pArg);
+	return NULL;
+}
+
+bool StartSemVerThread(SemVerThread *pThread, SemVerThreadProc proc, void *pArg)
+{
+	assert(NULL != pThread);
+	assert(NULL != proc);
+
+	pThread->proc = proc;
+	pThread->pArg = pArg;
+
+	return (0 == pthread_create(&pThread->thread, NULL, ThreadStart, pThread));
+}
+
+void JoinSemVerThread(SemVerThread *pThread)
+{
+	assert(NULL != pThread);
+
+	pthread_join(pThread->thread, NULL);
+}
+
+size_t GetSemVerProcessorCount(void)
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (count > 0) ? (size_t)count : 1;
+}
+
+#endif
+
+void RunSemVerThreads(SemVerThreadProc proc, void *pArgs, size_t argSize, size_t count)
+{
+	assert(NULL != proc);
+
+	SemVerThread inlineThreads[INLINE_THREAD_COUNT];
+	bool inlineStarted[INLINE_THREAD_COUNT];
+	SemVerThread *pThreads = inlineThreads;
+	bool *pStarted = inlineStarted;
+	char *pArg = (char*)pArgs;
+
+	if (count > INLINE_THREAD_COUNT)
+	{
+		pThreads = malloc(count * sizeof(SemVerThread));
+		pStarted = malloc(count * sizeof(bool));
+
+		if ((NULL == pThreads) || (NULL == pStarted))
+		{
+			free(pThreads);
+			free(pStarted);
+
+			for (size_t idx = 0; idx < count; idx++)
+			{
+				proc(pArg + (idx * argSize));
+			}
+
+			return;
+		}
+	}
+
+	for (size_t idx = 1; idx < count; idx++)
+	{
+		// Whatever can't go on a thread of its own runs on ours, below.
+		pStarted[idx] = StartSemVerThread(&pThreads[idx], proc, pArg + (idx * argSize));
+	}
+
+	if (0 != count) proc(pArg);
+
+	for (size_t idx = 1; idx < count; idx++)
+	{
+		if (pStarted[idx])
+		{
+			JoinSemVerThread(&pThreads[idx]);
+		}
+		else
+		{
+			proc(pArg + (idx * argSize));
+		}
+	}
+
+	if (pThreads != inlineThreads)
+	{
+		free(pThreads);
+		free(pStarted);
+	}
+}
@@ -0,0 +1,126 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerThreads_h_Defined
+#define _SharperHacks_SemVerThreads_h_Defined
+
+#include <stdlib.h>  // for size_t.
+#include <stdbool.h> // for bool.
+
+#ifdef _WIN32
+ #define WIN32_LEAN_AND_MEAN
+ #include <windows.h>
+#else
+ #include <pthread.h>
+#endif
+
+// Just enough threading for the library's parallel entry points, over Win32 
+// threads or pthreads.
+
+typedef void (*SemVerThreadProc)(void *pArg);
+
+// Must stay put until JoinSemVerThread() returns.
+typedef struct _SemVerThread
+{
+	SemVerThreadProc proc;
+	void *pArg;
+
+#ifdef _WIN32
+	HANDLE handle;
+#else
+	pthread_t thread;
+#endif
+} SemVerThread;
+
+/// <summary>
+/// Run proc(pArg) on a new thread.
+/// </summary>
+/// <returns>False if the thread couldn't be started.</returns>
+extern bool StartSemVerThread(SemVerThread *pThread, SemVerThreadProc proc, void *pArg);
+
+/// <summary>
+/// Wait for a thread started by StartSemVerThread() to finish.
+/// </summary>
+extern void JoinSemVerThread(SemVerThread *pThread);
+
+/// <summary>
+/// Run proc once for each of count elements of pArgs, each argSize bytes
+/// apart, on up to count threads.  The calling thread runs the first one.
+/// Falls back to running them on the calling thread, if threads can't be
+/// started.
+/// </summary>
+extern void RunSemVerThreads(SemVerThreadProc proc, void *pArgs, size_t argSize, size_t count);
+
+/// <summary>
+/// The number of processors we can run on, at least one.
+/// </summary>
+extern size_t GetSemVerProcessorCount(void);
+
+// Just enough atomics for the library's lock-free structures.  Loads acquire,
+// stores release, and compare-exchange is a full barrier.
+
+typedef volatile long SemVerAtomic;
+
+#ifdef _WIN32
+ // x86 and x64 loads and stores are already ordered, so only the compiler
+ // needs to be told.
+ #if defined(_M_IX86) || defined(_M_X64)
+  #define SemVerOrderingBarrier() _ReadWriteBarrier()
+ #else
+  #define SemVerOrderingBarrier() MemoryBarrier()
+ #endif
+
+static inline long LoadSemVerAtomic(const SemVerAtomic *pAtomic)
+{
+	long value = *pAtomic;
+	SemVerOrderingBarrier();
+	return value;
+}
+
+static inline void StoreSemVerAtomic(SemVerAtomic *pAtomic, long value)
+{
+	SemVerOrderingBarrier();
+	*pAtomic = value;
+}
+
+static inline bool CompareExchangeSemVerAtomic(SemVerAtomic *pAtomic, long expected, long desired)
+{
+	return expected == InterlockedCompareExchange(pAtomic, desired, expected);
+}
+
+// Keeps ordinary loads above it from moving below it.
+static inline void SemVerAcquireFence(void)
+{
+	SemVerOrderingBarrier();
+}
+#else
+static inline long LoadSemVerAtomic(const SemVerAtomic *pAtomic)
+{
+	return __atomic_load_n(pAtomic, __ATOMIC_ACQUIRE);
+}
+
+static inline void StoreSemVerAtomic(SemVerAtomic *pAtomic, long value)
+{
+	__atomic_store_n(pAtomic, value, __ATOMIC_RELEASE);
+}
+
+static inline bool CompareExchangeSemVerAtomic(SemVerAtomic *pAtomic, long expected, long desired)
+{
+	return __atomic_compare_exchange_n(pAtomic, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+// Keeps ordinary loads above it from moving below it.
+static inline void SemVerAcquireFence(void)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+#endif
+
+#endif
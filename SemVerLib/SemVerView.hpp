@@ -0,0 +1,152 @@
+﻿// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerView_hpp_Defined
+#define _SharperHacks_SemVerView_hpp_Defined
+
+// A C++20 range over the SemVer lines of a buffer, for parse-and-filter 
+// pipelines that would otherwise build a vector of strings, and another of 
+// parse records, at every stage:
+//
+//   for (ParsedVersion version : text | VersionLines | std::views::filter(IsRelease) | std::views::take(10))
+//
+// The view is a thin wrapper around a VersionLineReader, so lines are only
+// read as the pipeline asks for them, each into the same parse record.
+
+#if (defined(_MSVC_LANG) && (_MSVC_LANG < 202002L)) || (!defined(_MSVC_LANG) && (__cplusplus < 202002L))
+ #error SemVerView.hpp needs C++20.
+#endif
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+
+extern "C"
+{
+#include "SemVerScan.h"
+}
+
+namespace SharperHacks::SemVer
+{
+	// What the view yields.  The text refers into the buffer, but every
+	// ParsedVersion from a view shares the view's one record, so the record is
+	// only good until the iterator moves on.  Classify the text again if you
+	// need to keep a record, or compare two versions.
+	struct ParsedVersion
+	{
+		std::string_view text;
+		const VersionParseRecord *pRecord;
+	};
+
+	// An input range, like std::ranges::istream_view, because each line is 
+	// parsed into the view's one record.  Iterate it once.
+	class VersionLineView : public std::ranges::view_interface<VersionLineView>
+	{
+	public:
+		class Iterator
+		{
+		public:
+			using difference_type = std::ptrdiff_t;
+			using value_type = ParsedVersion;
+			using iterator_concept = std::input_iterator_tag;
+
+			Iterator() = default;
+			explicit Iterator(VersionLineView *pView) : _pView(pView) {}
+
+			ParsedVersion operator*() const { return _pView->Current(); }
+			Iterator& operator++() { _pView->Next(); return *this; }
+			void operator++(int) { _pView->Next(); }
+
+			bool operator==(std::default_sentinel_t) const { return !_pView->_hasLine; }
+
+		private:
+			VersionLineView *_pView = nullptr;
+		};
+
+		VersionLineView() { InitVersionLineReader(&_reader, nullptr, 0, nullptr); }
+
+		/// <param name="text">Must outlive the view.</param>
+		/// <param name="pFilter">Optional. Only versions in this set are yielded. Must outlive the view.</param>
+		explicit VersionLineView(std::string_view text, const VersionRangeSet *pFilter = nullptr)
+		{
+			InitVersionLineReader(&_reader, text.data(), text.size(), pFilter);
+		}
+
+		VersionLineView(VersionLineView &&other) noexcept { Take(other); }
+
+		VersionLineView& operator=(VersionLineView &&other) noexcept
+		{
+			if (this != &other)
+			{
+				FreeVersionLineReader(&_reader);
+				Take(other);
+			}
+
+			return *this;
+		}
+
+		~VersionLineView() { FreeVersionLineReader(&_reader); }
+
+		Iterator begin()
+		{
+			if (!_started)
+			{
+				_started = true;
+				Next();
+			}
+
+			return Iterator(this);
+		}
+
+		std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+	private:
+		VersionLineReader _reader;
+		bool _started = false;
+		bool _hasLine = false;
+
+		ParsedVersion Current() const
+		{
+			return { std::string_view(_reader.pBuffer + _reader.lineOffset, _reader.lineLength), &_reader.record };
+		}
+
+		void Next() { _hasLine = ReadVersionLine(&_reader); }
+
+		// The record's tag arrays move with it, and other is left empty.
+		void Take(VersionLineView &other) noexcept
+		{
+			_reader = other._reader;
+			_started = other._started;
+			_hasLine = other._hasLine;
+			InitVersionLineReader(&other._reader, nullptr, 0, nullptr);
+			other._started = true;
+			other._hasLine = false;
+		}
+	};
+
+	// Makes a VersionLineView, as a function or at the head of a pipeline.
+	struct VersionLinesAdaptor
+	{
+		VersionLineView operator()(std::string_view text, const VersionRangeSet *pFilter = nullptr) const
+		{
+			return VersionLineView(text, pFilter);
+		}
+
+		friend VersionLineView operator|(std::string_view text, const VersionLinesAdaptor&)
+		{
+			return VersionLineView(text);
+		}
+	};
+
+	inline constexpr VersionLinesAdaptor VersionLines;
+}
+
+#endif
@@ -0,0 +1,223 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerBatch.h"
+#include "SemVerLibUT.h"
+
+#define ROW_COUNT 5
+
+static const char *_batchCandidates[ROW_COUNT] =
+{
+	"1.2.3",
+	"10.20.30-rc.1.x+build.5",
+	"1.0.0-1.a+b.c.d",
+	"1.2",
+	"alpha",
+};
+
+// Expected fields, split out as strings.  NULL for rows that aren't SemVer.
+static const char *_batchExpected[ROW_COUNT][5] =
+{
+	{ "1", "2", "3", "", "" },
+	{ "10", "20", "30", "rc.1.x", "build.5" },
+	{ "1", "0", "0", "1.a", "b.c.d" },
+	{ NULL },
+	{ NULL },
+};
+
+// Rows and targets for CompareVersionColumn(), including prerelease ties,
+// fields too big for the value columns, and rows that aren't SemVer.
+static const char *_columnVersions[] =
+{
+	"1.2.3",
+	"1.2.3-alpha",
+	"1.2.3-alpha.1",
+	"1.2.3-beta",
+	"1.2.3+build.7",
+	"1.2.4",
+	"1.3.0-0",
+	"0.9.99",
+	"2.0.0",
+	"2147483646.0.0",
+	"2147483647.0.0",
+	"99999999999.0.0",
+	"1.99999999999.0-rc",
+	"4294967295.1.1",
+	"1.2",
+	"01.2.3",
+	"",
+};
+
+#define COLUMN_VERSION_COUNT (sizeof(_columnVersions) / sizeof(_columnVersions[0]))
+
+// Not a multiple of four, or of 64, so both tails get exercised.
+#define COLUMN_ROW_COUNT 203
+
+static bool MatchesField(const char *pCandidate, uint32_t idx, uint32_t length, const char *pExpected)
+{
+	return (strlen(pExpected) == length) && (0 == strncmp(pCandidate + idx, pExpected, length));
+}
+
+// CompareVersionColumn() and SelectVersionColumn() against CompareVersions(),
+// for every row and every target.
+static size_t RunColumnCompareTests(void)
+{
+	const char *ppRows[COLUMN_ROW_COUNT];
+	VersionParseRecord records[COLUMN_ROW_COUNT];
+	uint8_t versionTypes[COLUMN_ROW_COUNT];
+	uint32_t prereleaseLength[COLUMN_ROW_COUNT];
+	uint32_t majorValue[COLUMN_ROW_COUNT];
+	uint32_t minorValue[COLUMN_ROW_COUNT];
+	uint32_t patchValue[COLUMN_ROW_COUNT];
+	int8_t results[COLUMN_ROW_COUNT];
+	uint64_t bitmap[(COLUMN_ROW_COUNT + 63) / 64];
+	size_t failCount = 0;
+
+	VersionColumns columns =
+	{
+		versionTypes, NULL, NULL, NULL, NULL, NULL,
+		NULL, prereleaseLength, NULL, NULL, NULL, NULL,
+		majorValue, minorValue, patchValue
+	};
+
+	for (size_t row = 0; row < COLUMN_ROW_COUNT; row++)
+	{
+		ppRows[row] = _columnVersions[(row * 7) % COLUMN_VERSION_COUNT];
+		ClassifyVersionCandidate(ppRows[row], &records[row]);
+	}
+
+	ClassifyVersionBatch(ppRows, NULL, COLUMN_ROW_COUNT, &columns);
+
+	for (size_t target = 0; target < COLUMN_VERSION_COUNT; target++)
+	{
+		const char *pTarget = _columnVersions[target];
+		VersionParseRecord parsed;
+		size_t mismatches = 0;
+
+		ClassifyVersionCandidate(pTarget, &parsed);
+		CompareVersionColumn(pTarget, &parsed, ppRows, NULL, &columns, COLUMN_ROW_COUNT, results);
+
+		for (size_t row = 0; row < COLUMN_ROW_COUNT; row++)
+		{
+			if (results[row] != CompareVersions(ppRows[row], &records[row], pTarget, &parsed)) mismatches++;
+		}
+
+		for (int wanted = -2; wanted <= 1; wanted++)
+		{
+			size_t selected = SelectVersionColumn(pTarget, &parsed, ppRows, NULL, &columns, COLUMN_ROW_COUNT, wanted, bitmap);
+			size_t expected = 0;
+
+			for (size_t row = 0; row < COLUMN_ROW_COUNT; row++)
+			{
+				bool isSet = (0 != (bitmap[row / 64] & ((uint64_t)1 << (row % 64))));
+
+				if (isSet != (wanted == results[row])) mismatches++;
+				if (isSet) expected++;
+			}
+
+			if (selected != expected) mismatches++;
+		}
+
+		if (0 == mismatches)
+		{
+			printf("CompareVersionColumn() matched CompareVersions() for: \"%s\"\n", pTarget);
+		}
+		else
+		{
+			failCount++;
+			printf("CompareVersionColumn() had %zu mismatches for: \"%s\"\n", mismatches, pTarget);
+		}
+
+		FreeVersionParseData(&parsed);
+	}
+
+	for (size_t row = 0; row < COLUMN_ROW_COUNT; row++)
+	{
+		FreeVersionParseData(&records[row]);
+	}
+
+	return failCount;
+}
+
+size_t RunBatchTests(void)
+{
+	uint8_t versionTypes[ROW_COUNT];
+	uint32_t majorDigits[ROW_COUNT];
+	uint32_t minorIdx[ROW_COUNT];
+	uint32_t minorDigits[ROW_COUNT];
+	uint32_t patchIdx[ROW_COUNT];
+	uint32_t patchDigits[ROW_COUNT];
+	uint32_t prereleaseIdx[ROW_COUNT];
+	uint32_t prereleaseLength[ROW_COUNT];
+	uint32_t metaIdx[ROW_COUNT];
+	uint32_t metaLength[ROW_COUNT];
+
+	// Field counts and values are left NULL on purpose, to exercise NULL columns.
+	VersionColumns columns;
+
+	memset(&columns, 0, sizeof(columns));
+	columns.pVersionType = versionTypes;
+	columns.pMajorDigits = majorDigits;
+	columns.pMinorIdx = minorIdx;
+	columns.pMinorDigits = minorDigits;
+	columns.pPatchIdx = patchIdx;
+	columns.pPatchDigits = patchDigits;
+	columns.pPrereleaseIdx = prereleaseIdx;
+	columns.pPrereleaseLength = prereleaseLength;
+	columns.pMetaIdx = metaIdx;
+	columns.pMetaLength = metaLength;
+
+	size_t failCount = 0;
+	size_t semVerCount = ClassifyVersionBatch(_batchCandidates, NULL, ROW_COUNT, &columns);
+
+	if (3 != semVerCount)
+	{
+		failCount++;
+		printf("ClassifyVersionBatch() found %zu SemVer strings, expected 3.\n", semVerCount);
+	}
+
+	for (size_t row = 0; row < ROW_COUNT; row++)
+	{
+		const char *pCandidate = _batchCandidates[row];
+		const char **ppExpected = _batchExpected[row];
+		bool passed;
+
+		if (NULL == ppExpected[0])
+		{
+			passed = (eSemVer_2_0_0 != versionTypes[row]) && (0 == majorDigits[row]) && (0 == metaLength[row]);
+		}
+		else
+		{
+			passed = (eSemVer_2_0_0 == versionTypes[row])
+				&& MatchesField(pCandidate, 0, majorDigits[row], ppExpected[0])
+				&& MatchesField(pCandidate, minorIdx[row], minorDigits[row], ppExpected[1])
+				&& MatchesField(pCandidate, patchIdx[row], patchDigits[row], ppExpected[2])
+				&& MatchesField(pCandidate, prereleaseIdx[row], prereleaseLength[row], ppExpected[3])
+				&& MatchesField(pCandidate, metaIdx[row], metaLength[row], ppExpected[4]);
+		}
+
+		if (passed)
+		{
+			printf("ClassifyVersionBatch() split: %s\n", pCandidate);
+		}
+		else
+		{
+			failCount++;
+			printf("ClassifyVersionBatch() failed to split: %s\n", pCandidate);
+		}
+	}
+
+	failCount += RunColumnCompareTests();
+
+	return failCount;
+}
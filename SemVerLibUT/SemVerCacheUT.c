@@ -0,0 +1,220 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerCache.h"
+#include "..\SemVerLib\SemVerStats.h"
+#include "..\SemVerLib\SemVerThreads.h"
+#include "SemVerLibUT.h"
+
+#define CACHE_THREAD_COUNT 4
+#define CACHE_THREAD_LOOKUPS 20000
+
+static const char *_cacheVersions[] =
+{
+	"1.0.0",
+	"1.0.0-rc.1+build.5",
+	"not a version",
+	"",
+	"1.0.0-alpha.beta.1.2.3.4.5",
+	"1.0.0-a.b.c.d.e.f.g+h.i",				// One more tag field than an entry holds.
+	"10.20.30+meta.data",
+	"01.2.3",
+	"1.2",
+	"1.2.3-alpha.123456789012345678901234567890123456789012345678901234567890",	// Too long.
+};
+
+#define CACHE_VERSION_COUNT (sizeof(_cacheVersions) / sizeof(_cacheVersions[0]))
+
+// Each thread looks up versions in its own order, and counts wrong answers.
+typedef struct
+{
+	VersionParseCache *pCache;
+	const VersionParseRecord *pExpected;
+	char (*pVersions)[16];
+	size_t versionCount;
+	uint32_t seed;
+	size_t failCount;
+} CacheThreadTest;
+
+static bool SameTags(const ParsedTagRecord *pTags1, const ParsedTagRecord *pTags2, size_t count)
+{
+	return (0 == count) || (0 == memcmp(pTags1, pTags2, count * sizeof(ParsedTagRecord)));
+}
+
+static bool SameRecord(const VersionParseRecord *pExpected, const VersionParseRecord *pActual)
+{
+	return (pExpected->versionType == pActual->versionType)
+		&& (pExpected->majorDigits == pActual->majorDigits)
+		&& (pExpected->minorIdx == pActual->minorIdx)
+		&& (pExpected->minorDigits == pActual->minorDigits)
+		&& (pExpected->patchIdx == pActual->patchIdx)
+		&& (pExpected->patchDigits == pActual->patchDigits)
+		&& (pExpected->prereleaseChars == pActual->prereleaseChars)
+		&& (pExpected->prereleaseFieldCount == pActual->prereleaseFieldCount)
+		&& (pExpected->metaChars == pActual->metaChars)
+		&& (pExpected->metaFieldCount == pActual->metaFieldCount)
+		&& (pExpected->hasPrereleaseTag == pActual->hasPrereleaseTag)
+		&& (pExpected->hasMetaTag == pActual->hasMetaTag)
+		&& (pExpected->state == pActual->state)
+		&& (pExpected->parsedIdx == pActual->parsedIdx)
+		&& SameTags(pExpected->pPrereleaseData, pActual->pPrereleaseData, pExpected->prereleaseFieldCount)
+		&& SameTags(pExpected->pMetaData, pActual->pMetaData, pExpected->metaFieldCount);
+}
+
+static uint64_t GetClassifications(void)
+{
+	SemVerStats stats;
+
+	GetSemVerStats(&stats);
+	return stats.classifications;
+}
+
+static void CacheThreadProc(void *pArg)
+{
+	CacheThreadTest *pTest = pArg;
+
+	for (size_t lookup = 0; lookup < CACHE_THREAD_LOOKUPS; lookup++)
+	{
+		size_t idx = NextTestRandom(&pTest->seed) % pTest->versionCount;
+		CachedVersion cached;
+		const char *pVersion = pTest->pVersions[idx];
+
+		if (!SameRecord(&pTest->pExpected[idx], ClassifyVersionCandidateCached(pTest->pCache, pVersion, strlen(pVersion), &cached)))
+		{
+			pTest->failCount++;
+		}
+
+		FreeCachedVersion(&cached);
+	}
+}
+
+// Lots of threads, and far more versions than entries, so lookups race
+// evictions all the time.
+static size_t RunCacheThreadTests(void)
+{
+	static char versions[500][16];
+	static VersionParseRecord expected[500];
+
+	size_t failCount = 0;
+	size_t versionCount = sizeof(versions) / sizeof(versions[0]);
+	VersionParseCache *pCache = CreateVersionParseCache(64);
+	CacheThreadTest tests[CACHE_THREAD_COUNT];
+
+	if (NULL == pCache)
+	{
+		printf("CreateVersionParseCache() ran out of memory.\n");
+		return 1;
+	}
+
+	for (size_t idx = 0; idx < versionCount; idx++)
+	{
+		snprintf(versions[idx], sizeof(versions[idx]), (0 == idx % 3) ? "%zu.%zu.%zu-rc.%zu" : "%zu.%zu.%zu", idx % 7, idx % 11, idx, idx % 5);
+		ClassifyVersionCandidate(versions[idx], &expected[idx]);
+	}
+
+	for (size_t idx = 0; idx < CACHE_THREAD_COUNT; idx++)
+	{
+		tests[idx].pCache = pCache;
+		tests[idx].pExpected = expected;
+		tests[idx].pVersions = versions;
+		tests[idx].versionCount = versionCount;
+		tests[idx].seed = (uint32_t)idx;
+		tests[idx].failCount = 0;
+	}
+
+	RunSemVerThreads(CacheThreadProc, tests, sizeof(CacheThreadTest), CACHE_THREAD_COUNT);
+
+	for (size_t idx = 0; idx < CACHE_THREAD_COUNT; idx++)
+	{
+		failCount += tests[idx].failCount;
+	}
+
+	if (0 != failCount) printf("ClassifyVersionCandidateCached() got %zu lookups wrong, on %d threads.\n", failCount, CACHE_THREAD_COUNT);
+
+	for (size_t idx = 0; idx < versionCount; idx++)
+	{
+		FreeVersionParseData(&expected[idx]);
+	}
+
+	FreeVersionParseCache(pCache);
+	return failCount;
+}
+
+size_t RunCacheTests(void)
+{
+	size_t failCount = 0;
+	VersionParseCache *pCache = CreateVersionParseCache(16);
+
+	if (NULL == pCache)
+	{
+		printf("CreateVersionParseCache() ran out of memory.\n");
+		return 1;
+	}
+
+	for (size_t idx = 0; idx < CACHE_VERSION_COUNT; idx++)
+	{
+		const char *pVersion = _cacheVersions[idx];
+		size_t length = strlen(pVersion);
+		VersionParseRecord expected;
+		CachedVersion uncached, miss, hit;
+
+		ClassifyVersionCandidateN(pVersion, length, &expected);
+		ClassifyVersionCandidateCached(NULL, pVersion, length, &uncached);
+		ClassifyVersionCandidateCached(pCache, pVersion, length, &miss);
+
+		uint64_t classifications = GetClassifications();
+
+		ClassifyVersionCandidateCached(pCache, pVersion, length, &hit);
+
+		bool cacheable = (length <= VERSION_CACHE_MAX_LENGTH) && (expected.prereleaseFieldCount + expected.metaFieldCount <= VERSION_CACHE_MAX_TAGS);
+
+		if (!SameRecord(&expected, &uncached.record) || !SameRecord(&expected, &miss.record) || !SameRecord(&expected, &hit.record))
+		{
+			printf("ClassifyVersionCandidateCached(\"%s\") doesn't match ClassifyVersionCandidateN().\n", pVersion);
+			failCount++;
+		}
+		else if (cacheable && (GetClassifications() != classifications))
+		{
+			printf("ClassifyVersionCandidateCached(\"%s\") missed the cache.\n", pVersion);
+			failCount++;
+		}
+		else if ((eSemVer_2_0_0 == expected.versionType) && (0 != CompareVersions(pVersion, &hit.record, pVersion, &expected)))
+		{
+			printf("ClassifyVersionCandidateCached(\"%s\") doesn't compare equal to itself.\n", pVersion);
+			failCount++;
+		}
+
+		FreeVersionParseData(&expected);
+		FreeCachedVersion(&uncached);
+		FreeCachedVersion(&miss);
+		FreeCachedVersion(&hit);
+	}
+
+	// A prefix of a cached string isn't the cached string.
+	CachedVersion prefix;
+
+	if (eSemVer_2_0_0 == ClassifyVersionCandidateCached(pCache, "10.20.30+meta.data", 4, &prefix)->versionType)
+	{
+		printf("ClassifyVersionCandidateCached() found a prefix in the cache.\n");
+		failCount++;
+	}
+
+	FreeCachedVersion(&prefix);
+	FreeVersionParseCache(pCache);
+
+	failCount += RunCacheThreadTests();
+
+	if (0 == failCount) printf("Parse cache tests passed.\n");
+
+	return failCount;
+}
@@ -0,0 +1,237 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerCatalog.h"
+#include "SemVerLibUT.h"
+
+static const char *_catalogFileName = "SemVerCatalogUT.bin";
+
+static const char *_catalogVersions[] =
+{
+	"1.0.0",
+	"1.0.0-rc.1+build.5",
+	"not a version",
+	"1.0.0-alpha.beta.1.2.3.4.5",
+	"",
+	"10.20.30+meta.data",
+	"1.0.0-alpha",
+	"0.0.1",
+	"1.2",
+};
+
+#define CATALOG_COUNT (sizeof(_catalogVersions) / sizeof(_catalogVersions[0]))
+
+static bool SameTags(const ParsedTagRecord *pTags1, const ParsedTagRecord *pTags2, size_t count)
+{
+	return (0 == count) || (0 == memcmp(pTags1, pTags2, count * sizeof(ParsedTagRecord)));
+}
+
+static bool SameRecord(const VersionParseRecord *pExpected, const VersionParseRecord *pActual)
+{
+	return (pExpected->versionType == pActual->versionType)
+		&& (pExpected->majorDigits == pActual->majorDigits)
+		&& (pExpected->minorIdx == pActual->minorIdx)
+		&& (pExpected->minorDigits == pActual->minorDigits)
+		&& (pExpected->patchIdx == pActual->patchIdx)
+		&& (pExpected->patchDigits == pActual->patchDigits)
+		&& (pExpected->prereleaseChars == pActual->prereleaseChars)
+		&& (pExpected->prereleaseFieldCount == pActual->prereleaseFieldCount)
+		&& (pExpected->metaChars == pActual->metaChars)
+		&& (pExpected->metaFieldCount == pActual->metaFieldCount)
+		&& (pExpected->hasPrereleaseTag == pActual->hasPrereleaseTag)
+		&& (pExpected->hasMetaTag == pActual->hasMetaTag)
+		&& (pExpected->state == pActual->state)
+		&& (pExpected->parsedIdx == pActual->parsedIdx)
+		&& SameTags(pExpected->pPrereleaseData, pActual->pPrereleaseData, pExpected->prereleaseFieldCount)
+		&& SameTags(pExpected->pMetaData, pActual->pMetaData, pExpected->metaFieldCount);
+}
+
+// Overwrite count bytes of the catalog file, at offset from origin.
+static bool DamageCatalog(long offset, int origin, size_t count)
+{
+	FILE *pFile = NULL;
+
+#ifdef _MSC_VER
+	if (0 != fopen_s(&pFile, _catalogFileName, "r+b")) pFile = NULL;
+#else
+	pFile = fopen(_catalogFileName, "r+b");
+#endif
+
+	if (NULL == pFile) return false;
+
+	bool ok = (0 == fseek(pFile, offset, origin));
+
+	for (size_t idx = 0; ok && (idx < count); idx++)
+	{
+		ok = (EOF != fputc('X', pFile));
+	}
+
+	return (0 == fclose(pFile)) && ok;
+}
+
+static size_t RunCatalogRoundTrip(void)
+{
+	VersionCatalog catalog;
+	size_t failCount = 0;
+
+	CatalogStatus status = OpenVersionCatalog(_catalogFileName, true, &catalog);
+
+	if (eCatalogOk != status)
+	{
+		printf("OpenVersionCatalog() failed: %d\n", (int)status);
+		return 1;
+	}
+
+	if (CATALOG_COUNT != catalog.entryCount)
+	{
+		failCount++;
+		printf("Catalog has %zu entries, expected %zu.\n", catalog.entryCount, CATALOG_COUNT);
+	}
+
+	for (size_t idx = 0; (idx < CATALOG_COUNT) && (idx < catalog.entryCount); idx++)
+	{
+		VersionParseRecord expected;
+		VersionParseRecord mapped;
+
+		ClassifyVersionCandidate(_catalogVersions[idx], &expected);
+
+		const char *pMapped = GetCatalogVersion(&catalog, idx, &mapped);
+
+		if ((0 == strcmp(pMapped, _catalogVersions[idx])) && SameRecord(&expected, &mapped))
+		{
+			printf("Catalog round trip: %s\n", _catalogVersions[idx]);
+		}
+		else
+		{
+			failCount++;
+			printf("Catalog round trip failed: %s\n", _catalogVersions[idx]);
+		}
+
+		FreeVersionParseData(&expected);
+	}
+
+	// Comparisons straight from the mapping must agree with the originals.
+	for (size_t idx1 = 0; (idx1 < CATALOG_COUNT) && (idx1 < catalog.entryCount); idx1++)
+	{
+		for (size_t idx2 = 0; (idx2 < CATALOG_COUNT) && (idx2 < catalog.entryCount); idx2++)
+		{
+			VersionParseRecord record1;
+			VersionParseRecord record2;
+
+			ClassifyVersionCandidate(_catalogVersions[idx1], &record1);
+			ClassifyVersionCandidate(_catalogVersions[idx2], &record2);
+
+			int expected = CompareVersions(_catalogVersions[idx1], &record1, _catalogVersions[idx2], &record2);
+			int actual = CompareCatalogVersions(&catalog, idx1, idx2);
+
+			if (expected != actual)
+			{
+				failCount++;
+				printf("CompareCatalogVersions(%s, %s) returned %d, expected %d\n", _catalogVersions[idx1], _catalogVersions[idx2], actual, expected);
+			}
+
+			FreeVersionParseData(&record1);
+			FreeVersionParseData(&record2);
+		}
+	}
+
+	CloseVersionCatalog(&catalog);
+
+	return failCount;
+}
+
+size_t RunCatalogTests(void)
+{
+	size_t failCount = 0;
+	VersionCatalogWriter *pWriter = CreateVersionCatalogWriter();
+
+	if (NULL == pWriter)
+	{
+		printf("CreateVersionCatalogWriter() failed.\n");
+		return 1;
+	}
+
+	for (size_t idx = 0; idx < CATALOG_COUNT; idx++)
+	{
+		if (!AppendVersionCatalogEntry(pWriter, _catalogVersions[idx], strlen(_catalogVersions[idx])))
+		{
+			failCount++;
+			printf("AppendVersionCatalogEntry() failed: %s\n", _catalogVersions[idx]);
+		}
+	}
+
+	CatalogStatus status = SaveVersionCatalog(pWriter, _catalogFileName);
+	FreeVersionCatalogWriter(pWriter);
+
+	if (eCatalogOk != status)
+	{
+		printf("SaveVersionCatalog() failed: %d\n", (int)status);
+		return failCount + 1;
+	}
+
+	failCount += RunCatalogRoundTrip();
+
+	// A damaged string section still has a sane header, so only the checksum can catch it.
+	VersionCatalog catalog;
+
+	if (!DamageCatalog(-2, SEEK_END, 1) || (eCatalogBadChecksum != OpenVersionCatalog(_catalogFileName, true, &catalog)))
+	{
+		failCount++;
+		printf("OpenVersionCatalog() accepted a damaged catalog.\n");
+	}
+
+	// Without the checksum, the first entry's string offset can point anywhere.
+	// That entry is refused, and the rest are still readable.
+	long entryOffset = -1;
+
+	if (eCatalogOk == OpenVersionCatalog(_catalogFileName, false, &catalog))
+	{
+		entryOffset = (long)(catalog.pHeader->entriesOffset + offsetof(VersionCatalogEntry, stringOffset));
+		CloseVersionCatalog(&catalog);
+	}
+
+	if ((entryOffset < 0) || !DamageCatalog(entryOffset, SEEK_SET, sizeof(uint64_t))
+		|| (eCatalogOk != OpenVersionCatalog(_catalogFileName, false, &catalog)))
+	{
+		failCount++;
+		printf("Couldn't damage a catalog entry.\n");
+	}
+	else
+	{
+		VersionParseRecord record;
+
+		if ((NULL != GetCatalogVersion(&catalog, 0, &record)) || (-2 != CompareCatalogVersions(&catalog, 0, 0))
+			|| (NULL == GetCatalogVersion(&catalog, 1, &record)))
+		{
+			failCount++;
+			printf("GetCatalogVersion() accepted an entry outside of the catalog.\n");
+		}
+		else
+		{
+			printf("GetCatalogVersion() refused an entry outside of the catalog.\n");
+		}
+
+		CloseVersionCatalog(&catalog);
+	}
+
+	if (eCatalogIoError != OpenVersionCatalog("NoSuchCatalog.bin", false, &catalog))
+	{
+		failCount++;
+		printf("OpenVersionCatalog() opened a missing file.\n");
+	}
+
+	remove(_catalogFileName);
+
+	return failCount;
+}
@@ -0,0 +1,237 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerIndex.h"
+#include "SemVerLibUT.h"
+
+#define INDEX_TEST_SETS 300
+#define INDEX_TEST_QUERIES 4000
+#define INDEX_TEST_LENGTH 32
+
+static const char *_indexTags[] = { "", "", "-alpha", "-rc.1", "-0", "+build", "-beta+build" };
+
+// Set 0 holds every version, and set 1 none, besides the random ones.
+#define INDEX_ALL_SET 0
+#define INDEX_EMPTY_SET 1
+
+static void MakeIndexVersion(uint32_t *pSeed, char *pBuffer)
+{
+	MakeTestVersion(pSeed, 4, _indexTags, sizeof(_indexTags) / sizeof(_indexTags[0]), pBuffer, INDEX_TEST_LENGTH);
+}
+
+static int CompareIds(const void *p1, const void *p2)
+{
+	uint32_t id1 = *(const uint32_t*)p1;
+	uint32_t id2 = *(const uint32_t*)p2;
+
+	return (id1 < id2) ? -1 : (id1 > id2) ? 1 : 0;
+}
+
+// Sorts pIds, and checks them against asking every set in turn.
+static bool IdsMatch(const VersionRangeSet *pSets, const SortableVersion *pQuery, uint32_t *pIds, size_t count)
+{
+	qsort(pIds, count, sizeof(uint32_t), CompareIds);
+
+	size_t found = 0;
+
+	for (uint32_t idx = 0; idx < INDEX_TEST_SETS; idx++)
+	{
+		if (!VersionRangeContains(&pSets[idx], pQuery->pVersion, &pQuery->record)) continue;
+		if ((found >= count) || (pIds[found] != idx)) return false;
+
+		found++;
+	}
+
+	return found == count;
+}
+
+static size_t CheckBatch(const VersionRangeIndex *pIndex, const VersionRangeSet *pSets, const SortableVersion *pQueries, size_t threadCount)
+{
+	VersionRangeMatches matches;
+
+	if (!FindContainingRangesBatch(pIndex, pQueries, INDEX_TEST_QUERIES, threadCount, &matches))
+	{
+		printf("FindContainingRangesBatch() ran out of memory.\n");
+		return 1;
+	}
+
+	size_t idx = 0;
+
+	while ((idx < INDEX_TEST_QUERIES) && IdsMatch(pSets, &pQueries[idx], matches.pRangeIds + matches.pStarts[idx], matches.pStarts[idx + 1] - matches.pStarts[idx])) idx++;
+
+	size_t failCount = 0;
+
+	if (INDEX_TEST_QUERIES == idx)
+	{
+		printf("FindContainingRangesBatch() on %zu threads matched every set, %zu matches.\n", threadCount, matches.pStarts[INDEX_TEST_QUERIES]);
+	}
+	else
+	{
+		failCount++;
+		printf("FindContainingRangesBatch() on %zu threads is wrong for %s.\n", threadCount, pQueries[idx].pVersion);
+	}
+
+	FreeVersionRangeMatches(&matches);
+
+	return failCount;
+}
+
+size_t RunIndexTests(void)
+{
+	static const size_t threadCounts[] = { 1, 3, 0 };
+
+	size_t failCount = 0;
+	VersionRangeSet *pSets = malloc(INDEX_TEST_SETS * sizeof(VersionRangeSet));
+	SortableVersion *pQueries = malloc(INDEX_TEST_QUERIES * sizeof(SortableVersion));
+	char (*pBuffer)[INDEX_TEST_LENGTH] = malloc(INDEX_TEST_QUERIES * INDEX_TEST_LENGTH);
+	uint32_t ids[INDEX_TEST_SETS];
+	VersionRangeIndex index;
+
+	if ((NULL == pSets) || (NULL == pQueries) || (NULL == pBuffer))
+	{
+		printf("Index tests are out of memory.\n");
+		free(pSets);
+		free(pQueries);
+		free(pBuffer);
+		return 1;
+	}
+
+	InitVersionRangeIndex(&index);
+
+	// Nothing is in an index that hasn't been built.
+	ClassifyVersionCandidate("1.0.0", &pQueries[0].record);
+
+	if ((0 != FindContainingRanges(&index, "1.0.0", &pQueries[0].record, NULL, 0)) || !BuildVersionRangeIndex(&index, NULL, 0)
+		|| (0 != FindContainingRanges(&index, "1.0.0", &pQueries[0].record, NULL, 0)))
+	{
+		failCount++;
+		printf("An empty index found a version.\n");
+	}
+
+	FreeVersionParseData(&pQueries[0].record);
+
+	// Random sets of up to three intervals each, some of them unbounded, over
+	// a small pool of versions, so that plenty of bounds are shared.
+	uint32_t seed = 2468;
+
+	for (size_t idx = 0; idx < INDEX_TEST_SETS; idx++)
+	{
+		InitVersionRangeSet(&pSets[idx]);
+
+		size_t intervalCount = (INDEX_ALL_SET == idx) ? 1 : (INDEX_EMPTY_SET == idx) ? 0 : NextTestRandom(&seed) % 4;
+
+		for (size_t interval = 0; interval < intervalCount; interval++)
+		{
+			char lower[INDEX_TEST_LENGTH];
+			char upper[INDEX_TEST_LENGTH];
+			uint32_t bits = NextTestRandom(&seed);
+
+			MakeIndexVersion(&seed, lower);
+			MakeIndexVersion(&seed, upper);
+
+			bool hasLower = (INDEX_ALL_SET != idx) && (0 != (bits % 7));
+			bool hasUpper = (INDEX_ALL_SET != idx) && (0 != ((bits >> 3) % 7));
+
+			if (!AddVersionInterval(&pSets[idx], hasLower ? lower : NULL, 0 != (bits & 0x100), hasUpper ? upper : NULL, 0 != (bits & 0x200)))
+			{
+				failCount++;
+				printf("AddVersionInterval() failed for %s, %s.\n", lower, upper);
+			}
+		}
+	}
+
+	if (!BuildVersionRangeIndex(&index, pSets, INDEX_TEST_SETS))
+	{
+		printf("BuildVersionRangeIndex() failed.\n");
+		failCount++;
+	}
+	else
+	{
+		// Random versions, every bound, and a few that aren't SemVer.
+		size_t queryCount = 0;
+
+		for (size_t idx = 0; (idx < INDEX_TEST_SETS) && (queryCount + 2 <= INDEX_TEST_QUERIES); idx++)
+		{
+			for (size_t interval = 0; (interval < pSets[idx].count) && (queryCount + 2 <= INDEX_TEST_QUERIES); interval++)
+			{
+				const VersionInterval *pInterval = &pSets[idx].pIntervals[interval];
+
+				if (NULL != pInterval->lower.pVersion) snprintf(pBuffer[queryCount++], INDEX_TEST_LENGTH, "%s", pInterval->lower.pVersion);
+				if (NULL != pInterval->upper.pVersion) snprintf(pBuffer[queryCount++], INDEX_TEST_LENGTH, "%s", pInterval->upper.pVersion);
+			}
+		}
+
+		for (size_t idx = queryCount; idx < INDEX_TEST_QUERIES; idx++)
+		{
+			if (0 == (idx % 97))
+			{
+				snprintf(pBuffer[idx], INDEX_TEST_LENGTH, "not.a.version");
+			}
+			else
+			{
+				MakeIndexVersion(&seed, pBuffer[idx]);
+			}
+		}
+
+		for (size_t idx = 0; idx < INDEX_TEST_QUERIES; idx++)
+		{
+			pQueries[idx].pVersion = pBuffer[idx];
+			ClassifyVersionCandidate(pBuffer[idx], &pQueries[idx].record);
+		}
+
+		size_t idx = 0;
+
+		for (; idx < INDEX_TEST_QUERIES; idx++)
+		{
+			size_t count = FindContainingRanges(&index, pQueries[idx].pVersion, &pQueries[idx].record, ids, INDEX_TEST_SETS);
+
+			if ((count > INDEX_TEST_SETS) || !IdsMatch(pSets, &pQueries[idx], ids, count)) break;
+
+			// Asking for fewer ids still counts them all.
+			if ((0 != count) && (count != FindContainingRanges(&index, pQueries[idx].pVersion, &pQueries[idx].record, ids, 1))) break;
+		}
+
+		if (INDEX_TEST_QUERIES == idx)
+		{
+			printf("FindContainingRanges() matched every set for %d versions.\n", INDEX_TEST_QUERIES);
+		}
+		else
+		{
+			failCount++;
+			printf("FindContainingRanges() is wrong for %s.\n", pQueries[idx].pVersion);
+		}
+
+		for (size_t test = 0; test < sizeof(threadCounts) / sizeof(threadCounts[0]); test++)
+		{
+			failCount += CheckBatch(&index, pSets, pQueries, threadCounts[test]);
+		}
+
+		for (idx = 0; idx < INDEX_TEST_QUERIES; idx++)
+		{
+			FreeVersionParseData(&pQueries[idx].record);
+		}
+	}
+
+	for (size_t idx = 0; idx < INDEX_TEST_SETS; idx++)
+	{
+		FreeVersionRangeSet(&pSets[idx]);
+	}
+
+	FreeVersionRangeIndex(&index);
+	free(pSets);
+	free(pQueries);
+	free(pBuffer);
+
+	return failCount;
+}
@@ -8,14 +8,98 @@
 
 #include <memory.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "..\SemVerLib\SemVer.h"
+#include "SemVerLibUT.h"
 
 #define BUFSIZE 2048
 
+typedef struct
+{
+	const char *pCandidate;
+	const char *pCanonical;	// NULL if the canonical view must be rejected.
+	unsigned relaxations;
+} LenientCase;
+
+// In ascending order of precedence.  Build meta never affects precedence, so
+// neighbours that differ only in meta must compare equal.
+static const char *_precedenceOrder[] =
+{
+	"0.0.4",
+	"0.9.10",
+	"0.10.2",
+	"1.0.0-0.3.7",
+	"1.0.0-alpha",
+	"1.0.0-alpha+001",
+	"1.0.0-alpha.1",
+	"1.0.0-alpha.beta",
+	"1.0.0-beta",
+	"1.0.0-beta.2",
+	"1.0.0-beta.11",
+	"1.0.0-rc.1",
+	"1.0.0-rc.1.a.b.c.d.e.f",
+	"1.0.0-x.7.z.92",
+	"1.0.0-x-y-z.--",
+	"1.0.0",
+	"1.0.0+20130313144700",
+	"1.0.1",
+	"1.9.0",
+	"1.10.0",
+	"1.11.0",
+	"2.0.0",
+	"10.0.0-alphabetagammadelta.1",
+	"10.0.0-alphabetagammadelta.2",
+	"10.0.0",
+	"99999999999999999999999.999999999999999999.99999999999999999",
+};
+
+static const LenientCase _lenientCases[] =
+{
+	{ "1.2.3", "1.2.3", eRelaxedNone },
+	{ "1.100.3", "1.100.3", eRelaxedNone },
+	{ "1.0.0-alpha+beta", "1.0.0-alpha+beta", eRelaxedNone },
+	{ "v1.2.3", "1.2.3", eRelaxedPrefix },
+	{ "V1.2.3-beta+b1", "1.2.3-beta+b1", eRelaxedPrefix },
+	{ "1", "1.0.0", eRelaxedMissingComponent },
+	{ "1.2", "1.2.0", eRelaxedMissingComponent },
+	{ "1+meta", "1.0.0+meta", eRelaxedMissingComponent },
+	{ "v1.2-rc.1", "1.2.0-rc.1", eRelaxedPrefix | eRelaxedMissingComponent },
+	{ "1.2.3.4", "1.2.3", eRelaxedExtraComponent },
+	{ "1.2.3.04-beta", "1.2.3-beta", eRelaxedExtraComponent },
+	{ "01.2.3", "1.2.3", eRelaxedLeadingZero },
+	{ "1.02.003", "1.2.3", eRelaxedLeadingZero },
+	{ "00.0.00", "0.0.0", eRelaxedLeadingZero },
+	{ "v01.2", "1.2.0", eRelaxedPrefix | eRelaxedLeadingZero | eRelaxedMissingComponent },
+	{ "v", NULL, eRelaxedNone },
+	{ "vv1.2.3", NULL, eRelaxedNone },
+	{ "x1.2.3", NULL, eRelaxedNone },
+	{ "1.", NULL, eRelaxedNone },
+	{ "1.2.", NULL, eRelaxedNone },
+	{ "1.2.3.", NULL, eRelaxedNone },
+	{ "1.2.3.4.5", NULL, eRelaxedNone },
+	{ "1.2.3-01", NULL, eRelaxedNone },
+	{ "1..3", NULL, eRelaxedNone },
+};
+
+uint32_t NextTestRandom(uint32_t *pSeed)
+{
+	*pSeed = (*pSeed * 1664525) + 1013904223;
+	return *pSeed >> 8;
+}
+
+void MakeTestVersion(uint32_t *pSeed, uint32_t fieldLimit, const char * const *ppTags, size_t tagCount, char *pVersion, size_t size)
+{
+	uint32_t major = NextTestRandom(pSeed) % fieldLimit;
+	uint32_t minor = NextTestRandom(pSeed) % fieldLimit;
+	uint32_t patch = NextTestRandom(pSeed) % fieldLimit;
+
+	snprintf(pVersion, size, "%u.%u.%u%s", major, minor, patch, ppTags[NextTestRandom(pSeed) % tagCount]);
+}
+
 int ProcessFile(char *fileName)
 {
 	FILE* fp = NULL;
@@ -50,6 +134,12 @@ int ProcessFile(char *fileName)
 
 		VersionParseRecord *pvpr = ClassifyVersionCandidate(buf, NULL);
 
+		if (IsSemVer(buf, strlen(buf)) != (eSemVer_2_0_0 == pvpr->versionType))
+		{
+			failCount++;
+			printf("IsSemVer() disagrees with ClassifyVersionCandidate() for: %s\n", buf);
+		}
+
 		if (expectValid)
 		{
 			if (eSemVer_2_0_0 != pvpr->versionType)
@@ -77,15 +167,449 @@ int ProcessFile(char *fileName)
 
 	} while (!feof(fp));
 
-	return 0;
+	return (int)failCount;
+}
+
+size_t RunPrecedenceTests(void)
+{
+	size_t count = sizeof(_precedenceOrder) / sizeof(_precedenceOrder[0]);
+	size_t failCount = 0;
+
+	for (size_t idx = 0; idx + 1 < count; idx++)
+	{
+		const char *pLower = _precedenceOrder[idx];
+		const char *pHigher = _precedenceOrder[idx + 1];
+		VersionParseRecord lower;
+		VersionParseRecord higher;
+
+		ClassifyVersionCandidate(pLower, &lower);
+		ClassifyVersionCandidate(pHigher, &higher);
+
+		const char *pPlus = strchr(pHigher, '+');
+		bool metaOnly = (NULL != pPlus) && (0 == strncmp(pLower, pHigher, pPlus - pHigher)) && (strlen(pLower) == (size_t)(pPlus - pHigher));
+		int expected = metaOnly ? 0 : -1;
+
+		if ((expected == CompareVersions(pLower, &lower, pHigher, &higher))
+			&& (-expected == CompareVersions(pHigher, &higher, pLower, &lower))
+			&& (0 == CompareVersions(pLower, &lower, pLower, &lower)))
+		{
+			printf("Precedence passed: %s %s %s\n", pLower, metaOnly ? "==" : "<", pHigher);
+		}
+		else
+		{
+			failCount++;
+			printf("CompareVersions() failed for: %s %s %s\n", pLower, metaOnly ? "==" : "<", pHigher);
+		}
+
+		FreeVersionParseData(&lower);
+		FreeVersionParseData(&higher);
+	}
+
+	return failCount;
+}
+
+size_t RunLenientTests(void)
+{
+	size_t failCount = 0;
+
+	for (size_t idx = 0; idx < sizeof(_lenientCases) / sizeof(_lenientCases[0]); idx++)
+	{
+		const LenientCase *pCase = &_lenientCases[idx];
+		VersionParseRecord vpr;
+		LenientParseRecord lpr;
+		char buf[BUFSIZE];
+
+		ClassifyVersionCandidateLenient(pCase->pCandidate, &vpr, &lpr);
+		FormatCanonicalVersion(pCase->pCandidate, &lpr, buf, BUFSIZE);
+
+		bool passed;
+
+		if (NULL == pCase->pCanonical)
+		{
+			passed = (eSemVer_2_0_0 != lpr.versionType) && (eSemVer_2_0_0 != vpr.versionType);
+		}
+		else
+		{
+			passed = (eSemVer_2_0_0 == lpr.versionType)
+				&& (pCase->relaxations == lpr.relaxations)
+				&& (0 == strcmp(pCase->pCanonical, buf))
+				&& ((eSemVer_2_0_0 == vpr.versionType) == (eRelaxedNone == lpr.relaxations));
+		}
+
+		if (passed)
+		{
+			printf("Lenient parse passed: %s\n", pCase->pCandidate);
+		}
+		else
+		{
+			failCount++;
+			printf("ClassifyVersionCandidateLenient() failed for: %s (got '%s', relaxations 0x%x)\n", pCase->pCandidate, buf, lpr.relaxations);
+		}
+
+		free(vpr.pPrereleaseData);
+		free(vpr.pMetaData);
+	}
+
+	return failCount;
+}
+
+// IsSemVer() must agree with the classifier on every string, and at every
+// length.  Random strings over a small alphabet hit every state transition.
+// The alphabet includes a Latin-1 letter, which neither may take for a tag
+// character.
+size_t RunIsSemVerTests(void)
+{
+	static const char alphabet[] = "0019..--++aZ\xE9";
+	size_t failCount = 0;
+	uint32_t seed = 20201129;
+	char buf[16];
+
+	for (size_t test = 0; test < 200000; test++)
+	{
+		size_t length = NextTestRandom(&seed) % (sizeof(buf) - 1);
+
+		for (size_t idx = 0; idx < length; idx++)
+		{
+			buf[idx] = alphabet[NextTestRandom(&seed) % (sizeof(alphabet) - 1)];
+		}
+
+		buf[length] = '\0';
+
+		// Every prefix, by length, and the whole string, by null.
+		for (size_t prefix = 0; prefix <= length + 1; prefix++)
+		{
+			VersionParseRecord vpr;
+			size_t n = (prefix > length) ? SIZE_MAX : prefix;
+
+			ClassifyVersionCandidateN(buf, n, &vpr);
+
+			if (IsSemVer(buf, n) != (eSemVer_2_0_0 == vpr.versionType))
+			{
+				failCount++;
+				printf("IsSemVer() disagrees with ClassifyVersionCandidateN() for: '%.*s'\n", (int)prefix, buf);
+			}
+
+			FreeVersionParseData(&vpr);
+		}
+	}
+
+	if (IsSemVer(NULL, 5) || IsSemVer("1.2.3", 0) || !IsSemVer("1.2.3\0junk", 9))
+	{
+		failCount++;
+		printf("IsSemVer() mishandled NULL, zero length or an embedded null.\n");
+	}
+
+	if (IsSemVer("1.2.3-caf\xE9", 10) || IsSemVer("1.2.3+\xC0", 7))
+	{
+		failCount++;
+		printf("IsSemVer() accepted a tag character outside of ASCII.\n");
+	}
+
+	if (0 == failCount) printf("IsSemVer() agreed with the classifier.\n");
+
+	return failCount;
+}
+
+// Everything in the record, including the tag arrays, must match.
+static bool RecordsMatch(const VersionParseRecord *pvpr1, const VersionParseRecord *pvpr2)
+{
+	if ((pvpr1->versionType != pvpr2->versionType) || (pvpr1->state != pvpr2->state) || (pvpr1->parsedIdx != pvpr2->parsedIdx)
+		|| (pvpr1->majorDigits != pvpr2->majorDigits) || (pvpr1->minorDigits != pvpr2->minorDigits) || (pvpr1->patchDigits != pvpr2->patchDigits)
+		|| (pvpr1->minorIdx != pvpr2->minorIdx) || (pvpr1->patchIdx != pvpr2->patchIdx)
+		|| (pvpr1->prereleaseChars != pvpr2->prereleaseChars) || (pvpr1->prereleaseFieldCount != pvpr2->prereleaseFieldCount)
+		|| (pvpr1->metaChars != pvpr2->metaChars) || (pvpr1->metaFieldCount != pvpr2->metaFieldCount)
+		|| (pvpr1->isPrereleaseVersion != pvpr2->isPrereleaseVersion) || (pvpr1->hasPrereleaseTag != pvpr2->hasPrereleaseTag)
+		|| (pvpr1->hasMetaTag != pvpr2->hasMetaTag) || (pvpr1->fieldNeedsAlphaToPass != pvpr2->fieldNeedsAlphaToPass)
+		|| (pvpr1->majorHasLeadingZero != pvpr2->majorHasLeadingZero) || (pvpr1->minorHasLeadingZero != pvpr2->minorHasLeadingZero)
+		|| (pvpr1->patchHasLeadingZero != pvpr2->patchHasLeadingZero)
+		|| ((NULL == pvpr1->pPrereleaseData) != (NULL == pvpr2->pPrereleaseData))
+		|| ((NULL == pvpr1->pMetaData) != (NULL == pvpr2->pMetaData)))
+	{
+		return false;
+	}
+
+	// A failed parse can leave one more field behind than it counts.
+	for (size_t idx = 0; (NULL != pvpr1->pPrereleaseData) && (idx < pvpr1->prereleaseFieldCount); idx++)
+	{
+		if (0 != memcmp(&pvpr1->pPrereleaseData[idx], &pvpr2->pPrereleaseData[idx], sizeof(ParsedTagRecord))) return false;
+	}
+
+	for (size_t idx = 0; (NULL != pvpr1->pMetaData) && (idx < pvpr1->metaFieldCount); idx++)
+	{
+		if (0 != memcmp(&pvpr1->pMetaData[idx], &pvpr2->pMetaData[idx], sizeof(ParsedTagRecord))) return false;
+	}
+
+	return true;
+}
+
+// Copies an ASCII string into UTF-16 and UTF-32 buffers, with the null.
+static void WidenVersion(const char *pVersion, char16_t *pVersion16, char32_t *pVersion32)
+{
+	size_t idx = 0;
+
+	do
+	{
+		pVersion16[idx] = (char16_t)(unsigned char)pVersion[idx];
+		pVersion32[idx] = (char32_t)(unsigned char)pVersion[idx];
+	} while ('\0' != pVersion[idx++]);
+}
+
+// Classifies pVersion every way there is, and checks that the records match.
+static size_t CheckWideClassification(const char *pVersion, size_t length)
+{
+	char16_t version16[BUFSIZE];
+	char32_t version32[BUFSIZE];
+	VersionParseRecord vpr;
+	VersionParseRecord vpr16;
+	VersionParseRecord vpr32;
+
+	WidenVersion(pVersion, version16, version32);
+	ClassifyVersionCandidateN(pVersion, length, &vpr);
+	ClassifyVersionCandidate16(version16, length, &vpr16);
+	ClassifyVersionCandidate32(version32, length, &vpr32);
+
+	bool passed = RecordsMatch(&vpr, &vpr16) && RecordsMatch(&vpr, &vpr32);
+
+	if (!passed) printf("Wide classification disagrees with ClassifyVersionCandidateN() for: '%s', length %zu\n", pVersion, length);
+
+	FreeVersionParseData(&vpr);
+	FreeVersionParseData(&vpr16);
+	FreeVersionParseData(&vpr32);
+
+	return passed ? 0 : 1;
+}
+
+// Narrow bytes of 0x80 and up must fail, the way wide units outside of ASCII
+// do, wherever they turn up.
+static size_t CheckHighBitBytes(void)
+{
+	static const char *templates[] = { "#.2.3", "1.#.3", "1.2.#", "1.2.3-#", "1.2.3-a.#", "1.2.3+#", "1.2.3+b.#", "#" };
+	size_t failCount = 0;
+	char buf[16];
+
+	for (size_t idx = 0; idx < sizeof(templates) / sizeof(templates[0]); idx++)
+	{
+		for (unsigned byte = 0x80; byte <= 0xFF; byte++)
+		{
+			VersionParseRecord vpr;
+
+			strcpy(buf, templates[idx]);
+			*strchr(buf, '#') = (char)byte;
+			ClassifyVersionCandidate(buf, &vpr);
+
+			if ((eSemVer_2_0_0 == vpr.versionType) || IsSemVer(buf, SIZE_MAX))
+			{
+				failCount++;
+				printf("Byte 0x%02X was accepted in: %s\n", byte, templates[idx]);
+			}
+
+			FreeVersionParseData(&vpr);
+			failCount += CheckWideClassification(buf, SIZE_MAX);
+		}
+	}
+
+	return failCount;
+}
+
+// UTF-16 and UTF-32 classification must give exactly the same records as the
+// narrow classifier, compare the same, and stop at the first unit that isn't
+// ASCII.
+size_t RunWideTests(void)
+{
+	static const char alphabet[] = "0019..--++aZ";
+	size_t precedenceCount = sizeof(_precedenceOrder) / sizeof(_precedenceOrder[0]);
+	size_t failCount = 0;
+	uint32_t seed = 20201212;
+	char buf[16];
+
+	for (size_t test = 0; test < 50000; test++)
+	{
+		size_t length = NextTestRandom(&seed) % (sizeof(buf) - 1);
+
+		for (size_t idx = 0; idx < length; idx++)
+		{
+			buf[idx] = alphabet[NextTestRandom(&seed) % (sizeof(alphabet) - 1)];
+		}
+
+		buf[length] = '\0';
+
+		failCount += CheckWideClassification(buf, SIZE_MAX);
+		failCount += CheckWideClassification(buf, NextTestRandom(&seed) % (length + 1));
+	}
+
+	for (size_t idx1 = 0; idx1 < precedenceCount; idx1++)
+	{
+		failCount += CheckWideClassification(_precedenceOrder[idx1], SIZE_MAX);
+
+		for (size_t idx2 = 0; idx2 < precedenceCount; idx2++)
+		{
+			const char *pV1 = _precedenceOrder[idx1];
+			const char *pV2 = _precedenceOrder[idx2];
+			char16_t v1_16[BUFSIZE], v2_16[BUFSIZE];
+			char32_t v1_32[BUFSIZE], v2_32[BUFSIZE];
+			VersionParseRecord vpr1, vpr2, vpr1_16, vpr2_16, vpr1_32, vpr2_32;
+
+			WidenVersion(pV1, v1_16, v1_32);
+			WidenVersion(pV2, v2_16, v2_32);
+			ClassifyVersionCandidate(pV1, &vpr1);
+			ClassifyVersionCandidate(pV2, &vpr2);
+			ClassifyVersionCandidate16(v1_16, SIZE_MAX, &vpr1_16);
+			ClassifyVersionCandidate16(v2_16, SIZE_MAX, &vpr2_16);
+			ClassifyVersionCandidate32(v1_32, SIZE_MAX, &vpr1_32);
+			ClassifyVersionCandidate32(v2_32, SIZE_MAX, &vpr2_32);
+
+			int expected = CompareVersions(pV1, &vpr1, pV2, &vpr2);
+
+			if ((expected != CompareVersions16(v1_16, &vpr1_16, v2_16, &vpr2_16)) || (expected != CompareVersions32(v1_32, &vpr1_32, v2_32, &vpr2_32)))
+			{
+				failCount++;
+				printf("Wide comparison disagrees with CompareVersions() for: %s, %s\n", pV1, pV2);
+			}
+
+			FreeVersionParseData(&vpr1);
+			FreeVersionParseData(&vpr2);
+			FreeVersionParseData(&vpr1_16);
+			FreeVersionParseData(&vpr2_16);
+			FreeVersionParseData(&vpr1_32);
+			FreeVersionParseData(&vpr2_32);
+		}
+	}
+
+	// U+0133 would read as '3' if units were just truncated to bytes.
+	static const char16_t nonAscii16[] = u"1.2.\u0133";
+	static const char16_t surrogates16[] = u"1.2.3-a\U0001F600";
+	static const char32_t nonAscii32[] = U"1.2.3+\U0001F600";
+	VersionParseRecord vpr;
+
+	ClassifyVersionCandidate16(nonAscii16, SIZE_MAX, &vpr);
+	failCount += (eSemVer_2_0_0 == vpr.versionType) || (4 != vpr.parsedIdx);
+	FreeVersionParseData(&vpr);
+
+	ClassifyVersionCandidate16(surrogates16, SIZE_MAX, &vpr);
+	failCount += (eSemVer_2_0_0 == vpr.versionType) || (7 != vpr.parsedIdx);
+	FreeVersionParseData(&vpr);
+
+	ClassifyVersionCandidate32(nonAscii32, SIZE_MAX, &vpr);
+	failCount += (eSemVer_2_0_0 == vpr.versionType) || (6 != vpr.parsedIdx);
+	FreeVersionParseData(&vpr);
+
+	// Latin-1 superscript three, which some locales' isdigit() accepts.
+	ClassifyVersionCandidate("1.2.\xB3", &vpr);
+	failCount += (eSemVer_2_0_0 == vpr.versionType) || (4 != vpr.parsedIdx);
+	FreeVersionParseData(&vpr);
+
+	failCount += CheckHighBitBytes();
+
+	if (0 == failCount) printf("UTF-16 and UTF-32 classification and comparison agreed with the narrow versions.\n");
+
+	return failCount;
+}
+
+typedef struct
+{
+	const char *pVersion;
+	VersionComponent component;
+	ComponentStatus status;
+	uint64_t value;
+	ComponentStatus status128;
+	uint64_t high;
+	uint64_t low;
+} ComponentCase;
+
+static const ComponentCase _componentCases[] =
+{
+	{ "1.2.3", eVersionMajor, eComponentOk, 1, eComponentOk, 0, 1 },
+	{ "1.2.3", eVersionMinor, eComponentOk, 2, eComponentOk, 0, 2 },
+	{ "10.20.30-rc.1+b", eVersionPatch, eComponentOk, 30, eComponentOk, 0, 30 },
+	{ "0.0.4", eVersionMajor, eComponentOk, 0, eComponentOk, 0, 0 },
+	{ "18446744073709551615.0.0", eVersionMajor, eComponentOk, UINT64_MAX, eComponentOk, 0, UINT64_MAX },
+	{ "1.18446744073709551616.0", eVersionMinor, eComponentOverflow, UINT64_MAX, eComponentOk, 1, 0 },
+	{ "1.2.99999999999999999999", eVersionPatch, eComponentOverflow, UINT64_MAX, eComponentOk, 5, 7766279631452241919ull },
+	{ "340282366920938463463374607431768211455.0.0", eVersionMajor, eComponentOverflow, UINT64_MAX, eComponentOk, UINT64_MAX, UINT64_MAX },
+	{ "340282366920938463463374607431768211456.0.0", eVersionMajor, eComponentOverflow, UINT64_MAX, eComponentOverflow, UINT64_MAX, UINT64_MAX },
+	{ "340282366920938463463374607431768211460.0.0", eVersionMajor, eComponentOverflow, UINT64_MAX, eComponentOverflow, UINT64_MAX, UINT64_MAX },
+	{ "425352958651173079329218259289710264310.0.0", eVersionMajor, eComponentOverflow, UINT64_MAX, eComponentOverflow, UINT64_MAX, UINT64_MAX },
+	{ "425352958651173079329218259289710264319.0.0", eVersionMajor, eComponentOverflow, UINT64_MAX, eComponentOverflow, UINT64_MAX, UINT64_MAX },
+	{ "99999999999999999999999999999999999999999.0.0", eVersionMajor, eComponentOverflow, UINT64_MAX, eComponentOverflow, UINT64_MAX, UINT64_MAX },
+	{ "1.2", eVersionMajor, eComponentNotSemVer, 0, eComponentNotSemVer, 0, 0 },
+};
+
+size_t RunComponentTests(void)
+{
+	size_t failCount = 0;
+
+	for (size_t idx = 0; idx < sizeof(_componentCases) / sizeof(_componentCases[0]); idx++)
+	{
+		const ComponentCase *pCase = &_componentCases[idx];
+		VersionParseRecord vpr;
+		uint64_t value = 0;
+		uint64_t cached = 0;
+		uint64_t high = 0;
+		uint64_t low = 0;
+
+		ClassifyVersionCandidate(pCase->pVersion, &vpr);
+
+		// 128 bits before and after the 64 bit value is cached.
+		bool passed = (pCase->status128 == GetVersionComponent128(pCase->pVersion, &vpr, pCase->component, &high, &low))
+			&& (pCase->high == high) && (pCase->low == low) && (0 == vpr.componentsCached);
+
+		passed = passed && (pCase->status == GetVersionComponent(pCase->pVersion, &vpr, pCase->component, &value)) && (pCase->value == value);
+
+		// Only the component we asked for is cached, and asking again gives the same answer.
+		uint8_t bit = (uint8_t)(1 << pCase->component);
+
+		if (eComponentNotSemVer != pCase->status)
+		{
+			passed = passed && (bit == vpr.componentsCached) && ((eComponentOverflow == pCase->status) == (bit == vpr.componentsOverflowed));
+		}
+
+		passed = passed && (pCase->status == GetVersionComponent(pCase->pVersion, &vpr, pCase->component, &cached)) && (value == cached);
+		passed = passed && (pCase->status128 == GetVersionComponent128(pCase->pVersion, &vpr, pCase->component, &high, &low))
+			&& (pCase->high == high) && (pCase->low == low);
+
+		if (passed)
+		{
+			printf("GetVersionComponent() passed: %s\n", pCase->pVersion);
+		}
+		else
+		{
+			failCount++;
+			printf("GetVersionComponent() failed: %s\n", pCase->pVersion);
+		}
+
+		FreeVersionParseData(&vpr);
+	}
+
+	return failCount;
 }
 
 int main(int argc, char** argv)
 {
+	size_t failCount = 0;
+
 	for (int idx = 1; idx < argc; idx++)
 	{
-		ProcessFile(argv[idx]);
+		failCount += ProcessFile(argv[idx]);
 	}
 
-	return 0;
+	failCount += RunPrecedenceTests();
+	failCount += RunIsSemVerTests();
+	failCount += RunWideTests();
+	failCount += RunComponentTests();
+	failCount += RunLenientTests();
+	failCount += RunScanTests();
+	failCount += RunViewTests();
+	failCount += RunBatchTests();
+	failCount += RunLockfileTests();
+	failCount += RunCatalogTests();
+	failCount += RunSetTests();
+	failCount += RunStatsTests();
+	failCount += RunSortTests();
+	failCount += RunMergeTests();
+	failCount += RunRangeTests();
+	failCount += RunIndexTests();
+	failCount += RunRankTests();
+	failCount += RunCacheTests();
+
+	return (0 == failCount) ? 0 : 1;
 }
@@ -0,0 +1,43 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#pragma once
+
+#ifndef _SharperHacks_SemVerLibUT_h_Defined
+#define _SharperHacks_SemVerLibUT_h_Defined
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Test data.
+
+// A fixed generator, so every run, and every platform, sees the same data.
+uint32_t NextTestRandom(uint32_t *pSeed);
+
+// Writes a random "major.minor.patch", with each field below fieldLimit, and
+// one of ppTags after it, into pVersion.  Small limits give plenty of 
+// duplicates.  Tags can be prerelease, meta data, both, or junk.
+void MakeTestVersion(uint32_t *pSeed, uint32_t fieldLimit, const char * const *ppTags, size_t tagCount, char *pVersion, size_t size);
+
+// Each of these returns the number of failed test cases.
+
+size_t RunBatchTests(void);
+size_t RunCacheTests(void);
+size_t RunCatalogTests(void);
+size_t RunIndexTests(void);
+size_t RunLockfileTests(void);
+size_t RunMergeTests(void);
+size_t RunRangeTests(void);
+size_t RunRankTests(void);
+size_t RunScanTests(void);
+size_t RunSetTests(void);
+size_t RunSortTests(void);
+size_t RunStatsTests(void);
+size_t RunViewTests(void);
+
+#endif
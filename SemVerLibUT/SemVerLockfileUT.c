@@ -0,0 +1,218 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerLockfile.h"
+#include "SemVerLibUT.h"
+
+#define MAX_ENTRIES 16
+
+typedef struct
+{
+	const char *pName;
+	const char *pVersion;
+	bool isSemVer;
+} ExpectedEntry;
+
+typedef struct
+{
+	const char *pTestName;
+	LockfileFormat format;
+	const char *pText;
+	ExpectedEntry expected[MAX_ENTRIES];
+	size_t expectedCount;
+} LockfileTest;
+
+// Lockfile version 2, where the legacy "dependencies" repeat "packages".
+static const char _npmText[] =
+	"\xEF\xBB\xBF{\n"
+	"  \"name\": \"app\",\n"
+	"  \"version\": \"1.0.0\",\n"
+	"  \"lockfileVersion\": 2,\n"
+	"  \"requires\": true,\n"
+	"  \"packages\": {\n"
+	"    \"\": { \"name\": \"app\", \"version\": \"1.0.0\", \"dependencies\": { \"left-pad\": \"^1.3.0\" } },\n"
+	"    \"node_modules/left-pad\": {\n"
+	"      \"version\": \"1.3.0\",\n"
+	"      \"note\": \"not a \\\"version\\\": \\\"9.9.9\\\" \\\\\",\n"
+	"      \"engines\": [ { \"node\": \">=0.10\" } ], \"dev\": true\n"
+	"    },\n"
+	"    \"node_modules/@scope/pkg\": { \"version\" : \"2.0.0-rc.1+build.5\" },\n"
+	"    \"node_modules/a/node_modules/b\": { \"version\": \"file:../b\" }\n"
+	"  },\n"
+	"  \"dependencies\": {\n"
+	"    \"left-pad\": { \"version\": \"1.3.0\" }\n"
+	"  }\n"
+	"}\n";
+
+// Lockfile version 1, with nested dependencies.
+static const char _npmV1Text[] =
+	"{\"name\":\"app\",\"version\":\"0.1.0\",\"lockfileVersion\":1,\"dependencies\":{"
+	"\"a\":{\"version\":\"1.0.0\",\"requires\":{\"b\":\"^2.0.0\"},\"dependencies\":{\"b\":{\"version\":\"2.0.1\"}}},"
+	"\"c\":{\"version\":\"3.0.0\",\"dev\":true}}}";
+
+static const char _cargoText[] =
+	"# This file is automatically @generated by Cargo.\n"
+	"# It is not intended for manual editing.\n"
+	"version = 3\n"
+	"\n"
+	"[[package]]\n"
+	"name = \"serde\"\n"
+	"version = \"1.0.130\"\n"
+	"source = \"registry+https://github.com/rust-lang/crates.io-index\"\n"
+	"\n"
+	"[[package]]\r\n"
+	"name = \"app\"\r\n"
+	"version = \"0.1.0-alpha.1\"\r\n"
+	"dependencies = [\r\n"
+	" \"serde\",\r\n"
+	"]\r\n"
+	"\n"
+	"[[package]]\n"
+	"name = \"utf8\"\n"
+	"version = \"1.0.0-caf\xC3\xA9\"\n"
+	"\n"
+	"[[package]]\n"
+	"name = \"latin1\"\n"
+	"version = \"2.0.0+\xE9t\xE9\"\n"
+	"\n"
+	"[metadata]\n"
+	"version = \"9.9.9\"\n";
+
+static const char _goSumText[] =
+	"github.com/pkg/errors v0.9.1 h1:FEBLx1zS214owpjy7qsBeixbURkuhQAwrK5UwLGTwt4=\n"
+	"github.com/pkg/errors v0.9.1/go.mod h1:bwawxfHBFNV+L2hUp1rHADufV3IMtnDRdf1r5NINEl0=\n"
+	"golang.org/x/text v0.3.0/go.mod h1:NqM8EUOU14njkJ3fqMW+pc6Ldnwhi/IjpwHt7yyuwOQ=\n"
+	"golang.org/x/sys v0.0.0-20200930185726-fdedc70b468f h1:+Nyd8tzPX9R7BWHguqsrbFdRx3WQ/1ib8I44HXV5yTA=\n"
+	"\n"
+	"gopkg.in/yaml.v2 v2.2.8+incompatible h1:obN1ZagJSUGI0Ek/LBmuj4SNLPfIny3KsKFopxRdj10=";
+
+static const LockfileTest _lockfileTests[] =
+{
+	{
+		"package-lock.json", eLockfileNpm, _npmText,
+		{
+			{ "", "1.0.0", true },
+			{ "", "1.0.0", true },
+			{ "left-pad", "1.3.0", true },
+			{ "@scope/pkg", "2.0.0-rc.1+build.5", true },
+			{ "b", "file:../b", false },
+		},
+		5
+	},
+	{
+		"package-lock.json v1", eLockfileNpm, _npmV1Text,
+		{
+			{ "", "0.1.0", true },
+			{ "a", "1.0.0", true },
+			{ "b", "2.0.1", true },
+			{ "c", "3.0.0", true },
+		},
+		4
+	},
+	{
+		"Cargo.lock", eLockfileCargo, _cargoText,
+		{
+			{ "serde", "1.0.130", true },
+			{ "app", "0.1.0-alpha.1", true },
+			{ "utf8", "1.0.0-caf\xC3\xA9", false },
+			{ "latin1", "2.0.0+\xE9t\xE9", false },
+		},
+		4
+	},
+	{
+		"go.sum", eLockfileGoSum, _goSumText,
+		{
+			{ "github.com/pkg/errors", "0.9.1", true },
+			{ "golang.org/x/text", "0.3.0", true },
+			{ "golang.org/x/sys", "0.0.0-20200930185726-fdedc70b468f", true },
+			{ "gopkg.in/yaml.v2", "2.2.8+incompatible", true },
+		},
+		4
+	},
+};
+
+static bool SpanIs(const char *pText, size_t offset, size_t length, const char *pExpected)
+{
+	return (strlen(pExpected) == length) && (0 == strncmp(pText + offset, pExpected, length));
+}
+
+// Scan maxEntries at a time, and check everything that comes out.
+static size_t CheckLockfile(const LockfileTest *pTest, size_t maxEntries)
+{
+	LockfileScanner scanner;
+	LockfileEntry entries[MAX_ENTRIES];
+	size_t found = 0;
+	size_t mismatches = 0;
+	size_t count;
+
+	InitLockfileScanner(&scanner, eLockfileUnknown, pTest->pText, strlen(pTest->pText));
+
+	if (pTest->format != scanner.format)
+	{
+		printf("DetectLockfileFormat() failed for: %s\n", pTest->pTestName);
+		return 1;
+	}
+
+	do
+	{
+		count = ScanLockfile(&scanner, entries, maxEntries);
+
+		for (size_t idx = 0; idx < count; idx++, found++)
+		{
+			const LockfileEntry *pEntry = &entries[idx];
+
+			if ((found >= pTest->expectedCount)
+				|| !SpanIs(pTest->pText, pEntry->nameOffset, pEntry->nameLength, pTest->expected[found].pName)
+				|| !SpanIs(pTest->pText, pEntry->versionOffset, pEntry->versionLength, pTest->expected[found].pVersion)
+				|| (pTest->expected[found].isSemVer != (eSemVer_2_0_0 == pEntry->record.versionType)))
+			{
+				mismatches++;
+			}
+
+			FreeVersionParseData(&entries[idx].record);
+		}
+	} while (count == maxEntries);
+
+	if ((0 != mismatches) || (found != pTest->expectedCount))
+	{
+		printf("ScanLockfile() found %zu entries, with %zu mismatches, %zu at a time in: %s\n", found, mismatches, maxEntries, pTest->pTestName);
+		return 1;
+	}
+
+	printf("ScanLockfile() found every version, %zu at a time in: %s\n", maxEntries, pTest->pTestName);
+	return 0;
+}
+
+size_t RunLockfileTests(void)
+{
+	size_t failCount = 0;
+
+	for (size_t idx = 0; idx < sizeof(_lockfileTests) / sizeof(_lockfileTests[0]); idx++)
+	{
+		failCount += CheckLockfile(&_lockfileTests[idx], 1);
+		failCount += CheckLockfile(&_lockfileTests[idx], MAX_ENTRIES);
+	}
+
+	LockfileScanner scanner;
+	LockfileEntry entry;
+
+	InitLockfileScanner(&scanner, eLockfileUnknown, "no versions here", 16);
+
+	if ((eLockfileUnknown != scanner.format) || (0 != ScanLockfile(&scanner, &entry, 1)))
+	{
+		failCount++;
+		printf("ScanLockfile() didn't ignore a file it doesn't know.\n");
+	}
+
+	return failCount;
+}
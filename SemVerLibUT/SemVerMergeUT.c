@@ -0,0 +1,294 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerMerge.h"
+#include "..\SemVerLib\SemVerSort.h"
+#include "SemVerLibUT.h"
+
+#define MERGE_TEST_COUNT 5000
+#define MERGE_TEST_LENGTH 32
+#define MERGE_MAX_SOURCES 16
+
+static const char *_mergeTags[] = { "", "-alpha", "-alpha.1", "-beta", "-rc.1", "+build", "+build.2", "junk" };
+
+// A list of strings, handed out in order.
+typedef struct
+{
+	const char * const *ppVersions;
+	size_t count;
+	size_t next;
+} ListSource;
+
+// Every step'th version of a sorted array.
+typedef struct
+{
+	const SortableVersion *pVersions;
+	size_t count;
+	size_t step;
+	size_t next;
+} DealtSource;
+
+typedef struct
+{
+	const char *pName;
+	const char *sources[3][4];
+	bool dropDuplicates;
+	const char *pExpected[8];
+	MergeStatus finalStatus;
+	size_t finalSourceIdx;
+} MergeTest;
+
+static const MergeTest _mergeTests[] =
+{
+	{ "Interleaved", { { "1.0.0", "1.2.0", "3.0.0" }, { "1.1.0", "2.0.0" }, { "0.9.0" } }, false, { "0.9.0", "1.0.0", "1.1.0", "1.2.0", "2.0.0", "3.0.0" }, eMergeEnd, 0 },
+	{ "Stable", { { "1.0.0+a", "1.0.0+b" }, { "1.0.0+c", "1.0.0" } }, false, { "1.0.0+a", "1.0.0+b", "1.0.0+c", "1.0.0" }, eMergeEnd, 0 },
+	{ "Deduplicated", { { "1.0.0+a", "2.0.0" }, { "1.0.0+b", "1.0.0", "2.0.0-rc" } }, true, { "1.0.0+a", "2.0.0-rc", "2.0.0" }, eMergeEnd, 0 },
+	{ "Not SemVer kept", { { "1.0.0", "x" }, { "1.0.0", "x" } }, true, { "1.0.0", "x", "x" }, eMergeEnd, 0 },
+	{ "Empty sources", { { NULL }, { "1.0.0-alpha", "1.0.0" }, { NULL } }, false, { "1.0.0-alpha", "1.0.0" }, eMergeEnd, 0 },
+	{ "Out of order", { { "1.0.0", "2.0.0", "1.5.0" }, { "1.2.0" } }, false, { "1.0.0", "1.2.0", "2.0.0" }, eMergeOutOfOrder, 0 },
+	{ "SemVer after junk", { { "1.0.0" }, { "junk", "1.0.0" } }, false, { "1.0.0", "junk" }, eMergeOutOfOrder, 1 },
+};
+
+static bool NextDealtVersion(void *pContext, const char **ppVersion, size_t *pLength)
+{
+	DealtSource *pSource = (DealtSource*)pContext;
+
+	if (pSource->next >= pSource->count) return false;
+
+	*ppVersion = pSource->pVersions[pSource->next].pVersion;
+	*pLength = strlen(*ppVersion);
+	pSource->next += pSource->step;
+
+	return true;
+}
+
+static bool NextListVersion(void *pContext, const char **ppVersion, size_t *pLength)
+{
+	ListSource *pSource = (ListSource*)pContext;
+
+	if (pSource->next >= pSource->count) return false;
+
+	*ppVersion = pSource->ppVersions[pSource->next++];
+	*pLength = strlen(*ppVersion);
+
+	return true;
+}
+
+static size_t RunMergeTableTests(void)
+{
+	size_t failCount = 0;
+
+	for (size_t test = 0; test < sizeof(_mergeTests) / sizeof(_mergeTests[0]); test++)
+	{
+		const MergeTest *pTest = &_mergeTests[test];
+		ListSource lists[3];
+		VersionSource sources[3];
+
+		for (size_t idx = 0; idx < 3; idx++)
+		{
+			lists[idx].ppVersions = pTest->sources[idx];
+			lists[idx].count = 0;
+			lists[idx].next = 0;
+
+			while ((lists[idx].count < 4) && (NULL != pTest->sources[idx][lists[idx].count])) lists[idx].count++;
+
+			sources[idx].pNext = NextListVersion;
+			sources[idx].pContext = &lists[idx];
+		}
+
+		VersionMerger *pMerger = CreateVersionMerger(sources, 3, pTest->dropDuplicates);
+		bool passed = (NULL != pMerger);
+		size_t found = 0;
+		MergeStatus status = eMergeOutOfMemory;
+		size_t sourceIdx = 0;
+
+		while (passed)
+		{
+			const char *pVersion;
+			size_t length;
+
+			status = NextMergedVersion(pMerger, &pVersion, &length, &sourceIdx);
+
+			if (eMergeVersion != status) break;
+
+			passed = (found < 8) && (NULL != pTest->pExpected[found])
+				&& (length == strlen(pTest->pExpected[found])) && (0 == memcmp(pVersion, pTest->pExpected[found], length));
+			found++;
+		}
+
+		passed = passed && ((8 == found) || (NULL == pTest->pExpected[found])) && (status == pTest->finalStatus);
+
+		// Errors are sticky.
+		if (passed && (eMergeOutOfOrder == status))
+		{
+			const char *pVersion;
+			size_t length;
+
+			passed = (sourceIdx == pTest->finalSourceIdx) && (eMergeOutOfOrder == NextMergedVersion(pMerger, &pVersion, &length, NULL));
+		}
+
+		if (passed)
+		{
+			printf("Merge test '%s' passed.\n", pTest->pName);
+		}
+		else
+		{
+			failCount++;
+			printf("Merge test '%s' failed after %zu versions.\n", pTest->pName, found);
+		}
+
+		FreeVersionMerger(pMerger);
+	}
+
+	VersionMerger *pEmpty = CreateVersionMerger(NULL, 0, false);
+	const char *pVersion;
+	size_t length;
+
+	if ((NULL == pEmpty) || (eMergeEnd != NextMergedVersion(pEmpty, &pVersion, &length, NULL)))
+	{
+		failCount++;
+		printf("Merging no sources should end at once.\n");
+	}
+
+	FreeVersionMerger(pEmpty);
+
+	return failCount;
+}
+
+// Deal the sorted versions out to sourceCount sources, round robin, and merge
+// them back together.
+static size_t RunDealtMergeTest(const SortableVersion *pSorted, size_t sourceCount, bool dropDuplicates)
+{
+	DealtSource dealt[MERGE_MAX_SOURCES];
+	VersionSource sources[MERGE_MAX_SOURCES];
+	SortableVersion last;
+	size_t lastSourceIdx = 0;
+	size_t expectedCount = MERGE_TEST_COUNT;
+	size_t found = 0;
+	bool passed = true;
+
+	for (size_t idx = 0; idx < sourceCount; idx++)
+	{
+		dealt[idx].pVersions = pSorted;
+		dealt[idx].count = MERGE_TEST_COUNT;
+		dealt[idx].step = sourceCount;
+		dealt[idx].next = idx;
+		sources[idx].pNext = NextDealtVersion;
+		sources[idx].pContext = &dealt[idx];
+	}
+
+	if (dropDuplicates)
+	{
+		for (size_t idx = 1; idx < MERGE_TEST_COUNT; idx++)
+		{
+			if ((eSemVer_2_0_0 == pSorted[idx].record.versionType) && (0 == CompareSortableVersions(&pSorted[idx - 1], &pSorted[idx]))) expectedCount--;
+		}
+	}
+
+	memset(&last, 0, sizeof(last));
+
+	VersionMerger *pMerger = CreateVersionMerger(sources, sourceCount, dropDuplicates);
+	MergeStatus status = eMergeOutOfMemory;
+
+	while (passed && (NULL != pMerger))
+	{
+		SortableVersion next;
+		size_t length;
+		size_t sourceIdx;
+
+		status = NextMergedVersion(pMerger, &next.pVersion, &length, &sourceIdx);
+
+		if (eMergeVersion != status) break;
+
+		ClassifyVersionCandidateN(next.pVersion, length, &next.record);
+
+		// In order, and versions that compare equal come out in source order,
+		// unless they're duplicates that should have been dropped.
+		if (0 != found)
+		{
+			int order = CompareSortableVersions(&last, &next);
+
+			passed = (order < 0) || ((0 == order) && (lastSourceIdx <= sourceIdx)
+				&& !(dropDuplicates && (eSemVer_2_0_0 == next.record.versionType)));
+		}
+
+		FreeVersionParseData(&last.record);
+		last = next;
+		lastSourceIdx = sourceIdx;
+		found++;
+	}
+
+	FreeVersionParseData(&last.record);
+	FreeVersionMerger(pMerger);
+
+	if (passed && (eMergeEnd == status) && (expectedCount == found))
+	{
+		printf("Merged %zu versions from %zu sources%s.\n", found, sourceCount, dropDuplicates ? ", dropping duplicates" : "");
+		return 0;
+	}
+
+	printf("Merging %zu sources%s failed after %zu versions.\n", sourceCount, dropDuplicates ? ", dropping duplicates" : "", found);
+
+	return 1;
+}
+
+size_t RunMergeTests(void)
+{
+	static const size_t sourceCounts[] = { 1, 2, 3, 7, MERGE_MAX_SOURCES };
+
+	size_t failCount = RunMergeTableTests();
+	char (*pBuffer)[MERGE_TEST_LENGTH] = malloc(MERGE_TEST_COUNT * MERGE_TEST_LENGTH);
+	SortableVersion *pSorted = malloc(MERGE_TEST_COUNT * sizeof(SortableVersion));
+
+	if ((NULL == pBuffer) || (NULL == pSorted))
+	{
+		printf("Merge tests are out of memory.\n");
+		free(pBuffer);
+		free(pSorted);
+		return failCount + 1;
+	}
+
+	uint32_t seed = 54321;
+
+	for (size_t idx = 0; idx < MERGE_TEST_COUNT; idx++)
+	{
+		MakeTestVersion(&seed, 6, _mergeTags, sizeof(_mergeTags) / sizeof(_mergeTags[0]), pBuffer[idx], MERGE_TEST_LENGTH);
+		pSorted[idx].pVersion = pBuffer[idx];
+		ClassifyVersionCandidate(pBuffer[idx], &pSorted[idx].record);
+	}
+
+	if (!SortVersions(pSorted, MERGE_TEST_COUNT, 1))
+	{
+		failCount++;
+		printf("Merge tests couldn't sort their input.\n");
+	}
+	else
+	{
+		for (size_t test = 0; test < sizeof(sourceCounts) / sizeof(sourceCounts[0]); test++)
+		{
+			failCount += RunDealtMergeTest(pSorted, sourceCounts[test], false);
+			failCount += RunDealtMergeTest(pSorted, sourceCounts[test], true);
+		}
+	}
+
+	for (size_t idx = 0; idx < MERGE_TEST_COUNT; idx++)
+	{
+		FreeVersionParseData(&pSorted[idx].record);
+	}
+
+	free(pBuffer);
+	free(pSorted);
+
+	return failCount;
+}
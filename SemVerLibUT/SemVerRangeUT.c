@@ -0,0 +1,240 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerRange.h"
+#include "SemVerLibUT.h"
+
+typedef struct
+{
+	const char *pLower;
+	bool lowerInclusive;
+	const char *pUpper;
+	bool upperInclusive;
+} TestInterval;
+
+typedef struct
+{
+	TestInterval intervals[3];
+	size_t count;
+	const char *pExpected;
+} RangeTest;
+
+// Built one interval at a time, and checked against the canonical text.
+static const RangeTest _rangeTests[] =
+{
+	{ { { "1.0.0", true, "2.0.0", false } }, 1, ">=1.0.0 <2.0.0" },
+	{ { { "1.0.0", false, "2.0.0", true } }, 1, ">=1.0.1-0 <2.0.1-0" },
+	{ { { "1.2.3-alpha", true, "1.2.3-alpha", true } }, 1, ">=1.2.3-alpha <1.2.3-alpha.0" },
+	{ { { "1.9.9", true, "1.9.99", true } }, 1, ">=1.9.9 <1.9.100-0" },
+	{ { { "1.0.0+build.1", true, "2.0.0-rc.1+build.2", false } }, 1, ">=1.0.0 <2.0.0-rc.1" },
+	{ { { "0.0.0-0", true, "1.0.0", false } }, 1, "<1.0.0" },
+	{ { { NULL, false, NULL, false } }, 1, "*" },
+	{ { { "2.0.0", true, NULL, false } }, 1, ">=2.0.0" },
+
+	// Nothing sorts between a version and its successor.
+	{ { { "1.2.3-alpha", false, "1.2.3-alpha.0", false } }, 1, "<0.0.0-0" },
+	{ { { "1.0.0", false, "1.0.1-0", false } }, 1, "<0.0.0-0" },
+	{ { { "2.0.0", true, "1.0.0", true } }, 1, "<0.0.0-0" },
+	{ { { "1.0.0", true, "1.0.0", false } }, 1, "<0.0.0-0" },
+	{ { { NULL, false, "0.0.0-0", false } }, 1, "<0.0.0-0" },
+
+	// Overlapping and touching intervals merge, in any order.
+	{ { { "1.0.0", true, "2.0.0", false }, { "2.0.0", true, "3.0.0", false } }, 2, ">=1.0.0 <3.0.0" },
+	{ { { "1.0.0", true, "1.0.0", true }, { "1.0.0", false, "2.0.0", false } }, 2, ">=1.0.0 <2.0.0" },
+	{ { { "3.0.0", true, "4.0.0", false }, { "1.0.0", true, "2.0.0", false }, { "1.5.0", true, "1.7.0", false } }, 3, ">=1.0.0 <2.0.0 || >=3.0.0 <4.0.0" },
+	{ { { "1.0.0", true, "2.0.0", false }, { "3.0.0", true, "4.0.0", false }, { "1.5.0", true, "3.5.0", false } }, 3, ">=1.0.0 <4.0.0" },
+	{ { { "1.0.0", true, "2.0.0", false }, { "2.0.0", false, "3.0.0", false } }, 2, ">=1.0.0 <2.0.0 || >=2.0.1-0 <3.0.0" },
+	{ { { NULL, false, "1.0.0", false }, { "2.0.0", true, NULL, false }, { "0.5.0", true, "2.5.0", false } }, 3, "*" },
+	{ { { NULL, false, "2.0.0", false }, { NULL, false, "1.0.0", false } }, 2, "<2.0.0" },
+	{ { { NULL, false, "1.0.0", false }, { NULL, false, "2.0.0", false } }, 2, "<2.0.0" },
+};
+
+// Every set is probed with every one of these.
+static const char *_probeVersions[] =
+{
+	"0.0.0-0", "0.0.0", "0.9.0", "1.0.0-alpha", "1.0.0", "1.0.1-0", "1.0.1", "1.2.3-alpha", "1.2.3-alpha.0", 
+	"1.2.3", "1.5.0", "1.9.9", "1.9.100-0", "2.0.0-0", "2.0.0-rc.1", "2.0.0", "2.0.1-0", "2.5.0", "3.0.0", 
+	"3.5.0", "4.0.0", "99.0.0",
+};
+
+#define RANGE_TEST_COUNT (sizeof(_rangeTests) / sizeof(_rangeTests[0]))
+#define PROBE_COUNT (sizeof(_probeVersions) / sizeof(_probeVersions[0]))
+
+static bool MakeSet(const RangeTest *pTest, VersionRangeSet *pSet)
+{
+	InitVersionRangeSet(pSet);
+
+	for (size_t idx = 0; idx < pTest->count; idx++)
+	{
+		const TestInterval *pInterval = &pTest->intervals[idx];
+
+		if (!AddVersionInterval(pSet, pInterval->pLower, pInterval->lowerInclusive, pInterval->pUpper, pInterval->upperInclusive)) return false;
+	}
+
+	return true;
+}
+
+static size_t CheckFormat(const char *pName, const VersionRangeSet *pSet, const char *pExpected)
+{
+	char text[128];
+	size_t length = FormatVersionRange(pSet, text, sizeof(text));
+
+	if ((length == strlen(pExpected)) && (0 == strcmp(text, pExpected))) return 0;
+
+	printf("%s is \"%s\", expected \"%s\"\n", pName, text, pExpected);
+	return 1;
+}
+
+// Check the set operations, version by version, against a brute force answer.
+static size_t CheckProbes(const VersionRangeSet *pSet1, const VersionRangeSet *pSet2, VersionParseRecord *pProbes)
+{
+	size_t failCount = 0;
+	VersionRangeSet unionSet, intersection, complement;
+
+	InitVersionRangeSet(&unionSet);
+	InitVersionRangeSet(&intersection);
+	InitVersionRangeSet(&complement);
+
+	if (!UnionVersionRanges(pSet1, pSet2, &unionSet) 
+		|| !IntersectVersionRanges(pSet1, pSet2, &intersection)
+		|| !ComplementVersionRange(pSet1, &complement))
+	{
+		printf("Range set operations ran out of memory.\n");
+		failCount++;
+	}
+
+	for (size_t idx = 0; (0 == failCount) && (idx < PROBE_COUNT); idx++)
+	{
+		const char *pProbe = _probeVersions[idx];
+		bool in1 = VersionRangeContains(pSet1, pProbe, &pProbes[idx]);
+		bool in2 = VersionRangeContains(pSet2, pProbe, &pProbes[idx]);
+
+		if ((VersionRangeContains(&unionSet, pProbe, &pProbes[idx]) != (in1 || in2))
+			|| (VersionRangeContains(&intersection, pProbe, &pProbes[idx]) != (in1 && in2))
+			|| (VersionRangeContains(&complement, pProbe, &pProbes[idx]) == in1))
+		{
+			char text1[128], text2[128];
+
+			FormatVersionRange(pSet1, text1, sizeof(text1));
+			FormatVersionRange(pSet2, text2, sizeof(text2));
+			printf("Range set operations on \"%s\" and \"%s\" got %s wrong.\n", text1, text2, pProbe);
+			failCount++;
+		}
+	}
+
+	FreeVersionRangeSet(&unionSet);
+	FreeVersionRangeSet(&intersection);
+	FreeVersionRangeSet(&complement);
+
+	return failCount;
+}
+
+size_t RunRangeTests(void)
+{
+	size_t failCount = 0;
+	VersionRangeSet sets[RANGE_TEST_COUNT];
+	VersionParseRecord probes[PROBE_COUNT];
+
+	for (size_t idx = 0; idx < PROBE_COUNT; idx++)
+	{
+		ClassifyVersionCandidate(_probeVersions[idx], &probes[idx]);
+	}
+
+	for (size_t idx = 0; idx < RANGE_TEST_COUNT; idx++)
+	{
+		char name[32];
+
+		snprintf(name, sizeof(name), "Range test %zu", idx);
+
+		if (!MakeSet(&_rangeTests[idx], &sets[idx]))
+		{
+			printf("%s failed to add an interval.\n", name);
+			failCount++;
+		}
+
+		failCount += CheckFormat(name, &sets[idx], _rangeTests[idx].pExpected);
+		
+		if (IsVersionRangeEmpty(&sets[idx]) != (0 == strcmp(_rangeTests[idx].pExpected, "<0.0.0-0")))
+		{
+			printf("%s has the wrong emptiness.\n", name);
+			failCount++;
+		}
+	}
+
+	for (size_t idx1 = 0; idx1 < RANGE_TEST_COUNT; idx1++)
+	{
+		for (size_t idx2 = 0; idx2 < RANGE_TEST_COUNT; idx2++)
+		{
+			failCount += CheckProbes(&sets[idx1], &sets[idx2], probes);
+		}
+	}
+
+	// Some identities, with results written over their inputs.
+	VersionRangeSet set, other;
+
+	InitVersionRangeSet(&set);
+	InitVersionRangeSet(&other);
+	AddVersionInterval(&set, "1.0.0", true, "2.0.0-0", false);
+	AddVersionInterval(&set, "3.0.0", true, NULL, false);
+
+	ComplementVersionRange(&set, &other);
+	failCount += CheckFormat("Complement", &other, "<1.0.0 || >=2.0.0-0 <3.0.0");
+	IntersectVersionRanges(&set, &other, &other);
+	failCount += CheckFormat("Set intersected with its complement", &other, "<0.0.0-0");
+	ComplementVersionRange(&other, &other);
+	failCount += CheckFormat("Complement of empty", &other, "*");
+	ComplementVersionRange(&other, &other);
+	failCount += CheckFormat("Complement of everything", &other, "<0.0.0-0");
+	ComplementVersionRange(&set, &other);
+	ComplementVersionRange(&other, &other);
+
+	if (!VersionRangesEqual(&set, &other))
+	{
+		printf("Complement of the complement isn't the set.\n");
+		failCount++;
+	}
+
+	ComplementVersionRange(&set, &other);
+	UnionVersionRanges(&other, &set, &other);
+	failCount += CheckFormat("Set united with its complement", &other, "*");
+
+	FreeVersionRangeSet(&other);
+	AddVersionInterval(&other, "1.5.0", true, "3.0.0", true);
+	IntersectVersionRanges(&set, &other, &set);
+	failCount += CheckFormat("Intersection", &set, ">=1.5.0 <2.0.0-0 || >=3.0.0 <3.0.1-0");
+
+	if (AddVersionInterval(&set, "1.2", true, NULL, false) || AddVersionInterval(&set, NULL, false, "1.2.3-01", false))
+	{
+		printf("AddVersionInterval() accepted a bound that isn't SemVer.\n");
+		failCount++;
+	}
+
+	failCount += CheckFormat("Set after bad bounds", &set, ">=1.5.0 <2.0.0-0 || >=3.0.0 <3.0.1-0");
+
+	FreeVersionRangeSet(&set);
+	FreeVersionRangeSet(&other);
+
+	for (size_t idx = 0; idx < RANGE_TEST_COUNT; idx++)
+	{
+		FreeVersionRangeSet(&sets[idx]);
+	}
+
+	for (size_t idx = 0; idx < PROBE_COUNT; idx++)
+	{
+		FreeVersionParseData(&probes[idx]);
+	}
+
+	if (0 == failCount) printf("Range set tests passed.\n");
+
+	return failCount;
+}
@@ -0,0 +1,228 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerRank.h"
+#include "SemVerLibUT.h"
+
+#define RANK_VERSION_COUNT 600
+#define RANK_VERSION_SIZE 32
+
+// Enough in a row, at the same spot, to run out of gap more than once.
+#define RANK_SQUEEZE_COUNT 100
+
+// Lots of ties, some of them differing only in build meta data.
+static const char *_rankTags[] = { "", "", "+b1", "+b.2", "-alpha", "-alpha+b1", "-alpha.1", "-beta", "-beta+b.2", "-1", "-rc.2", "-rc.2+b1" };
+
+static char _rankText[RANK_VERSION_COUNT][RANK_VERSION_SIZE];
+
+static void MakeRankVersions(SortableVersion *pVersions)
+{
+	uint32_t seed = 20201205;
+
+	for (size_t idx = 0; idx < RANK_VERSION_COUNT; idx++)
+	{
+		if (0 == (idx % 50))
+		{
+			// A few that aren't SemVer.
+			snprintf(_rankText[idx], RANK_VERSION_SIZE, "%u.%u", NextTestRandom(&seed) % 3, NextTestRandom(&seed) % 3);
+		}
+		else
+		{
+			MakeTestVersion(&seed, 3, _rankTags, sizeof(_rankTags) / sizeof(_rankTags[0]), _rankText[idx], RANK_VERSION_SIZE);
+		}
+
+		pVersions[idx].pVersion = _rankText[idx];
+		ClassifyVersionCandidate(_rankText[idx], &pVersions[idx].record);
+	}
+}
+
+static inline bool IsSemVerVersion(const SortableVersion *pVersion)
+{
+	return eSemVer_2_0_0 == pVersion->record.versionType;
+}
+
+// Dense ranks agree with CompareVersions(), and leave no gaps.
+static size_t RunDenseRankTests(const SortableVersion *pVersions)
+{
+	uint32_t ranks[RANK_VERSION_COUNT];
+	bool used[RANK_VERSION_COUNT] = { false };
+	size_t rankCount = 0;
+	size_t mismatches = 0;
+
+	if (!RankVersions(pVersions, RANK_VERSION_COUNT, ranks, &rankCount))
+	{
+		printf("RankVersions() ran out of memory.\n");
+		return 1;
+	}
+
+	for (size_t idx1 = 0; idx1 < RANK_VERSION_COUNT; idx1++)
+	{
+		if (!IsSemVerVersion(&pVersions[idx1]))
+		{
+			mismatches += (VERSION_RANK_NONE != ranks[idx1]);
+			continue;
+		}
+
+		if (ranks[idx1] >= rankCount)
+		{
+			mismatches++;
+			continue;
+		}
+
+		used[ranks[idx1]] = true;
+
+		for (size_t idx2 = 0; idx2 < RANK_VERSION_COUNT; idx2++)
+		{
+			if (!IsSemVerVersion(&pVersions[idx2])) continue;
+
+			int expected = CompareVersions(pVersions[idx1].pVersion, &pVersions[idx1].record, pVersions[idx2].pVersion, &pVersions[idx2].record);
+
+			mismatches += (expected != ((ranks[idx1] > ranks[idx2]) - (ranks[idx1] < ranks[idx2])));
+		}
+	}
+
+	for (size_t rank = 0; rank < rankCount; rank++) mismatches += !used[rank];
+
+	if (0 != mismatches)
+	{
+		printf("RankVersions() had %zu mismatches.\n", mismatches);
+		return 1;
+	}
+
+	printf("RankVersions() agreed with CompareVersions(), %zu distinct versions.\n", rankCount);
+	return 0;
+}
+
+// Build from half of the versions, insert the rest, and check every rank.
+static size_t RunRankTableTests(const SortableVersion *pVersions)
+{
+	VersionRankTable table;
+	uint64_t ranks[RANK_VERSION_COUNT];
+	size_t mismatches = 0;
+
+	InitVersionRankTable(&table);
+
+	if (!BuildVersionRankTable(&table, pVersions, RANK_VERSION_COUNT / 2))
+	{
+		printf("BuildVersionRankTable() ran out of memory.\n");
+		return 1;
+	}
+
+	for (size_t idx = RANK_VERSION_COUNT / 2; idx < RANK_VERSION_COUNT; idx++)
+	{
+		uint64_t rank;
+		bool inserted = InsertRankedVersion(&table, pVersions[idx].pVersion, &pVersions[idx].record, &rank);
+
+		mismatches += (inserted != IsSemVerVersion(&pVersions[idx]));
+	}
+
+	for (size_t idx = 0; idx < RANK_VERSION_COUNT; idx++)
+	{
+		bool found = FindVersionRank(&table, pVersions[idx].pVersion, &pVersions[idx].record, &ranks[idx]);
+
+		mismatches += (found != IsSemVerVersion(&pVersions[idx]));
+	}
+
+	for (size_t idx1 = 0; idx1 < RANK_VERSION_COUNT; idx1++)
+	{
+		if (!IsSemVerVersion(&pVersions[idx1])) continue;
+
+		for (size_t idx2 = 0; idx2 < RANK_VERSION_COUNT; idx2++)
+		{
+			if (!IsSemVerVersion(&pVersions[idx2])) continue;
+
+			int expected = CompareVersions(pVersions[idx1].pVersion, &pVersions[idx1].record, pVersions[idx2].pVersion, &pVersions[idx2].record);
+
+			mismatches += (expected != ((ranks[idx1] > ranks[idx2]) - (ranks[idx1] < ranks[idx2])));
+		}
+	}
+
+	FreeVersionRankTable(&table);
+
+	if (0 != mismatches)
+	{
+		printf("VersionRankTable had %zu mismatches.\n", mismatches);
+		return 1;
+	}
+
+	printf("VersionRankTable agreed with CompareVersions().\n");
+	return 0;
+}
+
+// Insert versions closer and closer to "1.0.0", until the table has to 
+// renumber, and check that the ranks stay in order.
+static size_t RunRankSqueezeTests(void)
+{
+	VersionRankTable table;
+	VersionParseRecord record;
+	char version[RANK_VERSION_SIZE];
+	uint64_t rank;
+	uint64_t metaRank = 0;
+	size_t mismatches = 0;
+
+	InitVersionRankTable(&table);
+
+	size_t generation = table.generation;
+
+	for (size_t patch = RANK_SQUEEZE_COUNT + 1; patch-- > 0; )
+	{
+		snprintf(version, sizeof(version), "1.0.%zu", (RANK_SQUEEZE_COUNT == patch) ? (size_t)1000 : patch);
+		ClassifyVersionCandidate(version, &record);
+		mismatches += !InsertRankedVersion(&table, version, &record, &rank);
+		FreeVersionParseData(&record);
+	}
+
+	// Only differs from "1.0.0" in build meta data.
+	ClassifyVersionCandidate("1.0.0+build.7", &record);
+	mismatches += !InsertRankedVersion(&table, "1.0.0+build.7", &record, &metaRank);
+	mismatches += (table.pVersions[0].rank != metaRank);
+	FreeVersionParseData(&record);
+
+	mismatches += (RANK_SQUEEZE_COUNT + 1 != table.count);
+	mismatches += (generation == table.generation);
+
+	for (size_t idx = 1; idx < table.count; idx++)
+	{
+		mismatches += (table.pVersions[idx - 1].rank >= table.pVersions[idx].rank);
+	}
+
+	FreeVersionRankTable(&table);
+
+	if (0 != mismatches)
+	{
+		printf("InsertRankedVersion() had %zu mismatches after renumbering.\n", mismatches);
+		return 1;
+	}
+
+	printf("InsertRankedVersion() kept ranks in order through renumbering.\n");
+	return 0;
+}
+
+size_t RunRankTests(void)
+{
+	SortableVersion versions[RANK_VERSION_COUNT];
+	size_t failCount = 0;
+
+	MakeRankVersions(versions);
+
+	failCount += RunDenseRankTests(versions);
+	failCount += RunRankTableTests(versions);
+	failCount += RunRankSqueezeTests();
+
+	for (size_t idx = 0; idx < RANK_VERSION_COUNT; idx++)
+	{
+		FreeVersionParseData(&versions[idx].record);
+	}
+
+	return failCount;
+}
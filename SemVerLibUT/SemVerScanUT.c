@@ -0,0 +1,164 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerScan.h"
+#include "SemVerLibUT.h"
+
+#define MAX_MATCHES 16
+
+static const char _scanText[] =
+	"Building foo v1.2.3-rc.1. Then 1.2.3.4 and 10.20.30+build.5, 01.2.3 1.2\n"
+	"x1.2.3-01 2.0.0-a.b.c.d.e.f.g+m.a.b.c.d.e.f 123.456.789-\t0.0.4";
+
+static const char *_scanExpected[] =
+{
+	"1.2.3-rc.1",
+	"1.2.3",
+	"10.20.30+build.5",
+	"1.2.3",
+	"2.0.0-a.b.c.d.e.f.g+m.a.b.c.d.e.f",
+	"123.456.789",
+	"0.0.4",
+};
+
+static const char _lineText[] =
+	"1.2.3\r\n  v1.2.4\n\t2.0.0-rc.1+b \n\nnot a version\n1.2\n0.9.0\n1.5.0-beta.2\n3.0.0";
+
+static const char *_lineExpected[] = { "1.2.3", "2.0.0-rc.1+b", "0.9.0", "1.5.0-beta.2", "3.0.0" };
+
+// What's left in [1.0.0, 2.0.0).
+static const char *_lineFilteredExpected[] = { "1.2.3", "2.0.0-rc.1+b", "1.5.0-beta.2" };
+
+static size_t CheckLines(const char *pTestName, const VersionRangeSet *pFilter, const char **ppExpected, size_t expectedCount)
+{
+	VersionLineReader reader;
+	size_t count = 0;
+	size_t failCount = 0;
+
+	InitVersionLineReader(&reader, _lineText, strlen(_lineText), pFilter);
+
+	while (ReadVersionLine(&reader))
+	{
+		const char *pLine = _lineText + reader.lineOffset;
+		bool passed = (count < expectedCount)
+			&& (strlen(ppExpected[count]) == reader.lineLength)
+			&& (0 == strncmp(ppExpected[count], pLine, reader.lineLength))
+			&& (eSemVer_2_0_0 == reader.record.versionType)
+			&& (reader.lineLength == reader.record.parsedIdx);
+
+		if (!passed)
+		{
+			failCount++;
+			printf("%s read unexpected line: %.*s\n", pTestName, (int)reader.lineLength, pLine);
+		}
+
+		count++;
+	}
+
+	FreeVersionLineReader(&reader);
+
+	if (count != expectedCount)
+	{
+		printf("%s read %zu lines, expected %zu.\n", pTestName, count, expectedCount);
+		return failCount + 1;
+	}
+
+	if (0 == failCount) printf("%s read every SemVer line.\n", pTestName);
+
+	return failCount;
+}
+
+static size_t CheckMatches(const char *pTestName, const SemVerMatch *pMatches, size_t count)
+{
+	size_t expectedCount = sizeof(_scanExpected) / sizeof(_scanExpected[0]);
+	size_t failCount = 0;
+
+	if (count != expectedCount)
+	{
+		printf("%s found %zu versions, expected %zu.\n", pTestName, count, expectedCount);
+		return 1;
+	}
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		const SemVerMatch *pMatch = &pMatches[idx];
+		bool passed = (strlen(_scanExpected[idx]) == pMatch->length)
+			&& (0 == strncmp(_scanExpected[idx], _scanText + pMatch->offset, pMatch->length))
+			&& (eSemVer_2_0_0 == pMatch->record.versionType)
+			&& (pMatch->length == pMatch->record.parsedIdx);
+
+		if (passed)
+		{
+			printf("%s found: %s\n", pTestName, _scanExpected[idx]);
+		}
+		else
+		{
+			failCount++;
+			printf("%s failed to find: %s\n", pTestName, _scanExpected[idx]);
+		}
+	}
+
+	return failCount;
+}
+
+size_t RunScanTests(void)
+{
+	SemVerMatch matches[MAX_MATCHES];
+	size_t length = strlen(_scanText);
+	size_t offset = 0;
+
+	// All at once.
+	size_t count = ScanForVersions(_scanText, length, &offset, matches, MAX_MATCHES);
+	size_t failCount = CheckMatches("ScanForVersions()", matches, count);
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		FreeVersionParseData(&matches[idx].record);
+	}
+
+	// One at a time, resuming from the returned offset.
+	offset = 0;
+	count = 0;
+
+	while ((count < MAX_MATCHES) && (1 == ScanForVersions(_scanText, length, &offset, &matches[count], 1)))
+	{
+		count++;
+	}
+
+	failCount += CheckMatches("ScanForVersions() resumed", matches, count);
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		FreeVersionParseData(&matches[idx].record);
+	}
+
+	failCount += CheckLines("ReadVersionLine()", NULL, _lineExpected, sizeof(_lineExpected) / sizeof(_lineExpected[0]));
+
+	VersionRangeSet filter;
+
+	InitVersionRangeSet(&filter);
+
+	if (AddVersionInterval(&filter, "1.0.0", true, "2.0.0", false))
+	{
+		failCount += CheckLines("ReadVersionLine() filtered", &filter, _lineFilteredExpected, sizeof(_lineFilteredExpected) / sizeof(_lineFilteredExpected[0]));
+	}
+	else
+	{
+		failCount++;
+		printf("AddVersionInterval() failed.\n");
+	}
+
+	FreeVersionRangeSet(&filter);
+
+	return failCount;
+}
@@ -0,0 +1,292 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerSet.h"
+#include "..\SemVerLib\SemVerSort.h"
+#include "SemVerLibUT.h"
+
+// Enough to take SortVersionSet() through several merge passes.
+#define SET_TEST_COUNT 1000
+
+static const char *_setVersions[] =
+{
+	"1.0.0", "1.0.0-alpha", "1.0.0-alpha.1", "1.0.0-alpha.beta", "1.0.0-beta", "1.0.0-beta.2",
+	"1.0.0-beta.11", "1.0.0-rc.1", "1.0.0+20130313144700", "1.0.0-alpha+001", "0.0.4", "10.20.30",
+	"1.2.3----RC-SNAPSHOT.12.9.1--.12+788", "1.0.0-a.b.c.d.e.f.g+1.2.3.4.5.6.7.8.9.10.11", "1.0.0-0.3.7",
+	"99999999999999999999999.999999999999999999.9999999999999999", "2.0.0-rc.1+build.123", "1.0.0-x-y-z.--",
+	"not a version", "", "1.2", "01.2.3", "1.2.3-0123", "1.0.0-alpha", "1.0.0",
+};
+
+#define SET_VERSION_COUNT (sizeof(_setVersions) / sizeof(_setVersions[0]))
+
+// More than 255 prerelease fields, or digits, doesn't fit in an entry.
+#define SET_WIDE_COUNT 300
+#define SET_WIDE_SIZE (2 * SET_WIDE_COUNT + 32)
+
+static bool SetRecordMatches(const VersionParseRecord *pExpected, const VersionParseRecord *pActual)
+{
+	if ((pExpected->versionType != pActual->versionType) || (pExpected->state != pActual->state)) return false;
+
+	if (eSemVer_2_0_0 != pExpected->versionType) return true;
+
+	if ((pExpected->majorDigits != pActual->majorDigits) || (pExpected->minorDigits != pActual->minorDigits)
+		|| (pExpected->patchDigits != pActual->patchDigits) || (pExpected->minorIdx != pActual->minorIdx)
+		|| (pExpected->patchIdx != pActual->patchIdx) || (pExpected->parsedIdx != pActual->parsedIdx)
+		|| (pExpected->prereleaseChars != pActual->prereleaseChars) || (pExpected->prereleaseFieldCount != pActual->prereleaseFieldCount)
+		|| (pExpected->metaChars != pActual->metaChars) || (pExpected->metaFieldCount != pActual->metaFieldCount)
+		|| (pExpected->isPrereleaseVersion != pActual->isPrereleaseVersion) || (pExpected->hasPrereleaseTag != pActual->hasPrereleaseTag)
+		|| (pExpected->hasMetaTag != pActual->hasMetaTag))
+	{
+		return false;
+	}
+
+	for (size_t idx = 0; idx < pExpected->prereleaseFieldCount; idx++)
+	{
+		if (0 != memcmp(&pExpected->pPrereleaseData[idx], &pActual->pPrereleaseData[idx], sizeof(ParsedTagRecord))) return false;
+	}
+
+	for (size_t idx = 0; idx < pExpected->metaFieldCount; idx++)
+	{
+		if (0 != memcmp(&pExpected->pMetaData[idx], &pActual->pMetaData[idx], sizeof(ParsedTagRecord))) return false;
+	}
+
+	return true;
+}
+
+// Every entry expands back into what the classifier said about ppVersions,
+// and every pair compares the way CompareVersions() does.
+static size_t CheckSetVersions(const VersionSet *pSet, const char * const *ppVersions)
+{
+	size_t failCount = 0;
+
+	for (size_t idx = 0; idx < pSet->count; idx++)
+	{
+		VersionParseRecord expected;
+		VersionParseRecord actual;
+		const char *pVersion = GetVersionSetVersion(pSet, idx, &actual);
+
+		ClassifyVersionCandidate(GetVersionSetString(pSet, idx), &expected);
+
+		if ((NULL == pVersion) || (0 != strcmp(ppVersions[idx], pVersion)) || !SetRecordMatches(&expected, &actual))
+		{
+			failCount++;
+			printf("GetVersionSetVersion() didn't match the classifier for: \"%s\"\n", ppVersions[idx]);
+		}
+
+		FreeVersionParseData(&expected);
+		FreeVersionParseData(&actual);
+	}
+
+	for (size_t idx1 = 0; idx1 < pSet->count; idx1++)
+	{
+		VersionParseRecord record1;
+
+		ClassifyVersionCandidate(ppVersions[idx1], &record1);
+
+		for (size_t idx2 = 0; idx2 < pSet->count; idx2++)
+		{
+			VersionParseRecord record2;
+
+			ClassifyVersionCandidate(ppVersions[idx2], &record2);
+
+			int expected = CompareVersions(ppVersions[idx1], &record1, ppVersions[idx2], &record2);
+			int actual = CompareVersionSetVersions(pSet, idx1, idx2);
+
+			if (expected != actual)
+			{
+				failCount++;
+				printf("CompareVersionSetVersions(\"%s\", \"%s\") returned %d, expected %d.\n", ppVersions[idx1], ppVersions[idx2], actual, expected);
+			}
+
+			FreeVersionParseData(&record2);
+		}
+
+		FreeVersionParseData(&record1);
+	}
+
+	if (0 == failCount) printf("VersionSet entries matched the classifier and CompareVersions().\n");
+
+	return failCount;
+}
+
+// SemVer strings too wide for an entry keep their parse results in a detail
+// record, and still expand and compare like the rest.
+static size_t CheckSetDetails(void)
+{
+	static char wideVersions[5][SET_WIDE_SIZE];
+	const char *ppVersions[6];
+	VersionSet set;
+	size_t failCount = 0;
+
+	InitVersionSet(&set);
+
+	// A wide major, then wide prerelease tags that only differ at the end.
+	memset(wideVersions[0], '9', SET_WIDE_COUNT);
+	strcpy(wideVersions[0] + SET_WIDE_COUNT, ".0.0-rc.1+build.7");
+
+	for (size_t idx = 1; idx < 5; idx++)
+	{
+		char *pVersion = wideVersions[idx];
+
+		strcpy(pVersion, "1.0.0-");
+
+		for (size_t field = 0; field < SET_WIDE_COUNT; field++)
+		{
+			strcat(pVersion, (0 == field % 2) ? "a." : "0.");
+		}
+	}
+
+	strcat(wideVersions[1], "1");
+	strcat(wideVersions[2], "2+meta.data");
+	strcat(wideVersions[3], "b");
+	strcat(wideVersions[4], "1.x");
+
+	for (size_t idx = 0; idx < 5; idx++)
+	{
+		ppVersions[idx] = wideVersions[idx];
+	}
+
+	ppVersions[5] = "1.0.0-a";
+
+	if (!AddVersions(&set, ppVersions, NULL, 6) || (5 != set.detailCount))
+	{
+		printf("VersionSet didn't keep details for wide versions.\n");
+		failCount++;
+	}
+	else
+	{
+		failCount += CheckSetVersions(&set, ppVersions);
+	}
+
+	FreeVersionSet(&set);
+
+	return failCount;
+}
+
+// SortVersionSet() puts SET_TEST_COUNT shuffled versions in the same order
+// as SortVersions().
+static size_t CheckSetSort(void)
+{
+	SortableVersion *pVersions = malloc(SET_TEST_COUNT * sizeof(SortableVersion));
+	VersionSet set;
+	size_t failCount = 0;
+	uint32_t seed = 4321;
+
+	InitVersionSet(&set);
+
+	if (NULL == pVersions)
+	{
+		printf("VersionSet sort tests are out of memory.\n");
+		return 1;
+	}
+
+	for (size_t idx = 0; idx < SET_TEST_COUNT; idx++)
+	{
+		pVersions[idx].pVersion = _setVersions[NextTestRandom(&seed) % SET_VERSION_COUNT];
+		ClassifyVersionCandidate(pVersions[idx].pVersion, &pVersions[idx].record);
+
+		if (!AddVersion(&set, pVersions[idx].pVersion, strlen(pVersions[idx].pVersion))) failCount++;
+	}
+
+	if ((0 != failCount) || !SortVersionSet(&set) || !SortVersions(pVersions, SET_TEST_COUNT, 1))
+	{
+		printf("VersionSet sort tests failed to add or sort.\n");
+		failCount++;
+	}
+
+	for (size_t idx = 0; (0 == failCount) && (idx < SET_TEST_COUNT); idx++)
+	{
+		if (0 != strcmp(pVersions[idx].pVersion, GetVersionSetString(&set, idx)))
+		{
+			failCount++;
+			printf("SortVersionSet() put \"%s\" at %zu, SortVersions() put \"%s\" there.\n", GetVersionSetString(&set, idx), idx, pVersions[idx].pVersion);
+		}
+		// Strings are stored in the order they were added, so equal neighbors
+		// must have increasing offsets.
+		else if ((0 != idx) && (0 == strcmp(GetVersionSetString(&set, idx - 1), GetVersionSetString(&set, idx)))
+			&& (set.pEntries[idx].stringOffset < set.pEntries[idx - 1].stringOffset))
+		{
+			failCount++;
+			printf("SortVersionSet() isn't stable at %zu.\n", idx);
+		}
+	}
+
+	if (0 == failCount) printf("SortVersionSet() matched SortVersions() on %d versions.\n", SET_TEST_COUNT);
+
+	for (size_t idx = 0; idx < SET_TEST_COUNT; idx++)
+	{
+		FreeVersionParseData(&pVersions[idx].record);
+	}
+
+	free(pVersions);
+	FreeVersionSet(&set);
+
+	return failCount;
+}
+
+size_t RunSetTests(void)
+{
+	VersionSet set;
+	size_t failCount = 0;
+
+	InitVersionSet(&set);
+
+	// Half in bulk, half one at a time.
+	size_t half = SET_VERSION_COUNT / 2;
+
+	if (!AddVersions(&set, _setVersions, NULL, half)) failCount++;
+
+	for (size_t idx = half; idx < SET_VERSION_COUNT; idx++)
+	{
+		if (!AddVersion(&set, _setVersions[idx], strlen(_setVersions[idx]))) failCount++;
+	}
+
+	if ((0 != failCount) || (SET_VERSION_COUNT != set.count))
+	{
+		printf("VersionSet didn't add every version.\n");
+		failCount++;
+	}
+	else
+	{
+		failCount += CheckSetVersions(&set, _setVersions);
+	}
+
+	// Too long to keep.  Nothing changes, even in bulk.
+	char *pLong = malloc(VERSION_SET_MAX_LENGTH + 2);
+
+	if (NULL != pLong)
+	{
+		memset(pLong, '1', VERSION_SET_MAX_LENGTH + 1);
+		pLong[VERSION_SET_MAX_LENGTH + 1] = '\0';
+
+		const char *pBulk[] = { "1.2.3", pLong };
+		size_t stringBytes = set.stringBytes;
+
+		if (AddVersion(&set, pLong, VERSION_SET_MAX_LENGTH + 1) || AddVersions(&set, pBulk, NULL, 2)
+			|| (SET_VERSION_COUNT != set.count) || (stringBytes != set.stringBytes))
+		{
+			printf("VersionSet took a string longer than VERSION_SET_MAX_LENGTH.\n");
+			failCount++;
+		}
+
+		free(pLong);
+	}
+
+	FreeVersionSet(&set);
+
+	failCount += CheckSetDetails();
+	failCount += CheckSetSort();
+
+	return failCount;
+}
@@ -0,0 +1,221 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerSort.h"
+#include "SemVerLibUT.h"
+
+#define SORT_TEST_COUNT 20000
+#define SORT_TEST_LENGTH 32
+
+static const char *_sortTags[] = { "", "-alpha", "-alpha.1", "-beta", "-rc.1", "-0.3.7", "+build", "-x.7.z.92", "junk" };
+
+// Fields too big for a precedence key, so only CompareVersions() can order them.
+static const char *_sortBigVersions[] =
+{
+	"1048576.2.0", "1048576.1.0", "1048575.9.9", "1048577.0.0", "99999999.0.0-rc", "99999999.0.0",
+	"2.1048576.0", "2.1048575.0", "2.99999999.1", "2.99999999.0", "2.2.1048576", "2.2.1048575-a",
+};
+
+#define BIG_VERSION_COUNT (sizeof(_sortBigVersions) / sizeof(_sortBigVersions[0]))
+
+// Fills pBuffer with a deterministic mix of versions, with plenty of 
+// duplicates, so that stability shows up in the results.
+static void MakeVersions(char (*pBuffer)[SORT_TEST_LENGTH], SortableVersion *pVersions, size_t count)
+{
+	uint32_t seed = 12345;
+
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		if (idx < BIG_VERSION_COUNT)
+		{
+			snprintf(pBuffer[idx], SORT_TEST_LENGTH, "%s", _sortBigVersions[idx]);
+		}
+		else
+		{
+			MakeTestVersion(&seed, 8, _sortTags, sizeof(_sortTags) / sizeof(_sortTags[0]), pBuffer[idx], SORT_TEST_LENGTH);
+		}
+
+		pVersions[idx].pVersion = pBuffer[idx];
+		ClassifyVersionCandidate(pBuffer[idx], &pVersions[idx].record);
+	}
+}
+
+static void FreeVersions(SortableVersion *pVersions, size_t count)
+{
+	for (size_t idx = 0; idx < count; idx++)
+	{
+		FreeVersionParseData(&pVersions[idx].record);
+	}
+}
+
+// pSorted is pVersions, sorted.
+static size_t RunSelectTests(char (*pBuffer)[SORT_TEST_LENGTH], const SortableVersion *pSorted)
+{
+	static const size_t nths[] = { 0, 1, 17, SORT_TEST_COUNT / 2, SORT_TEST_COUNT - 2, SORT_TEST_COUNT - 1 };
+	static const size_t ks[] = { 1, 10, 100 };
+
+	size_t failCount = 0;
+	SortableVersion *pVersions = malloc(SORT_TEST_COUNT * sizeof(SortableVersion));
+	const SortableVersion *pTop[100];
+
+	if (NULL == pVersions)
+	{
+		printf("Selection tests are out of memory.\n");
+		return 1;
+	}
+
+	MakeVersions(pBuffer, pVersions, SORT_TEST_COUNT);
+
+	// The greatest SemVer versions are just before the non-SemVer ones.
+	size_t semVerCount = SORT_TEST_COUNT;
+
+	while ((0 != semVerCount) && (eSemVer_2_0_0 != pSorted[semVerCount - 1].record.versionType)) semVerCount--;
+
+	for (size_t test = 0; test < sizeof(ks) / sizeof(ks[0]); test++)
+	{
+		size_t found = 0;
+		bool passed = TopVersions(pVersions, SORT_TEST_COUNT, ks[test], pTop, &found) && (ks[test] == found);
+
+		for (size_t idx = 0; passed && (idx < found); idx++)
+		{
+			passed = (0 == CompareSortableVersions(pTop[idx], &pSorted[semVerCount - 1 - idx]));
+		}
+
+		if (passed)
+		{
+			printf("TopVersions() found the top %zu, %s first.\n", ks[test], pTop[0]->pVersion);
+		}
+		else
+		{
+			failCount++;
+			printf("TopVersions() failed to find the top %zu.\n", ks[test]);
+		}
+	}
+
+	for (size_t test = 0; test < sizeof(nths) / sizeof(nths[0]); test++)
+	{
+		size_t nth = nths[test];
+		bool passed = NthVersion(pVersions, SORT_TEST_COUNT, nth) && (0 == CompareSortableVersions(&pVersions[nth], &pSorted[nth]));
+
+		for (size_t idx = 0; passed && (idx < SORT_TEST_COUNT); idx++)
+		{
+			int result = CompareSortableVersions(&pVersions[idx], &pVersions[nth]);
+			passed = (idx < nth) ? (result <= 0) : (result >= 0);
+		}
+
+		if (passed)
+		{
+			printf("NthVersion(%zu) found %s\n", nth, pVersions[nth].pVersion);
+		}
+		else
+		{
+			failCount++;
+			printf("NthVersion(%zu) failed.\n", nth);
+		}
+	}
+
+	FreeVersions(pVersions, SORT_TEST_COUNT);
+	free(pVersions);
+
+	return failCount;
+}
+
+size_t RunSortTests(void)
+{
+	static const size_t threadCounts[] = { 1, 2, 3, 7, 32 };
+
+	size_t failCount = 0;
+	char (*pBuffer)[SORT_TEST_LENGTH] = malloc(SORT_TEST_COUNT * SORT_TEST_LENGTH);
+	SortableVersion *pExpected = malloc(SORT_TEST_COUNT * sizeof(SortableVersion));
+	SortableVersion *pActual = malloc(SORT_TEST_COUNT * sizeof(SortableVersion));
+
+	if ((NULL == pBuffer) || (NULL == pExpected) || (NULL == pActual))
+	{
+		printf("SortVersions() tests are out of memory.\n");
+		free(pBuffer);
+		free(pExpected);
+		free(pActual);
+		return 1;
+	}
+
+	MakeVersions(pBuffer, pExpected, SORT_TEST_COUNT);
+
+	if (!SortVersions(pExpected, SORT_TEST_COUNT, 1))
+	{
+		failCount++;
+		printf("SortVersions() failed on one thread.\n");
+	}
+
+	// Sorted, and equal versions are still in their original order.  Each 
+	// version has its own buffer, so that's the order of their addresses.
+	for (size_t idx = 1; idx < SORT_TEST_COUNT; idx++)
+	{
+		int result = CompareSortableVersions(&pExpected[idx - 1], &pExpected[idx]);
+
+		if ((result > 0) || ((0 == result) && (pExpected[idx - 1].pVersion > pExpected[idx].pVersion)))
+		{
+			failCount++;
+			printf("SortVersions() misplaced %s before %s\n", pExpected[idx - 1].pVersion, pExpected[idx].pVersion);
+			break;
+		}
+	}
+
+	// Keys may tie, but never disagree with the sort.
+	for (size_t idx = 1; idx < SORT_TEST_COUNT; idx++)
+	{
+		if (GetPrecedenceKey(pExpected[idx - 1].pVersion, &pExpected[idx - 1].record) > GetPrecedenceKey(pExpected[idx].pVersion, &pExpected[idx].record))
+		{
+			failCount++;
+			printf("GetPrecedenceKey() put %s after %s\n", pExpected[idx - 1].pVersion, pExpected[idx].pVersion);
+			break;
+		}
+	}
+
+	for (size_t test = 0; test < sizeof(threadCounts) / sizeof(threadCounts[0]); test++)
+	{
+		SortableVersion *pVersions = pActual;
+
+		for (size_t idx = 0; idx < SORT_TEST_COUNT; idx++)
+		{
+			pVersions[idx].pVersion = pBuffer[idx];
+			ClassifyVersionCandidate(pBuffer[idx], &pVersions[idx].record);
+		}
+
+		bool sorted = SortVersions(pVersions, SORT_TEST_COUNT, threadCounts[test]);
+		size_t idx = 0;
+
+		while (sorted && (idx < SORT_TEST_COUNT) && (pVersions[idx].pVersion == pExpected[idx].pVersion)) idx++;
+
+		if (SORT_TEST_COUNT == idx)
+		{
+			printf("SortVersions() on %zu threads matched one thread.\n", threadCounts[test]);
+		}
+		else
+		{
+			failCount++;
+			printf("SortVersions() on %zu threads differs from one thread at %zu.\n", threadCounts[test], idx);
+		}
+
+		FreeVersions(pVersions, SORT_TEST_COUNT);
+	}
+
+	failCount += RunSelectTests(pBuffer, pExpected);
+
+	FreeVersions(pExpected, SORT_TEST_COUNT);
+	free(pBuffer);
+	free(pExpected);
+	free(pActual);
+
+	return failCount;
+}
@@ -0,0 +1,96 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "..\SemVerLib\SemVerStats.h"
+#include "SemVerLibUT.h"
+
+static size_t Check(const char *pName, uint64_t actual, uint64_t expected)
+{
+	if (actual == expected) return 0;
+
+	printf("SemVerStats %s is %llu, expected %llu\n", pName, (unsigned long long)actual, (unsigned long long)expected);
+	return 1;
+}
+
+static void Classify(const char *pCandidate, VersionParseRecord *pParsed)
+{
+	ClassifyVersionCandidate(pCandidate, pParsed);
+}
+
+size_t RunStatsTests(void)
+{
+	size_t failCount = 0;
+	VersionParseRecord records[6];
+
+	ResetSemVerStats();
+
+	Classify("1.2.3", &records[0]);
+	Classify("1.2.3-alpha.1", &records[1]);
+	Classify("1.2.3-1.2.3.4.5.6+meta", &records[2]);
+	Classify("01.2.3", &records[3]);
+	Classify("1.2.3-00", &records[4]);
+	Classify("", &records[5]);
+
+	CompareVersions("1.2.3", &records[0], "1.2.3-alpha.1", &records[1]);
+	CompareVersions("1.2.3-alpha.1", &records[1], "1.2.3-1.2.3.4.5.6+meta", &records[2]);
+	CompareVersions("1.2.3", &records[0], "01.2.3", &records[3]);
+
+	SemVerStats stats;
+
+	if (GetSemVerStats(&stats))
+	{
+		failCount += Check("classifications", stats.classifications, 6);
+		failCount += Check("completedInState[eInPatch]", stats.completedInState[eInPatch], 1);
+		failCount += Check("completedInState[eInPreNumericField]", stats.completedInState[eInPreNumericField], 2);
+		failCount += Check("completedInState[eInMetaField]", stats.completedInState[eInMetaField], 1);
+		failCount += Check("rejectedInState[eStart]", stats.rejectedInState[eStart], 1);
+		failCount += Check("rejectedInState[eInMajor]", stats.rejectedInState[eInMajor], 1);
+		failCount += Check("leadingZeroRejections", stats.leadingZeroRejections, 1);
+		failCount += Check("needsAlphaToPass", stats.needsAlphaToPass, 1);
+		failCount += Check("needsAlphaRejections", stats.needsAlphaRejections, 1);
+		failCount += Check("tagAllocations", stats.tagAllocations, 4);
+		failCount += Check("tagReallocations", stats.tagReallocations, 1);
+		failCount += Check("compares", stats.compares, 3);
+		failCount += Check("compareDecisions[eDecidedNotSemVer]", stats.compareDecisions[eDecidedNotSemVer], 1);
+		failCount += Check("compareDecisions[eDecidedAtPrereleasePresence]", stats.compareDecisions[eDecidedAtPrereleasePresence], 1);
+		failCount += Check("compareDecisions[eDecidedAtPrereleaseFields]", stats.compareDecisions[eDecidedAtPrereleaseFields], 1);
+	}
+	else
+	{
+		// Built without SEMVER_STATS, so there had better not be anything to see.
+		failCount += Check("classifications", stats.classifications, 0);
+		failCount += Check("compares", stats.compares, 0);
+	}
+
+	ResetSemVerStats();
+	GetSemVerStats(&stats);
+	failCount += Check("classifications after reset", stats.classifications, 0);
+
+	SemVerStats total;
+	memset(&total, 0, sizeof(total));
+	stats.classifications = 2;
+	stats.compareFieldLengths[SEMVER_STATS_FIELD_LENGTH_COUNT - 1] = 3;
+	AddSemVerStats(&total, &stats);
+	AddSemVerStats(&total, &stats);
+	failCount += Check("total classifications", total.classifications, 4);
+	failCount += Check("total compareFieldLengths", total.compareFieldLengths[SEMVER_STATS_FIELD_LENGTH_COUNT - 1], 6);
+
+	for (size_t idx = 0; idx < sizeof(records) / sizeof(records[0]); idx++)
+	{
+		FreeVersionParseData(&records[idx]);
+	}
+
+	if (0 == failCount) printf("SemVerStats counted as expected.\n");
+
+	return failCount;
+}
@@ -0,0 +1,118 @@
+// Copyright (c) Joseph W Donahue dba SharperHacks.com
+// http://www.sharperhacks.com
+//
+// Licensed under the terms of the MIT license (https://opensource.org/licenses/MIT). See LICENSE.TXT.
+//
+//  Contact: coders@sharperhacks.com
+// ---------------------------------------------------------------------------
+
+// The only C++ in the tests, because SemVerView.hpp is the only C++ in the
+// library.  Builds with C++20.
+
+#include <cstdio>
+#include <ranges>
+#include <string_view>
+#include <utility>
+
+#include "..\SemVerLib\SemVerView.hpp"
+
+extern "C"
+{
+#include "SemVerLibUT.h"
+}
+
+using namespace SharperHacks::SemVer;
+
+// The std::views adaptors only take views, and filter needs an input range.
+static_assert(std::ranges::view<VersionLineView>);
+static_assert(std::ranges::input_range<VersionLineView>);
+
+static constexpr std::string_view _viewText =
+	"1.2.3\r\n  v1.2.4\n\t2.0.0-rc.1+b \n\nnot a version\n1.2\n0.9.0\n1.5.0-beta.2\n3.0.0\n4.5.6\n";
+
+static const std::string_view _viewExpected[] = { "1.2.3", "2.0.0-rc.1+b", "0.9.0", "1.5.0-beta.2", "3.0.0", "4.5.6" };
+
+// The first two releases.  0.9.0 isn't one, because 0.y.z versions are for
+// initial development.
+static const std::string_view _viewTakeExpected[] = { "1.2.3", "3.0.0" };
+
+// The releases in [1.0.0, 2.0.0).
+static const std::string_view _viewFilteredExpected[] = { "1.2.3" };
+
+static bool IsRelease(const ParsedVersion &version)
+{
+	return !version.pRecord->isPrereleaseVersion;
+}
+
+// Everything the range yields has to be expected, in order, with the record
+// for its own text.
+template <typename Range>
+static size_t CheckView(const char *pTestName, Range &&versions, const std::string_view *pExpected, size_t expectedCount)
+{
+	size_t count = 0;
+	size_t failCount = 0;
+
+	for (ParsedVersion version : versions)
+	{
+		bool passed = (count < expectedCount)
+			&& (pExpected[count] == version.text)
+			&& (eSemVer_2_0_0 == version.pRecord->versionType)
+			&& (version.text.size() == version.pRecord->parsedIdx);
+
+		if (!passed)
+		{
+			failCount++;
+			printf("%s yielded unexpected version: %.*s\n", pTestName, (int)version.text.size(), version.text.data());
+		}
+
+		count++;
+	}
+
+	if (count != expectedCount)
+	{
+		printf("%s yielded %zu versions, expected %zu.\n", pTestName, count, expectedCount);
+		return failCount + 1;
+	}
+
+	if (0 == failCount) printf("%s yielded every version.\n", pTestName);
+
+	return failCount;
+}
+
+size_t RunViewTests(void)
+{
+	size_t failCount = CheckView("text | VersionLines", _viewText | VersionLines, _viewExpected, 6);
+
+	failCount += CheckView("text | VersionLines | filter | take", _viewText | VersionLines | std::views::filter(IsRelease) | std::views::take(2), _viewTakeExpected, 2);
+	failCount += CheckView("empty | VersionLines", std::string_view() | VersionLines, nullptr, 0);
+
+	VersionRangeSet filter;
+
+	InitVersionRangeSet(&filter);
+
+	if (AddVersionInterval(&filter, "1.0.0", true, "2.0.0", false))
+	{
+		failCount += CheckView("VersionLines(text, filter) | filter", VersionLines(_viewText, &filter) | std::views::filter(IsRelease), _viewFilteredExpected, 1);
+	}
+	else
+	{
+		failCount++;
+		printf("AddVersionInterval() failed.\n");
+	}
+
+	FreeVersionRangeSet(&filter);
+
+	// A view that's been started moves with its place, and leaves nothing
+	// behind.
+	VersionLineView view = VersionLines(_viewText);
+	auto it = view.begin();
+
+	++it;
+
+	VersionLineView moved = std::move(view);
+
+	failCount += CheckView("VersionLineView moved", moved, _viewExpected + 1, 5);
+	failCount += CheckView("VersionLineView moved from", view, nullptr, 0);
+
+	return failCount;
+}